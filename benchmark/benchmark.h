@@ -1,37 +1,37 @@
 #pragma once
 
+#include "clock.h"
 #include <algorithm>
-#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <numeric>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 // ---------------------------------------------------------------------------
 // BenchmarkTimer
 //
-// High-resolution wall-clock timer. Starts automatically on construction.
-// Call stop() when the timed region ends, then query elapsed_*() helpers.
+// Nanosecond wall-clock timer on the engine's clock (EngineClock, chosen
+// with LOB_CLOCK), so the harness and the engine's timestamps agree; with
+// the default TscClock a timing costs one rdtsc. A manual engine clock only
+// moves when told to, so under LOB_CLOCK=manual the timer reads SteadyClock
+// instead. Starts automatically on construction. Call stop() when the timed
+// region ends, then query elapsed_*() helpers.
 // ---------------------------------------------------------------------------
 class BenchmarkTimer {
 public:
-    BenchmarkTimer() { start(); }
+    using Clock = std::conditional_t<std::is_same_v<EngineClock, ManualClock>,
+                                     SteadyClock, EngineClock>;
 
-    void start() {
-        start_ = std::chrono::high_resolution_clock::now();
-    }
+    BenchmarkTimer() { start(); }
 
-    void stop() {
-        end_ = std::chrono::high_resolution_clock::now();
-    }
+    void start() { start_ = Clock::now(); }
+    void stop()  { end_   = Clock::now(); }
 
     // Nanoseconds between start() and stop().
-    double elapsed_ns() const {
-        return static_cast<double>(
-            std::chrono::duration_cast<std::chrono::nanoseconds>(end_ - start_).count());
-    }
+    double elapsed_ns() const { return static_cast<double>(end_ - start_); }
 
     // Microseconds between start() and stop().
     double elapsed_us() const { return elapsed_ns() / 1'000.0; }
@@ -40,8 +40,8 @@ public:
     double elapsed_ms() const { return elapsed_ns() / 1'000'000.0; }
 
 private:
-    std::chrono::high_resolution_clock::time_point start_;
-    std::chrono::high_resolution_clock::time_point end_;
+    int64_t start_{0};
+    int64_t end_{0};
 };
 
 // ---------------------------------------------------------------------------
@@ -109,6 +109,11 @@ public:
         std::cout << std::endl;
     }
 
+    // Derived statistics in ns; valid after compute().
+    double p50_ns() const { return p50_ns_; }
+    double p99_ns() const { return p99_ns_; }
+    double max_ns() const { return max_ns_; }
+
 private:
     // Returns the p-th percentile (0–100) using nearest-rank interpolation.
     // Assumes latencies_ is already sorted.
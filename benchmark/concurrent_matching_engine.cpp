@@ -1,117 +1,170 @@
 #include "concurrent_matching_engine.h"
 #include "benchmark.h"
 
+#include <chrono>
 #include <iostream>
 #include <random>
 #include <thread>
 #include <vector>
 #include <atomic>
 
+#include <time.h>
+
 // ---------------------------------------------------------------------------
-// ConcurrentMatchingEngine implementation
+// BasicConcurrentMatchingEngine implementation
 // ---------------------------------------------------------------------------
 
-ConcurrentMatchingEngine::ConcurrentMatchingEngine(bool verbose)
-    : engine_(verbose)
+template <typename WaitStrategy>
+BasicConcurrentMatchingEngine<WaitStrategy>::BasicConcurrentMatchingEngine(
+    bool verbose, size_t latency_samples, const ThreadPlacement& placement)
+    : verbose_(verbose), latency_samples_(latency_samples), placement_(placement)
 {
-    consumer_ = std::thread(&ConcurrentMatchingEngine::consumerLoop, this);
+    consumer_ = std::thread(&BasicConcurrentMatchingEngine::consumerLoop, this);
+    while (!ready_.load(std::memory_order_acquire)) std::this_thread::yield();
 }
 
-ConcurrentMatchingEngine::~ConcurrentMatchingEngine() {
+template <typename WaitStrategy>
+BasicConcurrentMatchingEngine<WaitStrategy>::~BasicConcurrentMatchingEngine() {
     if (running_.load(std::memory_order_relaxed)) stop();
 }
 
-void ConcurrentMatchingEngine::submitLimit(Side side, int64_t price, uint64_t qty) {
-    OrderEvent ev;
-    ev.kind     = EventKind::SUBMIT_LIMIT;
-    ev.order_id = 0;   // assigned by engine on dispatch
-    ev.side     = (side == Side::BUY) ? 'B' : 'S';
-    ev.price    = price;
-    ev.quantity = qty;
-    queue_.enqueue(ev);
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::publish(const OrderEvent& ev) {
+    queue_->enqueue(ev);
+    wait_.notify();
 }
 
-void ConcurrentMatchingEngine::submitMarket(Side side, uint64_t qty) {
-    OrderEvent ev;
-    ev.kind     = EventKind::SUBMIT_MARKET;
-    ev.order_id = 0;
-    ev.side     = (side == Side::BUY) ? 'B' : 'S';
-    ev.price    = 0;
-    ev.quantity = qty;
-    queue_.enqueue(ev);
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::submitLimit(Side side, int64_t price,
+                                                              uint64_t qty) {
+    publish(OrderEvent(EventKind::SUBMIT_LIMIT, 0,   // id assigned by engine on dispatch
+                       (side == Side::BUY) ? 'B' : 'S', price, qty));
 }
 
-void ConcurrentMatchingEngine::cancelOrder(uint64_t engine_order_id) {
-    OrderEvent ev;
-    ev.kind     = EventKind::CANCEL;
-    ev.order_id = engine_order_id;
-    ev.side     = 'X';
-    ev.price    = 0;
-    ev.quantity = 0;
-    queue_.enqueue(ev);
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::submitMarket(Side side, uint64_t qty) {
+    publish(OrderEvent(EventKind::SUBMIT_MARKET, 0, (side == Side::BUY) ? 'B' : 'S', 0, qty));
 }
 
-void ConcurrentMatchingEngine::stop() {
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::cancelOrder(uint64_t engine_order_id) {
+    publish(OrderEvent(EventKind::CANCEL, engine_order_id, 'X', 0, 0));
+}
+
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::stop() {
     // Push sentinel to signal consumer to exit
     OrderEvent sentinel;
     sentinel.kind = static_cast<EventKind>(SENTINEL);
-    queue_.enqueue(sentinel);
+    publish(sentinel);
 
     if (consumer_.joinable()) consumer_.join();
     running_.store(false, std::memory_order_relaxed);
 }
 
-void ConcurrentMatchingEngine::consumerLoop() {
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::consumerLoop() {
+    pinned_ = pinCurrentThread(placement_.matching_core);
+    core_   = currentCore();
+    node_   = currentNumaNode();
+    if (pinned_ && placement_.numa_local) preferNumaNode(node_);
+
+    queue_  = std::make_unique<MpscRing<OrderEvent>>(QUEUE_CAPACITY);
+    engine_ = std::make_unique<Engine>(verbose_);
+    latencies_.reserve(latency_samples_);
+    ready_.store(true, std::memory_order_release);
+
     OrderEvent ev;
     while (true) {
-        if (!queue_.dequeue(ev)) {
-            // Spin — yield to avoid burning a full core
-            std::this_thread::yield();
+        if (!queue_->dequeue(ev)) {
+            wait_.idle([this] { return !queue_->empty(); });
             continue;
         }
+        wait_.busy();
 
         if (static_cast<uint8_t>(ev.kind) == SENTINEL) break;
 
         switch (ev.kind) {
         case EventKind::SUBMIT_LIMIT:
-            engine_.submitLimit(
+            engine_->submitLimit(
                 (ev.side == 'B') ? Side::BUY : Side::SELL,
                 ev.price, ev.quantity);
             break;
         case EventKind::SUBMIT_MARKET:
-            engine_.submitMarket(
+            engine_->submitMarket(
                 (ev.side == 'B') ? Side::BUY : Side::SELL,
                 ev.quantity);
             break;
         case EventKind::CANCEL:
-            engine_.cancelOrder(ev.order_id);
+            engine_->cancelOrder(ev.order_id);
             break;
         default:
             break;
         }
 
+        if (latencies_.size() < latencies_.capacity())
+            latencies_.push_back(EngineClock::now() - ev.timestamp_ns);
         events_processed_.fetch_add(1, std::memory_order_relaxed);
     }
+
+    timespec cpu{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    consumer_cpu_ns_ = static_cast<int64_t>(cpu.tv_sec) * 1'000'000'000 + cpu.tv_nsec;
 }
 
-void ConcurrentMatchingEngine::printStats() const {
-    std::cout << "\n=== Concurrent Engine Stats ===\n"
-              << "  Events processed : " << eventsProcessed() << "\n";
-    engine_.printStats();
+template <typename WaitStrategy>
+void BasicConcurrentMatchingEngine<WaitStrategy>::printStats() const {
+    WaitStats w = waitStats();
+    std::cout << "\n=== Concurrent Engine Stats (" << WaitStrategy::NAME << ") ===\n"
+              << "  Events processed : " << eventsProcessed() << "\n"
+              << "  Idle spins       : " << w.idle_spins << "\n"
+              << "  Yields / sleeps  : " << w.yields << " / " << w.sleeps << "\n"
+              << "  Parks / wakeups  : " << w.parks << " / " << w.wakeups << "\n"
+              << "  Consumer         : core " << core_ << ", node " << node_
+              << (pinned_ ? " (pinned)" : " (unpinned)") << "\n";
+    engine_->printStats();
 }
 
+template class BasicConcurrentMatchingEngine<BusySpinWait>;
+template class BasicConcurrentMatchingEngine<SpinYieldWait>;
+template class BasicConcurrentMatchingEngine<SpinParkWait>;
+template class BasicConcurrentMatchingEngine<BackoffWait>;
+
 // ---------------------------------------------------------------------------
 // Multi-producer benchmark
 //
 // N producer threads each enqueue orders_per_producer events; one consumer
-// thread dispatches them. We measure end-to-end wall-clock throughput.
+// thread dispatches them, and a publisher thread samples top() every 10 us
+// as a market-data feed would. We measure end-to-end wall-clock throughput
+// and enqueue-to-matched latency. With pin set, every thread runs on the
+// core ThreadPlacement::pinned() gives it and the consumer allocates on its
+// own NUMA node; without, the scheduler places them.
 // ---------------------------------------------------------------------------
-void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer) {
+void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer, bool pin) {
     std::cout << "\n=== Concurrent Benchmark ("
               << num_producers << " producers x "
-              << orders_per_producer << " orders) ===\n";
-
-    ConcurrentMatchingEngine cme(false);
+              << orders_per_producer << " orders, "
+              << (pin ? "pinned" : "unpinned") << ") ===\n";
+
+    uint64_t        total_events = static_cast<uint64_t>(num_producers) * orders_per_producer;
+    ThreadPlacement placement;
+    if (pin) placement = ThreadPlacement::pinned(static_cast<size_t>(num_producers));
+    ConcurrentMatchingEngine cme(false, total_events, placement);
+
+    std::atomic<bool> publishing{true};
+    uint64_t          tops_seen = 0;
+    std::thread publisher([&] {
+        pinCurrentThread(placement.publisher_core);
+        uint64_t last = 0;
+        while (publishing.load(std::memory_order_relaxed)) {
+            BookTop t = cme.top();
+            if (t.sequence != last) {
+                last = t.sequence;
+                ++tops_seen;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+    });
 
     std::vector<std::thread> producers;
     producers.reserve(static_cast<size_t>(num_producers));
@@ -119,7 +172,8 @@ void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer) {
     BenchmarkTimer total;
 
     for (int p = 0; p < num_producers; ++p) {
-        producers.emplace_back([&cme, orders_per_producer, p]() {
+        producers.emplace_back([&cme, &placement, orders_per_producer, p]() {
+            pinCurrentThread(placement.producerCore(static_cast<size_t>(p)));
             std::mt19937_64 rng{static_cast<uint64_t>(p * 0x9e3779b97f4a7c15ULL)};
             std::normal_distribution<double> price_dist(1000000.0, 10000.0);
             std::uniform_int_distribution<uint64_t> qty_dist(1, 200);
@@ -145,12 +199,20 @@ void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer) {
     cme.stop();
 
     total.stop();
+    publishing.store(false, std::memory_order_relaxed);
+    publisher.join();
 
-    uint64_t total_events = static_cast<uint64_t>(num_producers) * orders_per_producer;
     double throughput = static_cast<double>(total_events) * 1e9 / total.elapsed_ns();
 
+    PerformanceStats stats;
+    for (int64_t ns : cme.latencies()) stats.add_latency(static_cast<double>(ns));
+    stats.compute();
+
     std::cout << "Total events  : " << total_events << "\n"
               << "Throughput    : " << static_cast<uint64_t>(throughput) << " events/sec\n"
-              << "Wall time     : " << total.elapsed_ms() << " ms\n";
+              << "Wall time     : " << total.elapsed_ms() << " ms\n"
+              << "Latency       : p50 " << stats.p50_ns() / 1000.0 << " us, p99 "
+              << stats.p99_ns() / 1000.0 << " us, max " << stats.max_ns() / 1000.0 << " us\n"
+              << "Tops published: " << tops_seen << " seen by publisher\n";
     cme.printStats();
 }
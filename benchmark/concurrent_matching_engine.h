@@ -1,22 +1,38 @@
 #pragma once
 
-#include "concurrent_queue.h"
 #include "order_event.h"
 #include "matching_engine.h"
+#include "ring_queue.h"
+#include "thread_placement.h"
+#include "wait_strategy.h"
 
 #include <atomic>
+#include <memory>
 #include <thread>
+#include <vector>
 
 // ---------------------------------------------------------------------------
-// ConcurrentMatchingEngine
+// BasicConcurrentMatchingEngine<WaitStrategy>
 //
-// Wraps the single-threaded MatchingEngine behind a lock-free event queue.
-// Multiple producer threads enqueue OrderEvents; a single dedicated consumer
-// thread dequeues and dispatches them to the underlying engine.
+// Wraps a MatchingEngine behind a bounded lock-free MpscRing. Multiple
+// producer threads enqueue OrderEvents; a single dedicated consumer thread
+// dequeues and dispatches them to the underlying engine, which is therefore
+// built with SingleWriterPolicy and takes no locks at all.
 //
 // This decouples order submission from order processing: producers never
-// block on matching logic. The queue absorbs burst traffic, and the consumer
-// drains it at engine speed.
+// block on matching logic. The ring absorbs burst traffic up to its capacity
+// (producers spin once it is full), and the consumer drains it at engine
+// speed. What the consumer does when the ring is empty is the WaitStrategy
+// (see wait_strategy.h); ConcurrentMatchingEngine spins, then yields.
+//
+// Submits are stamped with EngineClock on entry. With latency_samples > 0
+// the consumer records enqueue-to-matched latency for that many events.
+//
+// The consumer is the matching thread of a ThreadPlacement: it pins itself
+// to matching_core and then builds the ring, the book and the latency
+// buffer, so all of them are first touched on its core and NUMA node. The
+// constructor returns once they exist. Producers and any publisher reading
+// top() are the caller's threads to place.
 //
 // Lifecycle:
 //   1. Construct.
@@ -24,35 +40,72 @@
 //   3. Call stop() — drains the queue, joins the consumer thread.
 //   4. Query stats or printStats().
 // ---------------------------------------------------------------------------
-class ConcurrentMatchingEngine {
+template <typename WaitStrategy>
+class BasicConcurrentMatchingEngine {
 public:
-    explicit ConcurrentMatchingEngine(bool verbose = false);
-    ~ConcurrentMatchingEngine();
+    explicit BasicConcurrentMatchingEngine(bool verbose = false, size_t latency_samples = 0,
+                                           const ThreadPlacement& placement = {});
+    ~BasicConcurrentMatchingEngine();
 
-    ConcurrentMatchingEngine(const ConcurrentMatchingEngine&)            = delete;
-    ConcurrentMatchingEngine& operator=(const ConcurrentMatchingEngine&) = delete;
+    BasicConcurrentMatchingEngine(const BasicConcurrentMatchingEngine&)            = delete;
+    BasicConcurrentMatchingEngine& operator=(const BasicConcurrentMatchingEngine&) = delete;
 
     // Producer API — thread-safe, non-blocking (only enqueue).
     void submitLimit(Side side, int64_t price, uint64_t qty);
     void submitMarket(Side side, uint64_t qty);
     void cancelOrder(uint64_t engine_order_id);
 
+    // Top of book as last published by the consumer; any thread, any time.
+    BookTop top() const { return engine_->book().top(); }
+
     // Enqueue a sentinel and wait for the consumer to drain and exit.
     void stop();
 
     // Counters — readable from any thread after stop().
-    uint64_t eventsProcessed() const { return events_processed_.load(std::memory_order_relaxed); }
+    uint64_t  eventsProcessed() const { return events_processed_.load(std::memory_order_relaxed); }
+    WaitStats waitStats()       const { return wait_.stats(); }
+    int64_t   consumerCpuNs()   const { return consumer_cpu_ns_; }
+
+    // Where the consumer started: pinned as asked, and its core and NUMA
+    // node (-1 if unknown). Valid from construction.
+    bool consumerPinned() const { return pinned_; }
+    int  consumerCore()   const { return core_; }
+    int  consumerNode()   const { return node_; }
+
+    // Enqueue-to-matched latency in ns, in processing order (after stop()).
+    const std::vector<int64_t>& latencies() const { return latencies_; }
 
     void printStats() const;
 
 private:
-    static constexpr uint8_t SENTINEL = 255;   // EventKind value used as stop signal
+    static constexpr uint8_t SENTINEL       = 255;   // EventKind value used as stop signal
+    static constexpr size_t  QUEUE_CAPACITY = size_t{1} << 16;
+
+    using Engine = BasicMatchingEngine<SingleWriterPolicy>;
 
-    MatchingEngine              engine_;
-    ConcurrentQueue<OrderEvent> queue_;
-    std::thread                 consumer_;
-    std::atomic<bool>           running_{true};
-    std::atomic<uint64_t>       events_processed_{0};
+    const bool                            verbose_;
+    const size_t                          latency_samples_;
+    const ThreadPlacement                 placement_;
+    std::unique_ptr<Engine>               engine_;   // built by the consumer
+    std::unique_ptr<MpscRing<OrderEvent>> queue_;    // built by the consumer
+    WaitStrategy                          wait_;
+    std::thread                           consumer_;
+    std::atomic<bool>                     ready_{false};
+    std::atomic<bool>                     running_{true};
+    std::atomic<uint64_t>                 events_processed_{0};
+    std::vector<int64_t>                  latencies_;
+    int64_t                               consumer_cpu_ns_{0};
+    bool                                  pinned_{false};
+    int                                   core_{-1};
+    int                                   node_{-1};
 
+    void publish(const OrderEvent& ev);
     void consumerLoop();
 };
+
+extern template class BasicConcurrentMatchingEngine<BusySpinWait>;
+extern template class BasicConcurrentMatchingEngine<SpinYieldWait>;
+extern template class BasicConcurrentMatchingEngine<SpinParkWait>;
+extern template class BasicConcurrentMatchingEngine<BackoffWait>;
+
+using ConcurrentMatchingEngine = BasicConcurrentMatchingEngine<SpinYieldWait>;
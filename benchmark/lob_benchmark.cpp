@@ -1,14 +1,67 @@
 #include "benchmark.h"
 #include "matching_engine.h"
+#include "memory_pool.h"
 #include "order_event.h"
 #include "concurrent_matching_engine.h"
+#include "concurrent_queue.h"
+#include "journal.h"
+#include "multi_symbol_engine.h"
+#include "order_index.h"
+#include "ring_queue.h"
+#include "perf_counters.h"
+#include "trade_tape.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
 #include <deque>
+#include <filesystem>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include <sys/resource.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------
+// Allocation counting
+//
+// Replaces the global operator new/delete for the whole benchmark binary so
+// the allocation benchmark can read exact counts. The counters are relaxed
+// atomics; the cost is one uncontended increment per allocation.
+// ---------------------------------------------------------------------------
+static std::atomic<uint64_t> g_allocs{0};
+static std::atomic<uint64_t> g_frees{0};
+
+void* operator new(std::size_t size) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// GCC flags the free() once this is inlined into a delete-expression,
+// not knowing operator new above is the matching malloc().
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept {
+    if (!p) return;
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+#pragma GCC diagnostic pop
+
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+
 // ---------------------------------------------------------------------------
 // Workload generator
 //
@@ -97,6 +150,70 @@ static std::vector<OrderEvent> buildWorkload(uint64_t n, uint64_t seed = 42) {
     return events;
 }
 
+// ---------------------------------------------------------------------------
+// Replays one workload event against the engine. engine_ids maps workload
+// order ids to engine-assigned ids so that cancels hit the right order.
+// ---------------------------------------------------------------------------
+static void dispatch(MatchingEngine& engine, const OrderEvent& ev,
+                     std::vector<uint64_t>& engine_ids) {
+    switch (ev.kind) {
+    case EventKind::SUBMIT_LIMIT:
+    {
+        Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
+        uint64_t eid = engine.submitLimit(side, ev.price, ev.quantity);
+        if (ev.order_id < engine_ids.size()) engine_ids[ev.order_id] = eid;
+        break;
+    }
+    case EventKind::SUBMIT_MARKET:
+    {
+        Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
+        engine.submitMarket(side, ev.quantity);
+        break;
+    }
+    case EventKind::CANCEL:
+    {
+        uint64_t eid = (ev.order_id < engine_ids.size())
+                       ? engine_ids[ev.order_id] : 0;
+        if (eid > 0) engine.cancelOrder(eid);
+        break;
+    }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Replays a workload through the engine's sink entry points. With
+// iceberg_every > 0, every iceberg_every-th limit order is submitted as an
+// iceberg showing its workload quantity out of four times that in total.
+// Templated on the engine so every lock policy replays the same way.
+// ---------------------------------------------------------------------------
+template <typename Engine, typename Sink>
+static void replayOne(Engine& engine, const OrderEvent& ev,
+                      std::vector<uint64_t>& engine_ids, Sink& sink,
+                      uint64_t iceberg_every = 0) {
+    Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
+    switch (ev.kind) {
+    case EventKind::SUBMIT_LIMIT:
+        engine_ids[ev.order_id] =
+            (iceberg_every && ev.order_id % iceberg_every == 0)
+            ? engine.submitIceberg(side, ev.price, ev.quantity * 4, ev.quantity, sink)
+            : engine.submitLimit(side, ev.price, ev.quantity, sink);
+        break;
+    case EventKind::SUBMIT_MARKET:
+        engine.submitMarket(side, ev.quantity, sink);
+        break;
+    case EventKind::CANCEL:
+        if (uint64_t eid = engine_ids[ev.order_id]) engine.cancelOrder(eid);
+        break;
+    }
+}
+
+template <typename Engine, typename Sink>
+static void replay(Engine& engine, const std::vector<OrderEvent>& events,
+                   std::vector<uint64_t>& engine_ids, Sink& sink,
+                   uint64_t iceberg_every = 0) {
+    for (auto& ev : events) replayOne(engine, ev, engine_ids, sink, iceberg_every);
+}
+
 // ---------------------------------------------------------------------------
 // Single-threaded latency benchmark
 // ---------------------------------------------------------------------------
@@ -116,29 +233,7 @@ static void runLatencyBenchmark(uint64_t n) {
 
     for (auto& ev : events) {
         BenchmarkTimer t;
-
-        switch (ev.kind) {
-        case EventKind::SUBMIT_LIMIT:
-        {
-            Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
-            uint64_t eid = engine.submitLimit(side, ev.price, ev.quantity);
-            if (ev.order_id < engine_ids.size()) engine_ids[ev.order_id] = eid;
-            break;
-        }
-        case EventKind::SUBMIT_MARKET:
-        {
-            Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
-            engine.submitMarket(side, ev.quantity);
-            break;
-        }
-        case EventKind::CANCEL:
-        {
-            uint64_t eid = (ev.order_id < engine_ids.size())
-                           ? engine_ids[ev.order_id] : 0;
-            if (eid > 0) engine.cancelOrder(eid);
-            break;
-        }
-        }
+        dispatch(engine, ev, engine_ids);
 
         t.stop();
         stats.add_latency(t.elapsed_ns());
@@ -155,6 +250,60 @@ static void runLatencyBenchmark(uint64_t n) {
     std::cout << "Wall time  : " << total.elapsed_ms() << " ms\n";
 }
 
+// ---------------------------------------------------------------------------
+// Resting-book footprint and sweep latency
+//
+// Seeds `resting` plain limit orders, half per side, 500 per $0.01 level,
+// and reports resident-set growth per order. Then times market orders that
+// each sweep two full levels (1000 resting orders) and reports latency per
+// filled order. Runs first in main() so that RSS growth is not hidden by
+// memory other benchmarks have freed.
+// ---------------------------------------------------------------------------
+static size_t residentBytes() {
+    long pages = 0, resident = 0;
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        std::fclose(f);
+    }
+    return static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+static void runRestingBookBenchmark(uint64_t resting, uint64_t sweeps) {
+    std::cout << "\n=== Resting Book Benchmark (" << resting << " resting orders) ===\n";
+    std::cout << "sizeof(Order) : " << sizeof(Order) << " bytes\n";
+
+    constexpr uint64_t PER_LEVEL = 500;
+    constexpr uint64_t LOT       = 10;
+    NullSink sink;
+
+    size_t rss_before = residentBytes();
+    auto engine = std::make_unique<MatchingEngine>(false, LadderConfig{880000, 100, 2400});
+    for (uint64_t i = 0; i < resting / 2; ++i) {
+        int64_t offset = static_cast<int64_t>(i / PER_LEVEL) * 100;
+        engine->submitLimit(Side::BUY,  990000 - offset, LOT, sink);
+        engine->submitLimit(Side::SELL, 1010000 + offset, LOT, sink);
+    }
+    size_t rss_after = residentBytes();
+
+    std::cout << "RSS growth    : " << (rss_after - rss_before) / (1024 * 1024) << " MiB ("
+              << static_cast<double>(rss_after - rss_before) / static_cast<double>(resting)
+              << " bytes/order)\n";
+
+    PerformanceStats stats;
+    double total_ns = 0;
+    for (uint64_t i = 0; i < sweeps; ++i) {
+        BenchmarkTimer t;
+        engine->submitMarket(i % 2 ? Side::SELL : Side::BUY, 2 * PER_LEVEL * LOT, sink);
+        t.stop();
+        stats.add_latency(t.elapsed_ns());
+        total_ns += t.elapsed_ns();
+    }
+    stats.compute();
+    stats.print_summary("Two-level sweep (1000 fills)");
+    std::cout << "Per fill      : "
+              << total_ns / static_cast<double>(sweeps * 2 * PER_LEVEL) << " ns\n";
+}
+
 // ---------------------------------------------------------------------------
 // Throughput benchmark — maximise total events per second
 // ---------------------------------------------------------------------------
@@ -169,28 +318,7 @@ static void runThroughputBenchmark(uint64_t n) {
     BenchmarkTimer total;
 
     for (auto& ev : events) {
-        switch (ev.kind) {
-        case EventKind::SUBMIT_LIMIT:
-        {
-            Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
-            uint64_t eid = engine.submitLimit(side, ev.price, ev.quantity);
-            if (ev.order_id < engine_ids.size()) engine_ids[ev.order_id] = eid;
-            break;
-        }
-        case EventKind::SUBMIT_MARKET:
-        {
-            Side side = (ev.side == 'B') ? Side::BUY : Side::SELL;
-            engine.submitMarket(side, ev.quantity);
-            break;
-        }
-        case EventKind::CANCEL:
-        {
-            uint64_t eid = (ev.order_id < engine_ids.size())
-                           ? engine_ids[ev.order_id] : 0;
-            if (eid > 0) engine.cancelOrder(eid);
-            break;
-        }
-        }
+        dispatch(engine, ev, engine_ids);
     }
 
     total.stop();
@@ -198,59 +326,1342 @@ static void runThroughputBenchmark(uint64_t n) {
     double throughput = static_cast<double>(n) * 1e9 / total.elapsed_ns();
     std::cout << "Throughput : " << static_cast<uint64_t>(throughput)
               << " orders/sec\n";
+    std::cout << "Per order  : " << total.elapsed_ns() / static_cast<double>(n)
+              << " ns\n";
     std::cout << "Wall time  : " << total.elapsed_ms() << " ms\n";
     engine.printStats();
 }
 
 // ---------------------------------------------------------------------------
-// Modify benchmark — measures cancel+reinsert overhead
+// Modify benchmark — in-place quantity-down amends vs price relocations
+//
+// Seeds 200 levels per side with 20 orders each, then times two passes of
+// random modifies: shaving one lot off at the same price (amended in place,
+// priority kept) and moving the order one level out and back (the same pool
+// object is relinked at the tail of its new level).
 // ---------------------------------------------------------------------------
 static void runModifyBenchmark(uint64_t n) {
-    std::cout << "\n=== Modify Order Benchmark (" << n << " modifies) ===\n";
+    std::cout << "\n=== Modify Order Benchmark (" << n << " modifies per case) ===\n";
 
     MatchingEngine engine(false);
 
-    // Seed the book with resting orders on both sides
-    std::vector<uint64_t> bid_ids, ask_ids;
+    struct Resting { uint64_t id; int64_t price; uint64_t qty; };
+    std::vector<Resting> resting;
     for (int i = 0; i < 200; ++i) {
-        bid_ids.push_back(engine.submitLimit(Side::BUY,
-            static_cast<int64_t>(990000 - i * 1000), 100));
-        ask_ids.push_back(engine.submitLimit(Side::SELL,
-            static_cast<int64_t>(1010000 + i * 1000), 100));
+        int64_t bid = 990000 - i * 1000;
+        int64_t ask = 1010000 + i * 1000;
+        for (int k = 0; k < 20; ++k) {
+            resting.push_back({engine.submitLimit(Side::BUY,  bid, 1'000'000), bid, 1'000'000});
+            resting.push_back({engine.submitLimit(Side::SELL, ask, 1'000'000), ask, 1'000'000});
+        }
     }
 
     std::mt19937_64 rng{99};
-    std::uniform_int_distribution<size_t> bid_pick(0, bid_ids.size() - 1);
-    std::uniform_int_distribution<size_t> ask_pick(0, ask_ids.size() - 1);
+    std::uniform_int_distribution<size_t> pick(0, resting.size() - 1);
+
+    auto run = [&](const char* label, auto&& amend) {
+        PerformanceStats stats;
+        for (uint64_t i = 0; i < n; ++i) {
+            Resting& r = resting[pick(rng)];
+            BenchmarkTimer t;
+            amend(r);
+            t.stop();
+            stats.add_latency(t.elapsed_ns());
+        }
+        stats.compute();
+        stats.print_summary(label);
+    };
+
+    run("Modify: qty down, same price", [&](Resting& r) {
+        engine.modifyOrder(r.id, r.price, --r.qty);
+    });
+    // Bids sit at multiples of $0.10 below $99.00 and asks above $101.00, so
+    // a $0.05 shift always lands between existing levels and back.
+    run("Modify: price change", [&](Resting& r) {
+        r.price += (r.price % 1000 == 0) ? 500 : -500;
+        engine.modifyOrder(r.id, r.price, r.qty);
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Cancel benchmark — deep, crowded levels near the touch
+//
+// Seeds five levels per side with `depth` orders each, then cancels random
+// resting orders and immediately replaces them at the same price so the
+// queues stay at full depth. Only the cancel is timed; with intrusive level
+// queues its cost should not depend on depth.
+// ---------------------------------------------------------------------------
+static void runCancelBenchmark(uint64_t n, size_t depth) {
+    std::cout << "\n=== Cancel Benchmark (" << n << " cancels, "
+              << depth << " orders/level) ===\n";
+
+    constexpr int LEVELS = 5;
+    MatchingEngine engine(false);
+
+    struct Slot { Side side; int64_t price; uint64_t id; };
+    std::vector<Slot> slots;
+    slots.reserve(2 * LEVELS * depth);
+    for (int l = 0; l < LEVELS; ++l) {
+        int64_t bid = 999000 - l * 100;
+        int64_t ask = 1001000 + l * 100;
+        for (size_t i = 0; i < depth; ++i) {
+            slots.push_back({Side::BUY,  bid, engine.submitLimit(Side::BUY,  bid, 10)});
+            slots.push_back({Side::SELL, ask, engine.submitLimit(Side::SELL, ask, 10)});
+        }
+    }
+
+    std::mt19937_64 rng{7};
+    std::uniform_int_distribution<size_t> pick(0, slots.size() - 1);
 
     PerformanceStats stats;
-    BenchmarkTimer   total;
+    for (uint64_t i = 0; i < n; ++i) {
+        Slot& s = slots[pick(rng)];
+
+        BenchmarkTimer t;
+        engine.cancelOrder(s.id);
+        t.stop();
+        stats.add_latency(t.elapsed_ns());
+
+        s.id = engine.submitLimit(s.side, s.price, 10);
+    }
+
+    stats.compute();
+    stats.print_summary("Cancel latency");
+}
 
+// ---------------------------------------------------------------------------
+// Stop-trigger benchmark — trades with many untriggered stops pending
+//
+// Parks `stops` sell stops well below the market, then times market buys
+// that each sweep several ask levels. Every fill checks stop triggers, so
+// this isolates the cost of that check as the pending population grows.
+// ---------------------------------------------------------------------------
+static void runStopTriggerBenchmark(uint64_t n, uint64_t stops) {
+    std::cout << "\n=== Stop Trigger Benchmark (" << n << " sweeps, "
+              << stops << " pending stops) ===\n";
+
+    MatchingEngine engine(false);
+    for (uint64_t i = 0; i < stops; ++i) {
+        int64_t trigger = 900000 - static_cast<int64_t>(i % 1000) * 100;
+        engine.submitStopLoss(Side::SELL, trigger, trigger - 1000, 10);
+    }
+
+    PerformanceStats stats;
     for (uint64_t i = 0; i < n; ++i) {
+        for (int l = 0; l < 10; ++l)
+            engine.submitLimit(Side::SELL, 1001000 + l * 100, 10);
+
         BenchmarkTimer t;
-        if (i % 2 == 0)
-            engine.modifyOrder(bid_ids[bid_pick(rng)], 985000LL, 50);
-        else
-            engine.modifyOrder(ask_ids[ask_pick(rng)], 1015000LL, 50);
+        engine.submitMarket(Side::BUY, 100);   // ten fills, ten trigger checks
         t.stop();
         stats.add_latency(t.elapsed_ns());
     }
 
+    stats.compute();
+    stats.print_summary("Ten-level sweep latency");
+}
+
+// ---------------------------------------------------------------------------
+// Level store benchmark — sparse std::map levels vs the dense tick ladder
+//
+// Replays the same workload through two engines. The ladder covers
+// $90.00–$110.00 in $0.01 ticks, i.e. ten sigma of the workload's price
+// distribution; anything outside lands in the sparse fallback.
+// ---------------------------------------------------------------------------
+static void runLadderBenchmark(uint64_t n) {
+    std::cout << "\n=== Level Store Benchmark (" << n << " events) ===\n";
+
+    auto events = buildWorkload(n, 271);
+
+    auto run = [&](const char* label, const LadderConfig& cfg) {
+        MatchingEngine engine(false, cfg);
+        std::vector<uint64_t> engine_ids(n + 1, 0);
+
+        PerformanceStats stats;
+        BenchmarkTimer   total;
+        for (auto& ev : events) {
+            BenchmarkTimer t;
+            dispatch(engine, ev, engine_ids);
+            t.stop();
+            stats.add_latency(t.elapsed_ns());
+        }
+        total.stop();
+
+        stats.compute();
+        stats.print_summary(label);
+        double throughput = static_cast<double>(n) * 1e9 / total.elapsed_ns();
+        std::cout << "Throughput : " << static_cast<uint64_t>(throughput)
+                  << " orders/sec\n";
+    };
+
+    run("std::map levels", LadderConfig{});
+    run("Dense tick ladder", LadderConfig{900000, 100, 2000});
+}
+
+// ---------------------------------------------------------------------------
+// Allocation benchmark — heap allocations per order on the sink entry point
+//
+// Warms an engine up on one workload (pool slabs, index pages, ladder
+// levels and the engine's internal vectors reach their working size), then
+// replays a second workload through the NullSink submit overloads and
+// counts every operator new in between. It runs once with a dense tick
+// ladder and once with every level in the sparse map, where each level
+// that empties and reappears used to free and reallocate its map node.
+// A third case flickers the inside: a bid one tick better than the best is
+// placed and cancelled over and over, so a level is created and emptied
+// on every order. The target is zero at steady state; what remains is
+// working-set growth (pool slabs, id-index pages), not per-order work.
+// ---------------------------------------------------------------------------
+static void allocationRun(const char* label, const LadderConfig& ladder, uint64_t n) {
+    auto warmup = buildWorkload(n, 7);
+    auto events = buildWorkload(n, 8);
+
+    MatchingEngine engine(false, ladder);
+    NullSink       sink;
+    std::vector<uint64_t> engine_ids(n + 1, 0);
+
+    replay(engine, warmup, engine_ids, sink);
+    std::fill(engine_ids.begin(), engine_ids.end(), 0);
+
+    const OrderBook& book = engine.book();
+    size_t   resting_before = book.activeOrders();
+    size_t   slots_before   = book.pool().totalCapacity();
+    uint64_t before         = g_allocs.load(std::memory_order_relaxed);
+    BenchmarkTimer total;
+    replay(engine, events, engine_ids, sink);
     total.stop();
+    uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - before;
+
+    std::cout << "  " << std::left << std::setw(12) << label << std::right
+              << std::setw(9) << allocs
+              << std::setw(10) << std::fixed << std::setprecision(4)
+              << static_cast<double>(allocs) / static_cast<double>(n)
+              << std::setw(9) << std::setprecision(1)
+              << total.elapsed_ns() / static_cast<double>(n)
+              << "    " << resting_before << " -> " << book.activeOrders() << " resting, pool "
+              << slots_before << " -> " << book.pool().totalCapacity() << "\n";
+}
+
+static void flickerRun(uint64_t n) {
+    MatchingEngine engine(false);
+    NullSink       sink;
+    for (int l = 0; l < 10; ++l) {
+        engine.submitLimit(Side::BUY, 990000 - l * 100, 100, sink);
+        engine.submitLimit(Side::SELL, 1010000 + l * 100, 100, sink);
+    }
+    auto flick = [&](uint64_t i) {
+        int64_t px = 990100 + static_cast<int64_t>(i % 4) * 100;
+        engine.cancelOrder(engine.submitLimit(Side::BUY, px, 10, sink));
+    };
+    for (uint64_t i = 0; i < 1000; ++i) flick(i);
+
+    uint64_t before = g_allocs.load(std::memory_order_relaxed);
+    BenchmarkTimer total;
+    for (uint64_t i = 0; i < n; ++i) flick(i);
+    total.stop();
+    uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - before;
+
+    std::cout << "  " << std::left << std::setw(12) << "flicker" << std::right
+              << std::setw(9) << allocs
+              << std::setw(10) << std::fixed << std::setprecision(4)
+              << static_cast<double>(allocs) / static_cast<double>(n)
+              << std::setw(9) << std::setprecision(1)
+              << total.elapsed_ns() / static_cast<double>(n)
+              << "    new inside level per order, sparse map\n";
+}
+
+static void runAllocationBenchmark(uint64_t n) {
+    std::cout << "\n=== Allocation Benchmark (" << n << " events) ===\n"
+              << "  ladder        allocs  per order  ns/order\n";
+    allocationRun("dense band", LadderConfig{900000, 100, 2000}, n);
+    allocationRun("sparse map", LadderConfig{}, n);
+    flickerRun(n);
+}
+
+// ---------------------------------------------------------------------------
+// Cold-start benchmark — page faults and TLB misses by pool backing
+//
+// Builds a fresh engine and rests `resting` orders on it (as the resting
+// book benchmark does), then cancels a random tenth of them. The pool is
+// either the default (heap slabs of 1024 orders, grown as the book fills)
+// or presized to the whole book from the engine constructor and prefaulted,
+// on 4k pages or on huge pages. Page faults come from getrusage and cover
+// construction and the fill; dTLB load misses come from perf and cover the
+// fill and the cancels, whose scattered pool accesses are where huge pages
+// save TLB entries.
+// ---------------------------------------------------------------------------
+static uint64_t pageFaults() {
+    rusage ru{};
+    getrusage(RUSAGE_SELF, &ru);
+    return static_cast<uint64_t>(ru.ru_minflt + ru.ru_majflt);
+}
+
+static void coldStartRun(const char* label, const PoolConfig& pool, uint64_t resting) {
+    constexpr uint64_t PER_LEVEL = 500;
+    NullSink           sink;
+    DtlbMissCounter    tlb;
+
+    uint64_t       faults0 = pageFaults();
+    BenchmarkTimer build;
+    auto engine = std::make_unique<MatchingEngine>(false, LadderConfig{880000, 100, 2400},
+                                                   TapeConfig{}, pool);
+    build.stop();
+    uint64_t faults1 = pageFaults();
+
+    std::vector<uint64_t> ids;
+    ids.reserve(resting);
+    uint64_t faults2 = pageFaults();
+    tlb.start();
+    BenchmarkTimer fill;
+    for (uint64_t i = 0; i < resting / 2; ++i) {
+        int64_t offset = static_cast<int64_t>(i / PER_LEVEL) * 100;
+        ids.push_back(engine->submitLimit(Side::BUY, 990000 - offset, 10, sink));
+        ids.push_back(engine->submitLimit(Side::SELL, 1010000 + offset, 10, sink));
+    }
+    fill.stop();
+    tlb.stop();
+    uint64_t faults3    = pageFaults();
+    uint64_t fill_tlb   = tlb.misses();
+
+    std::mt19937_64 rng{22};
+    std::shuffle(ids.begin(), ids.end(), rng);
+    uint64_t cancels = ids.size() / 10;
+    tlb.start();
+    BenchmarkTimer cancel;
+    for (uint64_t i = 0; i < cancels; ++i) engine->cancelOrder(ids[i]);
+    cancel.stop();
+    tlb.stop();
+
+    auto perOrder = [](double v, uint64_t n) { return v / static_cast<double>(n ? n : 1); };
+    std::cout << "  " << std::left << std::setw(24) << label << std::setw(10)
+              << pageBackingName(engine->book().pool().backing()) << std::right
+              << std::fixed << std::setprecision(1)
+              << std::setw(9) << build.elapsed_ms()
+              << std::setw(10) << (faults1 - faults0)
+              << std::setw(10) << (faults3 - faults2)
+              << std::setw(9) << perOrder(fill.elapsed_ns(), ids.size())
+              << std::setw(9) << perOrder(cancel.elapsed_ns(), cancels);
+    if (tlb.available())
+        std::cout << std::setw(11) << std::setprecision(3)
+                  << perOrder(static_cast<double>(fill_tlb), ids.size())
+                  << std::setw(11) << perOrder(static_cast<double>(tlb.misses()), cancels);
+    else
+        std::cout << "        n/a        n/a";
+    std::cout << "\n";
+}
+
+static void runColdStartBenchmark(uint64_t resting) {
+    std::cout << "\n=== Cold Start Benchmark (" << resting << " resting orders) ===\n";
+    DtlbMissCounter probe;
+    if (!probe.available())
+        std::cout << "  (dTLB counter unavailable: " << probe.error() << ")\n";
+    std::cout << "  pool                    backing    ctor ms ctor flt  fill flt  fill ns"
+              << "  cncl ns  fill tlb/o cncl tlb/o\n";
+
+    coldStartRun("heap, 1024-order slabs", PoolConfig{}, resting);
+
+    PoolConfig sized;
+    sized.initial_capacity = resting;
+    sized.prefault         = true;
+    coldStartRun("presized, prefaulted", sized, resting);
+
+    sized.huge_pages = true;
+    coldStartRun("presized, huge pages", sized, resting);
+}
+
+// ---------------------------------------------------------------------------
+// Pool benchmark — alloc/free throughput by thread count
+//
+// Each thread repeatedly allocates a burst of 32 orders and frees them, on
+// its own ("local") or with every burst freed by the next thread round the
+// ring ("cross", the producer/consumer pattern). MemoryPool is compared with
+// a mutex-guarded free list, the pool's previous design. Cross-thread bursts
+// go through a per-pair mailbox handed over with one atomic pointer.
+// ---------------------------------------------------------------------------
+class LockedPool {
+public:
+    explicit LockedPool(size_t slab) : slab_(slab) { grow(); }
+    ~LockedPool() {
+        for (auto* s : slabs_) ::operator delete(s);
+    }
+
+    Order* allocate(uint64_t id) {
+        void* p;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_) grow();
+            p     = free_;
+            free_ = free_->next;
+        }
+        return ::new (p) Order(id, 0, Side::BUY, OrderKind::LIMIT, 1000000, 1);
+    }
+    void deallocate(Order* o) {
+        o->~Order();
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto* n = reinterpret_cast<Node*>(o);
+        n->next = free_;
+        free_   = n;
+    }
+
+private:
+    struct Node { Node* next; };
+    void grow() {
+        auto* slab = static_cast<unsigned char*>(::operator new(slab_ * sizeof(Order)));
+        slabs_.push_back(slab);
+        for (size_t i = 0; i < slab_; ++i) {
+            auto* n = reinterpret_cast<Node*>(slab + i * sizeof(Order));
+            n->next = free_;
+            free_   = n;
+        }
+    }
+
+    size_t                      slab_;
+    Node*                       free_{nullptr};
+    std::vector<unsigned char*> slabs_;
+    std::mutex                  mutex_;
+};
+
+struct MagazinePool {
+    explicit MagazinePool(size_t slab) : pool(slab) {}
+    MemoryPool<Order> pool;
+    Order* allocate(uint64_t id) {
+        return pool.allocate(id, 0LL, Side::BUY, OrderKind::LIMIT, 1000000LL, 1ULL);
+    }
+    void deallocate(Order* o) { pool.deallocate(o); }
+};
+
+template <typename Pool>
+static double poolOpsPerSec(int threads, bool cross, uint64_t bursts) {
+    constexpr size_t BURST = 32;
+    struct alignas(64) Mailbox { std::atomic<Order**> full{nullptr}; };
+
+    Pool                     pool(1024);
+    std::vector<Mailbox>     mail(static_cast<size_t>(threads));
+    std::atomic<bool>        go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            Order*   bufs[2][BURST];
+            Order*   incoming[BURST];
+            Mailbox& out = mail[static_cast<size_t>((t + 1) % threads)];
+            Mailbox& in  = mail[static_cast<size_t>(t)];
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t b = 0; b < bursts; ++b) {
+                Order** buf = bufs[b & 1];
+                for (size_t i = 0; i < BURST; ++i) buf[i] = pool.allocate(b * BURST + i);
+                if (!cross || threads == 1) {
+                    for (size_t i = 0; i < BURST; ++i) pool.deallocate(buf[i]);
+                    continue;
+                }
+                // Hand this burst to the next thread, free whatever the
+                // previous thread handed us.
+                while (out.full.load(std::memory_order_acquire)) std::this_thread::yield();
+                out.full.store(buf, std::memory_order_release);
+                Order** got;
+                while (!(got = in.full.load(std::memory_order_acquire))) std::this_thread::yield();
+                std::copy(got, got + BURST, incoming);
+                in.full.store(nullptr, std::memory_order_release);
+                for (size_t i = 0; i < BURST; ++i) pool.deallocate(incoming[i]);
+            }
+            // The last burst lives on this stack until the next thread copies it.
+            while (out.full.load(std::memory_order_acquire)) std::this_thread::yield();
+        });
+    }
+
+    BenchmarkTimer timer;
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+    timer.stop();
+
+    double ops = 2.0 * static_cast<double>(BURST) * static_cast<double>(bursts) * threads;
+    return ops * 1e9 / timer.elapsed_ns();
+}
+
+static void runPoolBenchmark(uint64_t ops_per_thread) {
+    uint64_t bursts = std::max<uint64_t>(1, ops_per_thread / 64);
+    std::cout << "\n=== Pool Benchmark (" << bursts * 64 << " alloc+free per thread) ===\n"
+              << "  threads  pattern   mutex ops/sec  magazine ops/sec  speedup\n";
+    for (int threads : {1, 2, 4, 8}) {
+        for (bool cross : {false, true}) {
+            if (cross && threads == 1) continue;
+            double locked   = poolOpsPerSec<LockedPool>(threads, cross, bursts);
+            double magazine = poolOpsPerSec<MagazinePool>(threads, cross, bursts);
+            std::cout << "  " << std::setw(7) << threads << "  " << std::left << std::setw(6)
+                      << (cross ? "cross" : "local") << std::right
+                      << std::setw(17) << static_cast<uint64_t>(locked)
+                      << std::setw(18) << static_cast<uint64_t>(magazine)
+                      << std::setw(8) << std::fixed << std::setprecision(1)
+                      << magazine / locked << "x\n";
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Matching kernel benchmark — per-order cost of the plain and iceberg paths
+//
+// Replays one workload twice through the NullSink entry points: as plain
+// limit/market orders, so every level takes the kernel's iceberg-free loop,
+// and with every tenth limit order an iceberg, so levels it rests on take
+// the generic display-lot loop. Reports time, instructions and branch
+// misses per order where the hardware counters are readable.
+// ---------------------------------------------------------------------------
+static void runKernelBenchmark(uint64_t n) {
+    std::cout << "\n=== Matching Kernel Benchmark (" << n << " events) ===\n";
+
+    auto events = buildWorkload(n, 313);
+
+    auto run = [&](const char* label, uint64_t iceberg_every) {
+        MatchingEngine engine(false, LadderConfig{900000, 100, 2000});
+        std::vector<uint64_t> engine_ids(n + 1, 0);
+        NullSink sink;
+
+        PerfCounters   pc;
+        BenchmarkTimer t;
+        pc.start();
+        replay(engine, events, engine_ids, sink, iceberg_every);
+        pc.stop();
+        t.stop();
+
+        double per = static_cast<double>(n);
+        std::cout << label << "\n"
+                  << "  Per order    : " << t.elapsed_ns() / per << " ns\n";
+        if (pc.available()) {
+            std::cout << "  Instructions : " << static_cast<double>(pc.instructions()) / per << " /order\n"
+                      << "  Branches     : " << static_cast<double>(pc.branches()) / per << " /order\n"
+                      << "  Branch miss  : " << static_cast<double>(pc.branchMisses()) / per << " /order\n";
+        } else {
+            std::cout << "  Counters     : unavailable (" << pc.error() << ")\n";
+        }
+    };
+
+    run("Plain limit/market flow", 0);
+    run("Every 10th limit an iceberg", 10);
+}
+
+// ---------------------------------------------------------------------------
+// Batch submission benchmark — per-event cost against batch size
+//
+// Replays one workload through the single-order NullSink entry points, then
+// through submitBatch in chunks of increasing size. Workload ids count
+// submits from 1, as a fresh engine does, so cancels pass through as is.
+// Batching saves a lock round trip and a clock read per event and lets the
+// prefetch pass run ahead of matching.
+// ---------------------------------------------------------------------------
+static void runBatchBenchmark(uint64_t n) {
+    std::cout << "\n=== Batch Submission Benchmark (" << n << " events) ===\n";
+
+    auto events = buildWorkload(n, 515);
+    double single_ns = 0;
+    {
+        MatchingEngine engine(false, LadderConfig{900000, 100, 2000});
+        std::vector<uint64_t> engine_ids(n + 1, 0);
+        NullSink sink;
+        BenchmarkTimer t;
+        replay(engine, events, engine_ids, sink);
+        t.stop();
+        single_ns = t.elapsed_ns() / static_cast<double>(n);
+    }
+    std::cout << "Single submits : " << single_ns << " ns/event\n";
+
+    for (size_t batch : {1, 4, 16, 64, 256}) {
+        MatchingEngine engine(false, LadderConfig{900000, 100, 2000});
+        NullSink sink;
+        const OrderEvent* first = events.data();
+        const OrderEvent* last  = first + events.size();
+
+        BenchmarkTimer t;
+        for (const OrderEvent* it = first; it != last; ) {
+            const OrderEvent* end = it + std::min<size_t>(batch, static_cast<size_t>(last - it));
+            engine.submitBatch(it, end, sink);
+            it = end;
+        }
+        t.stop();
+
+        double per = t.elapsed_ns() / static_cast<double>(n);
+        std::cout << "Batch " << std::setw(4) << batch << "     : " << per
+                  << " ns/event  (" << single_ns / per << "x)\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Top-of-book reader contention benchmark
+//
+// One writer replays a workload while 0–8 threads poll the book as fast as
+// they can, either through the seqlock-published top() or through
+// activeOrders(), which still takes the shared book lock. Reports the
+// writer's per-event cost and the readers' combined poll rate. On machines
+// with fewer cores than threads the readers also compete for CPU time.
+// ---------------------------------------------------------------------------
+static void runTopOfBookBenchmark(uint64_t n) {
+    std::cout << "\n=== Top-of-Book Reader Benchmark (" << n << " events, "
+              << std::thread::hardware_concurrency() << " hw threads) ===\n";
+
+    auto events = buildWorkload(n, 717);
+
+    auto run = [&](const char* label, int readers, auto&& poll) {
+        MatchingEngine engine(false, LadderConfig{900000, 100, 2000});
+        std::vector<uint64_t> engine_ids(n + 1, 0);
+        NullSink sink;
+        std::atomic<bool>     done{false};
+        std::atomic<uint64_t> polls{0};
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                uint64_t local = 0, acc = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    acc += poll(engine.book());
+                    ++local;
+                }
+                asm volatile("" : : "r"(acc));
+                polls.fetch_add(local, std::memory_order_relaxed);
+            });
+        }
+
+        BenchmarkTimer t;
+        replay(engine, events, engine_ids, sink);
+        t.stop();
+        done.store(true);
+        for (auto& th : threads) th.join();
+
+        std::cout << "  " << std::left << std::setw(10) << label << std::right
+                  << std::setw(2) << readers << " readers : writer "
+                  << std::setw(8) << t.elapsed_ns() / static_cast<double>(n) << " ns/event";
+        if (readers)
+            std::cout << ", " << static_cast<double>(polls.load()) / t.elapsed_ms() / 1000.0
+                      << " M polls/s";
+        std::cout << "\n";
+    };
+
+    for (int readers : {0, 1, 2, 4, 8})
+        run("seqlock", readers, [](const OrderBook& b) {
+            return static_cast<uint64_t>(b.top().bid_price);
+        });
+    for (int readers : {1, 2, 4, 8})
+        run("mutex", readers, [](const OrderBook& b) {
+            return static_cast<uint64_t>(b.activeOrders());
+        });
+}
+
+// ---------------------------------------------------------------------------
+// Lock policy benchmark — per-event latency under each policy
+//
+// Single writer: one thread replays the workload through an engine built
+// with each policy and times every event, so the difference is the cost of
+// taking and releasing an uncontended lock (and of the atomic id counter).
+// Contended: four threads each replay a quarter of the workload into one
+// shared engine under the two policies that allow it.
+// ---------------------------------------------------------------------------
+template <typename LockPolicy>
+static void policyLatency(const char* label, const std::vector<OrderEvent>& events) {
+    BasicMatchingEngine<LockPolicy> engine(false, LadderConfig{900000, 100, 2000});
+    std::vector<uint64_t> engine_ids(events.size() + 1, 0);
+    NullSink         sink;
+    PerformanceStats stats;
+    for (auto& ev : events) {
+        BenchmarkTimer t;
+        replayOne(engine, ev, engine_ids, sink);
+        t.stop();
+        stats.add_latency(t.elapsed_ns());
+    }
+    stats.compute();
+    stats.print_summary(label);
+}
+
+template <typename LockPolicy>
+static void policyContended(const char* label, const std::vector<OrderEvent>& events,
+                            int threads) {
+    BasicMatchingEngine<LockPolicy> engine(false, LadderConfig{900000, 100, 2000});
+    size_t per = events.size() / static_cast<size_t>(threads);
+
+    BenchmarkTimer total;
+    std::vector<std::thread> workers;
+    for (int w = 0; w < threads; ++w) {
+        workers.emplace_back([&, w] {
+            // Cancels name workload ids from the whole stream; each thread
+            // only resolves the ones it submitted itself.
+            std::vector<uint64_t> engine_ids(events.size() + 1, 0);
+            NullSink sink;
+            auto first = events.begin() + static_cast<std::ptrdiff_t>(per * static_cast<size_t>(w));
+            for (auto it = first; it != first + static_cast<std::ptrdiff_t>(per); ++it)
+                replayOne(engine, *it, engine_ids, sink);
+        });
+    }
+    for (auto& th : workers) th.join();
+    total.stop();
+
+    std::cout << "  " << std::left << std::setw(14) << label << std::right
+              << threads << " threads : "
+              << total.elapsed_ns() / static_cast<double>(per * static_cast<size_t>(threads))
+              << " ns/event\n";
+}
+
+static void runLockPolicyBenchmark(uint64_t n) {
+    std::cout << "\n=== Lock Policy Benchmark (" << n << " events) ===\n";
+    auto events = buildWorkload(n, 919);
+
+    policyLatency<SingleWriterPolicy>("SingleWriterPolicy (no lock)", events);
+    policyLatency<TicketLockPolicy>("TicketLockPolicy", events);
+    policyLatency<SharedMutexPolicy>("SharedMutexPolicy", events);
+
+    std::cout << "\nContended (" << std::thread::hardware_concurrency() << " hw threads):\n";
+    policyContended<TicketLockPolicy>("ticket", events, 4);
+    policyContended<SharedMutexPolicy>("shared_mutex", events, 4);
+}
+
+// ---------------------------------------------------------------------------
+// Clock benchmark — cost of stamping one order with each clock source
+//
+// Each submit reads the engine clock once, so the cost of n back-to-back
+// reads divided by n is the per-order timestamping cost in isolation. The
+// reads are summed so the loop cannot be dropped.
+// ---------------------------------------------------------------------------
+template <typename Clock>
+static void timeClock(const char* label, uint64_t n) {
+    int64_t sink = 0;
+    BenchmarkTimer t;
+    for (uint64_t i = 0; i < n; ++i) sink += Clock::now();
+    t.stop();
+    asm volatile("" : : "r"(sink));
+    std::cout << "  " << std::left << std::setw(28) << label << std::right
+              << t.elapsed_ns() / static_cast<double>(n) << " ns/order\n";
+}
+
+struct HighResolutionClock {   // what OrderEvent used to read
+    static int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+};
+
+static void runClockBenchmark(uint64_t n) {
+    std::cout << "\n=== Clock Benchmark (" << n << " reads) ===\n";
+
+    const TscClock::Calibration& cal = TscClock::calibration();
+    std::cout << "TSC         : "
+              << (cal.invariant ? "invariant, " : "not invariant (reads steady_clock), ")
+              << (cal.invariant ? static_cast<double>(cal.mult) / 4294967296.0 : 0.0)
+              << " ns/tick\n";
+
+    CoarseClock::now();   // start the refresher outside the timed loop
+    timeClock<HighResolutionClock>("high_resolution_clock (us)", n);
+    timeClock<SteadyClock>("SteadyClock", n);
+    timeClock<TscClock>("TscClock", n);
+    timeClock<CoarseClock>("CoarseClock", n);
+    timeClock<ManualClock>("ManualClock", n);
+    timeClock<EngineClock>("EngineClock (this build)", n);
+}
+
+// ---------------------------------------------------------------------------
+// Trade history benchmark — unbounded std::vector vs TradeTape
+//
+// Times every append so reallocation copies show up in the tail. The tape is
+// run ring-only and with spill to a scratch directory, where each eviction
+// is a 40-byte store into a mapped segment plus a file rotation per segment.
+// ---------------------------------------------------------------------------
+static void runTradeTapeBenchmark(uint64_t n) {
+    std::cout << "\n=== Trade History Benchmark (" << n << " appends) ===\n";
+
+    auto make = [](uint64_t i) {
+        return Trade{i + 1, i * 2 + 1, i * 2 + 2, 1000000LL + static_cast<int64_t>(i % 100),
+                     1 + i % 200, static_cast<int64_t>(i)};
+    };
+    auto run = [&](const std::string& label, auto&& append) {
+        PerformanceStats stats;
+        for (uint64_t i = 0; i < n; ++i) {
+            Trade t = make(i);
+            BenchmarkTimer timer;
+            append(t);
+            timer.stop();
+            stats.add_latency(timer.elapsed_ns());
+        }
+        stats.compute();
+        stats.print_summary(label);
+    };
+
+    {
+        std::vector<Trade> trades;
+        run("std::vector<Trade>::push_back", [&](const Trade& t) { trades.push_back(t); });
+    }
+    {
+        TradeTape tape;
+        run("TradeTape append (ring only)", [&](const Trade& t) { tape.append(t); });
+    }
+    {
+        auto dir = std::filesystem::temp_directory_path() / "lob_tape_bench";
+        std::filesystem::create_directories(dir);
+        TapeConfig cfg;
+        cfg.spill_dir       = dir.string();
+        cfg.segment_records = size_t{1} << 18;
+        cfg.max_segments    = 4;
+        {
+            TradeTape tape(cfg);
+            run("TradeTape append (mmap spill)", [&](const Trade& t) { tape.append(t); });
+            std::cout << "Retained   : " << tape.size() << " trades in "
+                      << tape.segmentCount() << " segment(s) + ring\n";
+        }
+        std::filesystem::remove_all(dir);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Journal benchmark — cost of each durability level
+//
+// Replays one workload through an engine without a journal and then
+// through one journaling to a scratch directory at each durability level,
+// timing every event. Wall time runs until the last event is durable: it
+// includes the final sync(), so MAPPED pays for its writeback there and
+// GROUP_COMMIT for its last batch. Per-event msync is slow enough on real
+// storage that it replays at most 20 000 events.
+// ---------------------------------------------------------------------------
+static void runJournalBenchmark(uint64_t n) {
+    std::cout << "\n=== Journal Benchmark (" << n << " events) ===\n"
+              << "  durability           events  events/sec    p50 ns    p99 ns    max us"
+                 "   commits  ev/commit\n";
+
+    auto dir = std::filesystem::temp_directory_path() / "lob_journal_bench";
+    auto run = [&](const char* label, const JournalConfig* cfg, uint64_t count) {
+        std::filesystem::remove_all(dir);
+        std::filesystem::create_directories(dir);
+        auto events = buildWorkload(count, 8);
+        std::vector<uint64_t> engine_ids(count + 1, 0);
+        NullSink sink;
+
+        JournalConfig none;
+        MatchingEngine engine(false, LadderConfig{900000, 100, 2000}, {}, {},
+                              cfg ? *cfg : none);
+        PerformanceStats stats;
+        BenchmarkTimer   wall;
+        for (auto& ev : events) {
+            BenchmarkTimer t;
+            replayOne(engine, ev, engine_ids, sink);
+            t.stop();
+            stats.add_latency(t.elapsed_ns());
+        }
+        if (Journal* j = engine.journal()) j->sync();
+        wall.stop();
+        stats.compute();
+
+        Journal::Stats js = engine.journal() ? engine.journal()->stats() : Journal::Stats{};
+        std::cout << "  " << std::left << std::setw(18) << label << std::right
+                  << std::setw(9) << count
+                  << std::setw(12) << static_cast<uint64_t>(count * 1e9 / wall.elapsed_ns())
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(10) << stats.p50_ns()
+                  << std::setw(10) << stats.p99_ns()
+                  << std::setprecision(1) << std::setw(10) << stats.max_ns() / 1000.0
+                  << std::setw(10) << js.commits
+                  << std::setw(11) << (js.commits ? static_cast<double>(js.appended) / js.commits : 0.0)
+                  << "\n";
+    };
+
+    run("in-memory", nullptr, n);
+
+    JournalConfig cfg;
+    cfg.dir             = dir.string();
+    cfg.segment_records = size_t{1} << 18;
+
+    cfg.durability = Durability::MAPPED;
+    run("mapped", &cfg, n);
+
+    cfg.durability         = Durability::GROUP_COMMIT;
+    cfg.commit_events      = 1024;
+    cfg.commit_interval_us = 1000;
+    run("group 1024/1ms", &cfg, n);
+
+    cfg.commit_events      = 64;
+    cfg.commit_interval_us = 100;
+    run("group 64/100us", &cfg, n);
+
+    cfg.durability = Durability::PER_EVENT;
+    run("per event", &cfg, std::min<uint64_t>(n, 20'000));
+
+    std::filesystem::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot benchmark — restart time for a deep resting book
+//
+// Builds `resting` resting orders (every fourth an iceberg) through a
+// journaled engine, each bid/ask pair alongside one order placed and
+// cancelled, so the journal holds two events per resting order, as a
+// session with some churn would.
+// It then snapshots and journals `tail` more mixed events.
+// Times the snapshot write and three restarts into a fresh engine: the
+// snapshot alone, snapshot plus journal tail, and the whole journal replayed
+// from empty. Files are read back from a warm page cache. Each engine is
+// freed before the next is built, so only one book is in memory at a time.
+// ---------------------------------------------------------------------------
+static void runSnapshotBenchmark(uint64_t resting, uint64_t tail) {
+    std::cout << "\n=== Snapshot Benchmark (" << resting << " resting orders, "
+              << tail << " tail events) ===\n";
+
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "lob_snapshot_bench";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "journal");
+    std::string   path = (dir / "book.snap").string();
+    JournalConfig cfg;
+    cfg.dir             = (dir / "journal").string();
+    cfg.segment_records = size_t{1} << 20;
+    LadderConfig ladder{880000, 100, 2400};
+    NullSink     sink;
+
+    const uint64_t per_level = std::max<uint64_t>(resting / 2000, 1);
+    auto live = std::make_unique<MatchingEngine>(false, ladder, TapeConfig{}, PoolConfig{}, cfg);
+    for (uint64_t i = 0; i < resting / 2; ++i) {
+        int64_t offset = static_cast<int64_t>(i / per_level) * 100;
+        live->cancelOrder(live->submitLimit(i % 2 ? Side::BUY : Side::SELL,
+                                            i % 2 ? 890000 : 1110000, 10, sink));
+        if (i % 4 == 3) {
+            live->submitIceberg(Side::BUY,  990000 - offset, 40, 10, sink);
+            live->submitIceberg(Side::SELL, 1010000 + offset, 40, 10, sink);
+        } else {
+            live->submitLimit(Side::BUY,  990000 - offset, 10, sink);
+            live->submitLimit(Side::SELL, 1010000 + offset, 10, sink);
+        }
+    }
+
+    BenchmarkTimer write;
+    uint64_t covered = live->saveSnapshot(path);
+    write.stop();
+    double mib = static_cast<double>(fs::file_size(path)) / (1024.0 * 1024.0);
+
+    std::mt19937_64 rng(7);
+    for (uint64_t i = 0; i < tail; ++i) {
+        switch (i % 4) {
+        case 0:  live->submitMarket(i % 8 ? Side::BUY : Side::SELL, 25, sink); break;
+        case 1:  live->submitLimit(Side::SELL, 1010000, 10, sink); break;
+        case 2:  live->cancelOrder(1 + rng() % (resting * 3 / 2)); break;
+        default: live->submitLimit(Side::BUY, 990000, 10, sink); break;
+        }
+    }
+    uint64_t journaled = live->journal()->lastSequence();
+    live.reset();
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "  snapshot write      : " << std::setw(8) << write.elapsed_ms() << " ms  "
+              << mib << " MiB, journal seq " << covered << "\n";
+
+    auto restart = [&](const char* label, const std::string& snapshot, const std::string& journal,
+                       uint64_t events) {
+        auto engine = std::make_unique<MatchingEngine>(false, ladder);
+        BenchmarkTimer t;
+        uint64_t replayed = engine->restore(snapshot, journal);
+        t.stop();
+        std::cout << "  " << std::left << std::setw(20) << label << std::right << ": "
+                  << std::setw(8) << t.elapsed_ms() << " ms  "
+                  << engine->book().activeOrders() << " resting, "
+                  << replayed << "/" << events << " replayed\n";
+    };
+    restart("load snapshot",    path, "",      0);
+    restart("snapshot + tail",  path, cfg.dir, journaled - covered);
+    restart("full replay",      "",   cfg.dir, journaled);
+
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Queue benchmark — Michael-Scott ConcurrentQueue vs bounded rings
+//
+// P producer threads each push items/P OrderEvents while the calling thread
+// consumes them all; the time runs from releasing the producers until the
+// last item is taken. Rings use a 4096-slot buffer, so producers regularly
+// meet a full ring and spin. "bulk" variants move 16 events per call on both
+// sides. Allocations are counted across the whole run.
+// ---------------------------------------------------------------------------
+template <typename Push, typename Pop>
+static void timeQueue(const char* label, int producers, uint64_t items, Push push, Pop pop) {
+    uint64_t per = items / static_cast<uint64_t>(producers);
+    uint64_t total_items = per * static_cast<uint64_t>(producers);
+    std::atomic<bool> go{false};
+
+    uint64_t allocs0 = g_allocs.load();
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            OrderEvent ev(EventKind::SUBMIT_LIMIT, 0, 'B', 1000000, 1);
+            while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+            for (uint64_t i = 0; i < per;) {
+                ev.order_id = static_cast<uint64_t>(p) * per + i;
+                i += push(ev, per - i);
+            }
+        });
+    }
+
+    BenchmarkTimer timer;
+    go.store(true, std::memory_order_release);
+    for (uint64_t got = 0; got < total_items;) {
+        uint64_t n = pop();
+        if (n == 0) std::this_thread::yield();
+        got += n;
+    }
+    timer.stop();
+    for (auto& t : threads) t.join();
+    uint64_t allocs = g_allocs.load() - allocs0 - static_cast<uint64_t>(producers);   // thread states
+
+    std::cout << "  " << std::left << std::setw(18) << label << std::right
+              << std::setw(9) << producers
+              << std::setw(14) << static_cast<uint64_t>(
+                     static_cast<double>(total_items) * 1e9 / timer.elapsed_ns())
+              << std::setw(12) << std::fixed << std::setprecision(2)
+              << static_cast<double>(allocs) / static_cast<double>(total_items) << "\n";
+}
+
+static void runQueueBenchmark(uint64_t items) {
+    constexpr size_t RING = 4096;
+    constexpr size_t BULK = 16;
+    std::cout << "\n=== Queue Benchmark (" << items << " events, ring " << RING << ") ===\n"
+              << "  queue             producers    events/sec  allocs/event\n";
+
+    for (int producers : {1, 2, 4, 8, 16}) {
+        {
+            ConcurrentQueue<OrderEvent> q;
+            timeQueue("ms_queue", producers, items,
+                [&](const OrderEvent& ev, uint64_t) { q.enqueue(ev); return uint64_t{1}; },
+                [&] { OrderEvent ev; return q.dequeue(ev) ? uint64_t{1} : uint64_t{0}; });
+        }
+        {
+            MpscRing<OrderEvent> q(RING);
+            timeQueue("mpsc_ring", producers, items,
+                [&](const OrderEvent& ev, uint64_t) { q.enqueue(ev); return uint64_t{1}; },
+                [&] { OrderEvent ev; return q.dequeue(ev) ? uint64_t{1} : uint64_t{0}; });
+        }
+        {
+            MpscRing<OrderEvent> q(RING);
+            timeQueue("mpsc_ring bulk", producers, items,
+                [&](const OrderEvent& ev, uint64_t left) {
+                    OrderEvent burst[BULK];
+                    size_t     n = std::min<uint64_t>(BULK, left);
+                    for (size_t k = 0; k < n; ++k) { burst[k] = ev; burst[k].order_id += k; }
+                    q.enqueueBulk(burst, n);
+                    return static_cast<uint64_t>(n);
+                },
+                [&] { OrderEvent out[BULK]; return static_cast<uint64_t>(q.dequeueBulk(out, BULK)); });
+        }
+        if (producers == 1) {
+            SpscRing<OrderEvent> q(RING);
+            timeQueue("spsc_ring bulk", producers, items,
+                [&](const OrderEvent& ev, uint64_t left) {
+                    OrderEvent burst[BULK];
+                    size_t     n = std::min<uint64_t>(BULK, left);
+                    for (size_t k = 0; k < n; ++k) { burst[k] = ev; burst[k].order_id += k; }
+                    q.enqueueBulk(burst, n);
+                    return static_cast<uint64_t>(n);
+                },
+                [&] { OrderEvent out[BULK]; return static_cast<uint64_t>(q.dequeueBulk(out, BULK)); });
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Wait strategy benchmark — consumer latency and CPU by offered load
+//
+// One producer submits limit orders to a ConcurrentMatchingEngine built
+// with each wait strategy. Low and medium load pace the producer at a fixed
+// rate for 200 ms, releasing a tick's worth of orders every 100 us and
+// sleeping in between; saturating load submits n orders back to back.
+// Latency runs from the submit call's clock stamp until the consumer has
+// matched the order. CPU is the consumer thread's CPU time over the run's
+// wall time.
+// ---------------------------------------------------------------------------
+template <typename Wait>
+static void waitStrategyRun(const char* load, uint64_t rate, uint64_t events) {
+    BasicConcurrentMatchingEngine<Wait> cme(false, events);
+    std::mt19937_64 rng{19};
+    std::uniform_int_distribution<int64_t>  tick_dist(-50, 50);
+    std::uniform_int_distribution<uint64_t> qty_dist(1, 200);
+
+    auto submit = [&] {
+        Side side = (rng() & 1) ? Side::BUY : Side::SELL;
+        cme.submitLimit(side, 1000000 + tick_dist(rng) * 100, qty_dist(rng));
+    };
+
+    BenchmarkTimer wall;
+    if (rate == 0) {
+        for (uint64_t i = 0; i < events; ++i) submit();
+    } else {
+        constexpr int64_t TICK_NS  = 100'000;
+        uint64_t          per_tick = std::max<uint64_t>(1, rate * TICK_NS / 1'000'000'000);
+        auto              next     = std::chrono::steady_clock::now();
+        for (uint64_t sent = 0; sent < events;) {
+            for (uint64_t k = 0; k < per_tick && sent < events; ++k, ++sent) submit();
+            next += std::chrono::nanoseconds(TICK_NS);
+            std::this_thread::sleep_until(next);
+        }
+    }
+    cme.stop();
+    wall.stop();
+
+    PerformanceStats stats;
+    for (int64_t ns : cme.latencies()) stats.add_latency(static_cast<double>(ns));
     stats.compute();
-    stats.print_summary("Modify order latency");
+    WaitStats w = cme.waitStats();
+
+    std::cout << "  " << std::left << std::setw(11) << Wait::NAME << std::setw(11) << load
+              << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8)  << stats.p50_ns() / 1000.0
+              << std::setw(9)  << stats.p99_ns() / 1000.0
+              << std::setw(10) << stats.max_ns() / 1000.0
+              << std::setw(7)  << 100.0 * static_cast<double>(cme.consumerCpuNs()) / wall.elapsed_ns()
+              << std::setw(12) << w.idle_spins
+              << std::setw(9)  << w.yields
+              << std::setw(8)  << w.sleeps
+              << std::setw(8)  << w.parks
+              << std::setw(9)  << w.wakeups << "\n";
+}
+
+template <typename Wait>
+static void waitStrategyLoads(uint64_t n) {
+    waitStrategyRun<Wait>("low", 10'000, 2'000);
+    waitStrategyRun<Wait>("medium", 200'000, 40'000);
+    waitStrategyRun<Wait>("saturating", 0, n);
+}
+
+static void runWaitStrategyBenchmark(uint64_t n) {
+    std::cout << "\n=== Wait Strategy Benchmark (low 10k/s, medium 200k/s, saturating "
+              << n << " orders) ===\n"
+              << "  strategy   load        p50 us   p99 us    max us  cpu %"
+              << "  idle spins   yields  sleeps   parks  wakeups\n";
+    waitStrategyLoads<BusySpinWait>(n);
+    waitStrategyLoads<SpinYieldWait>(n);
+    waitStrategyLoads<SpinParkWait>(n);
+    waitStrategyLoads<BackoffWait>(n);
+}
+
+// ---------------------------------------------------------------------------
+// MPMC queue benchmark — ConcurrentQueue with as many consumers as producers
+//
+// Only the Michael-Scott queue admits several consumers. Hazard pointers
+// make that safe and the node freelist keeps allocations near zero; this
+// reports the throughput and the allocations per event that remain.
+// ---------------------------------------------------------------------------
+static void runMpmcQueueBenchmark(uint64_t items) {
+    std::cout << "\n=== MPMC Queue Benchmark (" << items << " events) ===\n"
+              << "  producers  consumers    events/sec  allocs/event\n";
+
+    for (int threads : {1, 2, 4, 8}) {
+        ConcurrentQueue<OrderEvent> q;
+        uint64_t per   = items / static_cast<uint64_t>(threads);
+        uint64_t total = per * static_cast<uint64_t>(threads);
+        std::atomic<bool>     go{false};
+        std::atomic<uint64_t> consumed{0};
+
+        uint64_t allocs0 = g_allocs.load();
+        std::vector<std::thread> workers;
+        for (int p = 0; p < threads; ++p) {
+            workers.emplace_back([&, p] {
+                OrderEvent ev(EventKind::SUBMIT_LIMIT, 0, 'B', 1000000, 1);
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (uint64_t i = 0; i < per; ++i) {
+                    ev.order_id = static_cast<uint64_t>(p) * per + i;
+                    q.enqueue(ev);
+                }
+            });
+            workers.emplace_back([&] {
+                OrderEvent ev;
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                while (consumed.load(std::memory_order_relaxed) < total) {
+                    if (q.dequeue(ev)) consumed.fetch_add(1, std::memory_order_relaxed);
+                    else               std::this_thread::yield();
+                }
+            });
+        }
+
+        BenchmarkTimer timer;
+        go.store(true, std::memory_order_release);
+        for (auto& t : workers) t.join();
+        timer.stop();
+        uint64_t allocs = g_allocs.load() - allocs0 - workers.size();   // thread states
+
+        std::cout << "  " << std::setw(9) << threads << std::setw(11) << threads
+                  << std::setw(14) << static_cast<uint64_t>(
+                         static_cast<double>(total) * 1e9 / timer.elapsed_ns())
+                  << std::setw(14) << std::fixed << std::setprecision(3)
+                  << static_cast<double>(allocs) / static_cast<double>(total) << "\n";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Multi-symbol scaling benchmark — aggregate orders/sec by symbols x workers
+//
+// The same stream of n limit and market orders, spread uniformly over the
+// symbols, is pushed through a MultiSymbolEngine by one producer thread per
+// worker (each takes a contiguous slice). Workers double from 1 up to the
+// core count, capped at the symbol count, and the cap itself is always run. Timing runs from the first
+// submit until stop() has drained every queue; building the books is not
+// included.
+// ---------------------------------------------------------------------------
+static std::vector<OrderEvent> buildSymbolWorkload(uint64_t n, uint32_t symbols, uint64_t seed) {
+    std::mt19937_64 rng{seed};
+    std::normal_distribution<double>        price_dist(1000000.0, 10000.0);
+    std::uniform_int_distribution<uint64_t> qty_dist(1, 200);
+    std::uniform_int_distribution<uint32_t> sym_dist(0, symbols - 1);
+    std::uniform_int_distribution<int>      side_dist(0, 1);
+    std::uniform_int_distribution<int>      kind_dist(0, 4);
+
+    std::vector<OrderEvent> events;
+    events.reserve(n);
+    for (uint64_t i = 0; i < n; ++i) {
+        char     side = side_dist(rng) ? 'B' : 'S';
+        uint32_t sym  = sym_dist(rng);
+        if (kind_dist(rng) == 0) {
+            events.emplace_back(EventKind::SUBMIT_MARKET, i, side, 0, qty_dist(rng), sym);
+        } else {
+            int64_t price = (static_cast<int64_t>(price_dist(rng)) / 100) * 100;
+            events.emplace_back(EventKind::SUBMIT_LIMIT, i, side, price, qty_dist(rng), sym);
+        }
+    }
+    return events;
+}
+
+static double runSymbolShards(const std::vector<OrderEvent>& events, uint32_t symbols,
+                              size_t workers) {
+    MultiSymbolConfig config;
+    config.workers            = workers;
+    config.tape.ring_capacity = 4096;
+    MultiSymbolEngine engine(config);
+    for (uint32_t s = 0; s < symbols; ++s)
+        engine.addSymbol("SYM" + std::to_string(s), LadderConfig{900000, 100, 2000});
+    engine.start();
+
+    size_t per = events.size() / workers;
+    BenchmarkTimer total;
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < workers; ++p) {
+        producers.emplace_back([&, p] {
+            size_t end = (p + 1 == workers) ? events.size() : (p + 1) * per;
+            for (size_t i = p * per; i < end; ++i) engine.submit(events[i]);
+        });
+    }
+    for (auto& t : producers) t.join();
+    engine.stop();
+    total.stop();
+
+    return static_cast<double>(engine.eventsProcessed()) * 1e9 / total.elapsed_ns();
+}
+
+static void runMultiSymbolBenchmark(uint64_t n) {
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\n=== Multi-Symbol Scaling Benchmark (" << n << " orders, "
+              << cores << " cores) ===\n"
+              << "  symbols  workers      orders/sec\n";
+
+    for (uint32_t symbols : {1u, 4u, 16u, 64u}) {
+        auto events = buildSymbolWorkload(n, symbols, 1601 + symbols);
+        size_t limit = std::min<size_t>(cores, symbols);
+        for (size_t workers = 1;; workers = std::min(workers * 2, limit)) {
+            double rate = runSymbolShards(events, symbols, workers);
+            std::cout << "  " << std::setw(7) << symbols << "  " << std::setw(7) << workers
+                      << "  " << std::setw(14) << static_cast<uint64_t>(rate) << "\n";
+            if (workers == limit) break;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Order-id index benchmark — OrderIndex vs std::unordered_map
+//
+// For each resting-book size, inserts that many dense ids (timed one by one,
+// so rehash stalls show up in the tail) and then performs random lookups.
+// The index stores Order* but never dereferences it, so the benchmark uses
+// synthetic pointer values instead of building millions of real orders.
+// ---------------------------------------------------------------------------
+static void runIndexBenchmark(const std::vector<uint64_t>& sizes, uint64_t lookups) {
+    std::cout << "\n=== Order Index Benchmark (" << lookups << " lookups per size) ===\n";
+
+    auto fake = [](uint64_t id) {
+        return reinterpret_cast<Order*>(static_cast<uintptr_t>(id) << 6);
+    };
+
+    for (uint64_t n : sizes) {
+        std::mt19937_64 rng{n};
+        std::uniform_int_distribution<uint64_t> pick(1, n);
+        std::vector<uint64_t> probes(lookups);
+        for (auto& id : probes) id = pick(rng);
+
+        const std::string tag = " (" + std::to_string(n) + " resting)";
+        uint64_t sink = 0;
+
+        {
+            std::unordered_map<uint64_t, Order*> map;
+            PerformanceStats ins, look;
+            for (uint64_t id = 1; id <= n; ++id) {
+                BenchmarkTimer t;
+                map[id] = fake(id);
+                t.stop();
+                ins.add_latency(t.elapsed_ns());
+            }
+            for (uint64_t id : probes) {
+                BenchmarkTimer t;
+                auto it = map.find(id);
+                sink += reinterpret_cast<uintptr_t>(it->second);
+                t.stop();
+                look.add_latency(t.elapsed_ns());
+            }
+            ins.compute();
+            look.compute();
+            ins.print_summary("unordered_map insert" + tag);
+            look.print_summary("unordered_map lookup" + tag);
+        }
+        {
+            OrderIndex idx;
+            PerformanceStats ins, look;
+            for (uint64_t id = 1; id <= n; ++id) {
+                BenchmarkTimer t;
+                idx.insert(id, fake(id));
+                t.stop();
+                ins.add_latency(t.elapsed_ns());
+            }
+            for (uint64_t id : probes) {
+                BenchmarkTimer t;
+                sink += reinterpret_cast<uintptr_t>(idx.find(id));
+                t.stop();
+                look.add_latency(t.elapsed_ns());
+            }
+            ins.compute();
+            look.compute();
+            ins.print_summary("OrderIndex insert" + tag);
+            look.print_summary("OrderIndex lookup" + tag);
+        }
+
+        if (sink == 1) std::cout << "";   // keep lookups observable
+    }
 }
 
 // Declared in concurrent_matching_engine.cpp
-void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer);
+void runConcurrentBenchmark(int num_producers, uint64_t orders_per_producer, bool pin);
 
 int main(int argc, char** argv) {
     uint64_t n = (argc > 1) ? std::stoull(argv[1]) : 200000;
 
+    runRestingBookBenchmark(1'000'000, 400);
+    runColdStartBenchmark(1'000'000);
     runLatencyBenchmark(n);
     runThroughputBenchmark(n * 5);
     runModifyBenchmark(50000);
-    runConcurrentBenchmark(4, n / 4);
+    runLadderBenchmark(n);
+    runCancelBenchmark(50000, 1000);
+    runCancelBenchmark(50000, 4000);
+    runStopTriggerBenchmark(20000, 50000);
+    runAllocationBenchmark(n);
+    runPoolBenchmark(n * 5);
+    runKernelBenchmark(n * 5);
+    runBatchBenchmark(n * 5);
+    runClockBenchmark(10'000'000);
+    runTopOfBookBenchmark(n / 10);
+    runLockPolicyBenchmark(n);
+    runTradeTapeBenchmark(5'000'000);
+    runJournalBenchmark(n);
+    runSnapshotBenchmark(1'000'000, 100'000);
+    runSnapshotBenchmark(10'000'000, 100'000);
+    runIndexBenchmark({10'000, 100'000, 1'000'000, 10'000'000}, 1'000'000);
+    runConcurrentBenchmark(4, n / 4, false);
+    runConcurrentBenchmark(4, n / 4, true);
+    runWaitStrategyBenchmark(n);
+    runQueueBenchmark(n * 5);
+    runMpmcQueueBenchmark(n * 5);
+    runMultiSymbolBenchmark(n);
 
     return 0;
 }
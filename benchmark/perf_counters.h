@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ---------------------------------------------------------------------------
+// PerfCounters
+//
+// User-space hardware counters for the calling thread (instructions,
+// branches, branch misses) read as one perf_event group. Virtual machines
+// and containers often expose no PMU or forbid perf_event_open; then
+// available() is false, error() says why, and every count reads 0.
+//
+// Typical usage:
+//   PerfCounters pc;
+//   pc.start();
+//   do_work();
+//   pc.stop();
+//   if (pc.available()) report(pc.instructions(), pc.branchMisses());
+// ---------------------------------------------------------------------------
+class PerfCounters {
+public:
+    PerfCounters() {
+        leader_ = open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+        if (leader_ < 0) { error_ = std::strerror(errno); return; }
+        branches_ = open(PERF_COUNT_HW_BRANCH_INSTRUCTIONS, leader_);
+        misses_   = open(PERF_COUNT_HW_BRANCH_MISSES, leader_);
+        if (branches_ < 0 || misses_ < 0) { error_ = std::strerror(errno); close(); }
+    }
+
+    ~PerfCounters() { close(); }
+
+    PerfCounters(const PerfCounters&)            = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool               available() const { return leader_ >= 0; }
+    const std::string& error()     const { return error_; }
+
+    void start() {
+        if (!available()) return;
+        ioctl(leader_, PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    void stop() {
+        if (!available()) return;
+        ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        struct { uint64_t nr; uint64_t values[3]; } data{};
+        if (::read(leader_, &data, sizeof(data)) == static_cast<ssize_t>(sizeof(data))) {
+            instructions_ = data.values[0];
+            branches_n_   = data.values[1];
+            misses_n_     = data.values[2];
+        }
+    }
+
+    uint64_t instructions() const { return instructions_; }
+    uint64_t branches()     const { return branches_n_; }
+    uint64_t branchMisses() const { return misses_n_; }
+
+private:
+    int         leader_{-1};
+    int         branches_{-1};
+    int         misses_{-1};
+    uint64_t    instructions_{0};
+    uint64_t    branches_n_{0};
+    uint64_t    misses_n_{0};
+    std::string error_;
+
+    static int open(uint64_t config, int group) {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config;
+        attr.disabled       = group < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format    = PERF_FORMAT_GROUP;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+
+    void close() {
+        for (int* fd : {&misses_, &branches_, &leader_})
+            if (*fd >= 0) { ::close(*fd); *fd = -1; }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// DtlbMissCounter
+//
+// Data-TLB load misses of the calling thread, user space only, as a single
+// perf_event. Same availability rules and usage as PerfCounters.
+// ---------------------------------------------------------------------------
+class DtlbMissCounter {
+public:
+    DtlbMissCounter() {
+        perf_event_attr attr{};
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HW_CACHE;
+        attr.config         = PERF_COUNT_HW_CACHE_DTLB |
+                              (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        if (fd_ < 0) error_ = std::strerror(errno);
+    }
+
+    ~DtlbMissCounter() {
+        if (fd_ >= 0) ::close(fd_);
+    }
+
+    DtlbMissCounter(const DtlbMissCounter&)            = delete;
+    DtlbMissCounter& operator=(const DtlbMissCounter&) = delete;
+
+    bool               available() const { return fd_ >= 0; }
+    const std::string& error()     const { return error_; }
+
+    void start() {
+        if (!available()) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    void stop() {
+        if (!available()) return;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t v = 0;
+        if (::read(fd_, &v, sizeof(v)) == static_cast<ssize_t>(sizeof(v))) misses_ = v;
+    }
+
+    uint64_t misses() const { return misses_; }
+
+private:
+    int         fd_{-1};
+    uint64_t    misses_{0};
+    std::string error_;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOB_HAVE_RDTSC 1
+#endif
+
+// ---------------------------------------------------------------------------
+// Clock sources
+//
+// Every timestamp in the book — order arrival, trade time — comes from one
+// clock type fixed at compile time (EngineClock below), so reading it is an
+// inlined static call. A clock is any type providing
+//
+//   static int64_t now() noexcept;   // nanoseconds, monotonic
+//
+// Epochs differ between clocks; timestamps are only comparable with others
+// from the same clock.
+// ---------------------------------------------------------------------------
+
+// std::chrono::steady_clock: a vDSO call per read.
+struct SteadyClock {
+    static int64_t now() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+// Time-stamp counter scaled to nanoseconds: one rdtsc and a fixed-point
+// multiply per read. The tick rate is calibrated against steady_clock over a
+// few milliseconds on first use and the epoch is steady_clock's, so readings
+// line up with SteadyClock. Without an invariant TSC (or off x86) it reads
+// SteadyClock instead.
+struct TscClock {
+    __extension__ using Wide = unsigned __int128;
+
+    struct Calibration {
+        uint64_t tsc0{0};
+        int64_t  ns0{0};
+        uint64_t mult{0};    // ns per tick, 32.32 fixed point
+        bool     invariant{false};
+    };
+
+    static const Calibration& calibration() noexcept {
+        static const Calibration cal = calibrate();
+        return cal;
+    }
+
+    static int64_t now() noexcept {
+#ifdef LOB_HAVE_RDTSC
+        const Calibration& c = calibration();
+        if (c.invariant) {
+            Wide ticks = __rdtsc() - c.tsc0;
+            return c.ns0 + static_cast<int64_t>((ticks * c.mult) >> 32);
+        }
+#endif
+        return SteadyClock::now();
+    }
+
+private:
+    static Calibration calibrate() noexcept;
+};
+
+// Cached reading refreshed by a background thread every RESOLUTION_NS. A
+// read is a once-only start check plus one relaxed load; readings lag real
+// time by up to the refresh period. The thread starts on first use and
+// stops at exit. If it cannot be started, reads fall back to SteadyClock.
+struct CoarseClock {
+    static constexpr int64_t RESOLUTION_NS = 100'000;
+
+    static int64_t now() noexcept {
+        static const bool running = start();
+        return running ? ns_.load(std::memory_order_relaxed) : SteadyClock::now();
+    }
+
+private:
+    static inline std::atomic<int64_t> ns_{0};
+    static bool start() noexcept;
+};
+
+// Driven by the caller, for deterministic replay and tests: reads return
+// whatever was last set, shared by every thread in the process.
+struct ManualClock {
+    static int64_t now() noexcept { return ns_.load(std::memory_order_relaxed); }
+    static void    set(int64_t ns) noexcept { ns_.store(ns, std::memory_order_relaxed); }
+    static void    advance(int64_t ns) noexcept { ns_.fetch_add(ns, std::memory_order_relaxed); }
+
+private:
+    static inline std::atomic<int64_t> ns_{0};
+};
+
+// Build-time selection (CMake: -DLOB_CLOCK=tsc|coarse|manual|steady).
+#if defined(LOB_CLOCK_MANUAL)
+using EngineClock = ManualClock;
+#elif defined(LOB_CLOCK_COARSE)
+using EngineClock = CoarseClock;
+#elif defined(LOB_CLOCK_STEADY)
+using EngineClock = SteadyClock;
+#else
+using EngineClock = TscClock;
+#endif
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "thread_slot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ConcurrentQueue<T>
+//
+// Lock-free, multi-producer / multi-consumer queue based on the Michael-Scott
+// algorithm (M. M. Michael and M. L. Scott, "Simple, Fast, and Practical
+// Non-Blocking and Blocking Concurrent Queue Algorithms", PODC 1996).
+//
+// Guarantees:
+//   - Linearisable enqueue and dequeue operations.
+//   - Progress: lock-free (every operation completes in a finite number of
+//     steps system-wide even if individual threads are delayed).
+//   - Memory order: acquire/release pairs that are sufficient for x86 and
+//     correctly synchronise on weakly-ordered architectures.
+//
+// Reclamation: hazard pointers (M. M. Michael, "Hazard Pointers: Safe Memory
+// Reclamation for Lock-Free Objects", IEEE TPDS 2004). Before it
+// dereferences a node another thread could unlink, a thread publishes the
+// pointer in its hazard slot (indexed by ThreadSlot::id()) and re-checks
+// that the node is still reachable. A dequeued sentinel is retired to the
+// dequeuing thread's list; once the list is long enough, every node on it
+// that no hazard slot names goes to the queue's freelist. enqueue() takes
+// nodes from the freelist before it calls new, so in steady state the queue
+// does not allocate. A node reaches the freelist only when nobody holds a
+// pointer to it, which also rules out ABA on the head, tail and freelist
+// CASes.
+//
+// Limitations:
+//   - At most ThreadSlot::MAX_THREADS threads may use queues at once.
+//   - Nodes go back to the allocator only when the queue is destroyed, so
+//     memory stays at the high-water mark of queued plus retired items.
+//   - T must be default-constructible and movable.
+// ---------------------------------------------------------------------------
+template <typename T>
+class ConcurrentQueue {
+private:
+    struct Node {
+        T                  value{};
+        std::atomic<Node*> next{nullptr};   // queue link, or freelist link
+    };
+
+    static constexpr size_t HAZARDS = 2;    // per thread: head/tail and next
+
+    // One thread's hazard pointers and retired sentinels. Only the slot's
+    // owner writes it; scans by other threads read the hazards.
+    struct alignas(64) Slot {
+        std::atomic<Node*> hazard[HAZARDS]{};
+        std::vector<Node*> retired;
+        std::vector<Node*> scratch;          // hazard snapshot, reused per scan
+    };
+
+    // Each pointer lives on its own 64-byte cache line so that producer and
+    // consumer threads do not thrash each other's cache lines (false sharing).
+    alignas(64) std::atomic<Node*> head_;
+    char pad_[64 - sizeof(std::atomic<Node*>)];   // padding to full cache line
+    alignas(64) std::atomic<Node*> tail_;
+    alignas(64) std::atomic<Node*> free_{nullptr};
+    std::atomic<size_t>            slots_used_{0};   // 1 + highest slot id seen
+    std::atomic<size_t>            allocated_{0};
+    std::unique_ptr<Slot[]>        slots_;
+
+public:
+    ConcurrentQueue() : slots_(std::make_unique<Slot[]>(ThreadSlot::MAX_THREADS)) {
+        // The queue always contains one sentinel (dummy) node so that head_
+        // and tail_ are never null and dequeue never races with enqueue on an
+        // empty structure.
+        Node* sentinel = newNode();
+        head_.store(sentinel, std::memory_order_relaxed);
+        tail_.store(sentinel, std::memory_order_relaxed);
+    }
+
+    ~ConcurrentQueue() {
+        // Drain any remaining nodes (including the sentinel), then the
+        // freelist and every thread's retired sentinels.
+        freeChain(head_.load(std::memory_order_relaxed));
+        freeChain(free_.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < ThreadSlot::MAX_THREADS; ++i)
+            for (Node* n : slots_[i].retired) delete n;
+    }
+
+    // Non-copyable, non-assignable.
+    ConcurrentQueue(const ConcurrentQueue&)            = delete;
+    ConcurrentQueue& operator=(const ConcurrentQueue&) = delete;
+
+    // Nodes obtained from the allocator over the queue's lifetime.
+    size_t nodesAllocated() const noexcept { return allocated_.load(std::memory_order_relaxed); }
+
+    // -----------------------------------------------------------------------
+    // enqueue
+    //
+    // Appends val to the tail of the queue. Always succeeds.
+    // -----------------------------------------------------------------------
+    void enqueue(T val) {
+        Slot& slot = mySlot();
+        Node* node = takeNode(slot);
+        node->value = std::move(val);
+        node->next.store(nullptr, std::memory_order_relaxed);
+
+        while (true) {
+            Node* tail = protect(slot, 0, tail_);
+            Node* next = tail->next.load(std::memory_order_acquire);
+
+            // Re-read tail_ — it may have changed since we loaded it.
+            if (tail != tail_.load(std::memory_order_acquire)) continue;
+
+            if (next == nullptr) {
+                // Tail is pointing at the last node: try to link our new node.
+                Node* expected = nullptr;
+                if (tail->next.compare_exchange_weak(
+                        expected, node,
+                        std::memory_order_release,
+                        std::memory_order_relaxed)) {
+                    // Linked successfully. Advance tail_ (best-effort; if we
+                    // fail, the next enqueue/dequeue will fix it).
+                    tail_.compare_exchange_weak(
+                        tail, node,
+                        std::memory_order_release,
+                        std::memory_order_relaxed);
+                    break;
+                }
+            } else {
+                // Tail is lagging behind; advance it and retry.
+                tail_.compare_exchange_weak(
+                    tail, next,
+                    std::memory_order_release,
+                    std::memory_order_relaxed);
+            }
+        }
+        slot.hazard[0].store(nullptr, std::memory_order_release);
+    }
+
+    // -----------------------------------------------------------------------
+    // dequeue
+    //
+    // Removes the front element and stores it in result.
+    // Returns true on success, false if the queue was empty.
+    // -----------------------------------------------------------------------
+    bool dequeue(T& result) {
+        Slot& slot = mySlot();
+        while (true) {
+            Node* head = protect(slot, 0, head_);
+            Node* tail = tail_.load(std::memory_order_acquire);
+            Node* next = head->next.load(std::memory_order_acquire);
+
+            // Publish next, then re-check that head is still the head: if
+            // so, next was its successor while both were in the queue, and
+            // it cannot be recycled until the hazard is cleared.
+            slot.hazard[1].store(next, std::memory_order_seq_cst);
+            if (head != head_.load(std::memory_order_seq_cst)) continue;
+
+            if (head == tail) {
+                // Queue appears empty or tail is lagging.
+                if (next == nullptr) {
+                    // Truly empty.
+                    clearHazards(slot);
+                    return false;
+                }
+                // Tail is behind; advance it to help other threads.
+                tail_.compare_exchange_weak(
+                    tail, next,
+                    std::memory_order_release,
+                    std::memory_order_relaxed);
+            } else if (head_.compare_exchange_weak(
+                           head, next,
+                           std::memory_order_release,
+                           std::memory_order_relaxed)) {
+                // next is the new sentinel. Its value is ours alone: other
+                // consumers read the value of the node after it.
+                result = std::move(next->value);
+                clearHazards(slot);
+                retire(slot, head);
+                return true;
+            }
+            // CAS failed — another thread dequeued; retry.
+        }
+    }
+
+private:
+    Slot& mySlot() {
+        size_t id   = ThreadSlot::id();
+        size_t used = slots_used_.load(std::memory_order_relaxed);
+        while (used <= id &&
+               !slots_used_.compare_exchange_weak(used, id + 1, std::memory_order_seq_cst)) {}
+        return slots_[id];
+    }
+
+    // Loads src into hazard i until the published value is still current.
+    Node* protect(Slot& slot, size_t i, const std::atomic<Node*>& src) {
+        Node* p = src.load(std::memory_order_acquire);
+        while (true) {
+            slot.hazard[i].store(p, std::memory_order_seq_cst);
+            Node* again = src.load(std::memory_order_seq_cst);
+            if (again == p) return p;
+            p = again;
+        }
+    }
+
+    static void clearHazards(Slot& slot) {
+        for (auto& h : slot.hazard) h.store(nullptr, std::memory_order_release);
+    }
+
+    Node* newNode() {
+        allocated_.fetch_add(1, std::memory_order_relaxed);
+        return new Node();
+    }
+
+    // Pops the freelist (Treiber stack) under hazard 0, or allocates.
+    Node* takeNode(Slot& slot) {
+        Node* top;
+        while ((top = protect(slot, 0, free_)) != nullptr) {
+            Node* next = top->next.load(std::memory_order_acquire);
+            if (free_.compare_exchange_weak(top, next, std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+                break;
+        }
+        slot.hazard[0].store(nullptr, std::memory_order_release);
+        return top ? top : newNode();
+    }
+
+    void retire(Slot& slot, Node* node) {
+        slot.retired.push_back(node);
+        size_t active = slots_used_.load(std::memory_order_relaxed);
+        if (slot.retired.size() >= 2 * HAZARDS * active + 64) scan(slot);
+    }
+
+    // Moves every retired node no thread has published to the freelist, as
+    // one chain pushed with a single CAS. The fence orders the unlinking of
+    // those nodes before the hazard reads, so a thread whose hazard is not
+    // seen here will see the node gone when it re-checks.
+    void scan(Slot& slot) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        size_t active  = slots_used_.load(std::memory_order_seq_cst);
+        auto&  hazards = slot.scratch;
+        hazards.clear();
+        for (size_t i = 0; i < active; ++i)
+            for (auto& h : slots_[i].hazard)
+                if (Node* p = h.load(std::memory_order_seq_cst)) hazards.push_back(p);
+        std::sort(hazards.begin(), hazards.end());
+
+        Node*  first = nullptr;
+        Node*  last  = nullptr;
+        size_t kept  = 0;
+        for (Node* n : slot.retired) {
+            if (std::binary_search(hazards.begin(), hazards.end(), n)) {
+                slot.retired[kept++] = n;
+                continue;
+            }
+            n->next.store(first, std::memory_order_relaxed);
+            if (!first) last = n;
+            first = n;
+        }
+        slot.retired.resize(kept);
+        if (!first) return;
+
+        Node* top = free_.load(std::memory_order_relaxed);
+        do {
+            last->next.store(top, std::memory_order_relaxed);
+        } while (!free_.compare_exchange_weak(top, first, std::memory_order_release,
+                                              std::memory_order_relaxed));
+    }
+
+    static void freeChain(Node* n) {
+        while (n != nullptr) {
+            Node* next = n->next.load(std::memory_order_relaxed);
+            delete n;
+            n = next;
+        }
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// ---------------------------------------------------------------------------
+// Huge-page regions
+//
+// Anonymous memory for slabs and other large, long-lived arrays. With huge
+// set, mapRegion() rounds the size up to whole 2 MiB pages and tries, in
+// order:
+//   1. MAP_HUGETLB — explicit huge pages from the kernel's reserved pool
+//      (vm.nr_hugepages). Reserved at map time, so success means backed.
+//   2. A 2 MiB-aligned normal mapping advised with MADV_HUGEPAGE, which
+//      transparent huge pages back when THP is "always" or "madvise".
+//   3. The same mapping on normal pages, if the advice is refused.
+// Without huge it maps normal pages. With prefault every page is touched
+// before mapRegion() returns, so the faults are taken now, on the calling
+// thread (and NUMA node), not on the first order that lands there.
+//
+// Off Linux the region comes from operator new. Throws std::bad_alloc if
+// no memory can be mapped.
+// ---------------------------------------------------------------------------
+
+enum class PageBacking : uint8_t {
+    HEAP,               // operator new
+    NORMAL,             // mmap, base pages
+    TRANSPARENT_HUGE,   // mmap, MADV_HUGEPAGE accepted
+    HUGETLB,            // mmap, MAP_HUGETLB
+};
+
+const char* pageBackingName(PageBacking backing) noexcept;
+
+struct PageRegion {
+    void*       base{nullptr};
+    size_t      bytes{0};
+    PageBacking backing{PageBacking::HEAP};
+};
+
+constexpr size_t HUGE_PAGE_BYTES = size_t{2} << 20;
+
+PageRegion mapRegion(size_t bytes, bool huge, bool prefault);
+void       unmapRegion(const PageRegion& region) noexcept;
+
+// ---------------------------------------------------------------------------
+// HugePageAllocator<T>
+//
+// Standard allocator for containers that are sized once and large, such as
+// a dense price ladder. Allocations of at least one huge page go through
+// mapRegion(bytes, true, false); smaller ones use operator new. The
+// container's own value-initialisation prefaults the pages.
+// ---------------------------------------------------------------------------
+template <typename T>
+struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_BYTES) return static_cast<T*>(::operator new(bytes));
+        return static_cast<T*>(mapRegion(bytes, true, false).base);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_BYTES) {
+            ::operator delete(p);
+            return;
+        }
+        // mapRegion() rounded the length up the same way on every path.
+        unmapRegion({p, (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES,
+                     PageBacking::NORMAL});
+    }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
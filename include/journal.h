@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// How far an appended event has got when append() returns. Every level
+// survives the process dying; they differ on a kernel crash or power loss.
+enum class Durability : uint8_t {
+    MAPPED,         // in the page cache only; written back when the kernel chooses
+    GROUP_COMMIT,   // msync'd by the journal thread every commit_events or commit_interval_us
+    PER_EVENT,      // msync'd by append() itself before it returns
+};
+
+const char* durabilityName(Durability d) noexcept;
+
+// With an empty dir there is no journal. The directory must exist.
+struct JournalConfig {
+    std::string dir;
+    Durability  durability         = Durability::GROUP_COMMIT;
+    size_t      segment_records    = size_t{1} << 20;   // 64 MiB segment files
+    size_t      commit_events      = 1024;              // group commit: events per msync, at most
+    int64_t     commit_interval_us = 1000;              // group commit: longest an event waits
+};
+
+// ---------------------------------------------------------------------------
+// Journal
+//
+// Write-ahead log of every event a matching engine accepts. append() stamps
+// the entry with the next sequence number (1, 2, ...) and a checksum and
+// stores its 64 bytes into a memory-mapped segment file, so the matching
+// thread never makes a system call for the log except under PER_EVENT.
+//
+// Segment file journal-<n>.seg is a 64-byte header (magic, first sequence,
+// capacity, record size) followed by capacity records. Segments are
+// preallocated with fallocate and mapped prefaulted. A background journal
+// thread creates the next segment before the current one fills, so
+// rotation is a pointer swap. Under GROUP_COMMIT the same thread msyncs
+// the records appended since its last commit every commit_events events
+// or commit_interval_us, whichever comes first. It then advances
+// durableSequence(). Under the other levels it commits a segment only once
+// the writer has left it. Either way it unmaps segments it has fully
+// committed.
+//
+// Records carry no separate length or count: the end of the log is the
+// first record whose checksum or sequence is wrong. Opening a directory
+// that already holds a journal continues it. The writer finds the last
+// valid record and zeroes whatever follows it in that segment, which may
+// be a torn or stale tail. It removes any later segment files and resumes
+// at the next sequence.
+//
+// One thread appends at a time; callers serialise (BasicMatchingEngine
+// does it under its journal lock). durableSequence() and sync() may be
+// called from any thread.
+// ---------------------------------------------------------------------------
+class Journal {
+public:
+    // One engine entry point call. Submits carry the engine id they were
+    // given, so a replay can check it assigns the same ones.
+    enum class Op : uint8_t { LIMIT, MARKET, ICEBERG, STOP_LOSS, CANCEL, MODIFY };
+
+    struct Entry {
+        uint64_t sequence;       // set by append()
+        Op       op;
+        char     side;           // 'B' or 'S'; unused by CANCEL and MODIFY
+        uint8_t  reserved0[6];
+        uint64_t order_id;       // id assigned (submits) or named (CANCEL, MODIFY)
+        int64_t  price;          // limit price; stop trigger; MODIFY's new price
+        uint64_t quantity;       // total quantity; MODIFY's new quantity
+        int64_t  timestamp_ns;   // the engine's clock for this event
+        int64_t  aux;            // iceberg display quantity; stop limit price
+        uint32_t reserved1;
+        uint32_t checksum;       // set by append()
+    };
+    static_assert(sizeof(Entry) == 64, "Journal::Entry must stay one cache line");
+
+    struct Stats {
+        uint64_t appended;   // last sequence written
+        uint64_t durable;    // last sequence committed
+        uint64_t commits;    // msync batches, any thread
+        uint64_t segments;   // segment files created
+    };
+
+    // Throws std::system_error if the first segment cannot be opened or
+    // created.
+    explicit Journal(const JournalConfig& cfg);
+
+    // Commits everything appended, whatever the durability, and stops the
+    // journal thread.
+    ~Journal();
+
+    Journal(const Journal&)            = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Returns the entry's sequence number. Throws std::system_error if a
+    // new segment is needed and cannot be created, or under PER_EVENT if
+    // the msync fails; the entry is not in the journal then.
+    uint64_t append(Entry e);
+
+    // Blocks until every entry appended so far is committed.
+    void sync();
+
+    uint64_t lastSequence()    const noexcept { return appended_.load(std::memory_order_acquire); }
+    uint64_t durableSequence() const noexcept { return durable_.load(std::memory_order_acquire); }
+    Stats    stats()           const noexcept;
+
+    const JournalConfig& config() const noexcept { return cfg_; }
+
+    static uint32_t checksum(const Entry& e) noexcept;
+
+private:
+    struct Segment;
+    friend class JournalReader;
+
+    JournalConfig                       cfg_;
+    Segment*                            current_{nullptr};   // owned by open_
+    uint64_t                            next_seq_{1};
+    uint64_t                            kicked_at_{0};       // sequence of the last group kick
+
+    std::mutex                          mu_;
+    std::condition_variable             wake_;          // journal thread
+    std::condition_variable             committed_;     // sync() waiters
+    std::condition_variable             prepared_;      // rotate() waiting for spare_
+    std::deque<std::shared_ptr<Segment>> open_;         // oldest uncommitted .. current
+    std::shared_ptr<Segment>            spare_;         // next segment, prepared ahead
+    bool                                kick_{false};
+    bool                                sync_{false};   // sync() wants a commit
+    bool                                stop_{false};
+    int                                 prepare_errno_{0};
+    int                                 commit_errno_{0};
+
+    alignas(64) std::atomic<uint64_t>   appended_{0};
+    alignas(64) std::atomic<uint64_t>   durable_{0};
+    std::atomic<uint64_t>               commits_{0};
+    std::atomic<uint64_t>               segments_{0};
+    std::thread                         thread_;
+
+    void resume();
+    void rotate();
+    void kick();
+    void run();
+    bool commit(uint64_t upto);
+    std::shared_ptr<Segment> create(uint64_t index, uint64_t first_seq);
+};
+
+// ---------------------------------------------------------------------------
+// JournalReader
+//
+// Reads a journal directory back in sequence order, from the oldest
+// segment file present, stopping at the first torn or missing record.
+// Independent of any Journal writing to the same directory, but only sees
+// what that writer has appended.
+// ---------------------------------------------------------------------------
+class JournalReader {
+public:
+    // Throws std::system_error if dir cannot be listed, and from next() if
+    // a segment file is not a journal segment.
+    explicit JournalReader(const std::string& dir);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&)            = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    // Next entry with sequence >= from (see skipTo), or false at the end.
+    bool next(Journal::Entry& out);
+
+    // Skips entries before sequence from; segments wholly before it are
+    // never mapped.
+    void skipTo(uint64_t from) noexcept { from_ = from; }
+
+private:
+    std::string                       dir_;
+    std::deque<uint64_t>              indices_;    // segment files still to read
+    std::shared_ptr<Journal::Segment> seg_;
+    size_t                            slot_{0};
+    uint64_t                          expect_{0};  // 0 until the first record
+    uint64_t                          from_{0};
+
+    bool openNext();
+};
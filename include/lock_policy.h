@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Lock policies
+//
+// BasicOrderBook and BasicMatchingEngine take one of these as a template
+// parameter. A policy names the book's Mutex, which must provide lock /
+// unlock / lock_shared / unlock_shared so std::unique_lock and
+// std::shared_lock work on it, and says whether more than one thread may
+// call into the book or engine at once. The engine keeps its order-id
+// counter atomic only when it may. Top-of-book readers go through the
+// book's seqlock under every policy.
+// ---------------------------------------------------------------------------
+
+// Does nothing: for a book that only one thread ever touches, such as the
+// one behind ConcurrentMatchingEngine's consumer.
+struct NullMutex {
+    void lock() noexcept {}
+    void unlock() noexcept {}
+    bool try_lock() noexcept { return true; }
+    void lock_shared() noexcept {}
+    void unlock_shared() noexcept {}
+    bool try_lock_shared() noexcept { return true; }
+};
+
+// FIFO spin lock. Waiters take a ticket and spin on the now-serving counter,
+// so the lock is handed over in arrival order and an uncontended lock /
+// unlock is one atomic increment and one store. Shared locking is exclusive:
+// the book's readers are short and the hot ones use the seqlock instead.
+// After a burst of spinning a waiter yields, so a holder that has been
+// preempted gets the CPU back on an oversubscribed machine.
+class TicketMutex {
+public:
+    void lock() noexcept {
+        uint32_t ticket = next_.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t spins = 0; serving_.load(std::memory_order_acquire) != ticket; ++spins) {
+            if (spins < SPIN_LIMIT) pause();
+            else                    std::this_thread::yield();
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t serving = serving_.load(std::memory_order_acquire);
+        uint32_t expected = serving;
+        return next_.compare_exchange_strong(expected, serving + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        serving_.store(serving_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void lock_shared() noexcept     { lock(); }
+    void unlock_shared() noexcept   { unlock(); }
+    bool try_lock_shared() noexcept { return try_lock(); }
+
+private:
+    static constexpr uint32_t SPIN_LIMIT = 1024;
+
+    std::atomic<uint32_t> next_{0};
+    std::atomic<uint32_t> serving_{0};
+
+    static void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#endif
+    }
+};
+
+// No locking at all. Only one thread may use the book or engine.
+struct SingleWriterPolicy {
+    using Mutex = NullMutex;
+    static constexpr bool concurrent = false;
+};
+
+// Every caller is serialised through a TicketMutex.
+struct TicketLockPolicy {
+    using Mutex = TicketMutex;
+    static constexpr bool concurrent = true;
+};
+
+// std::shared_mutex: concurrent readers of depth, order lookups and counts.
+struct SharedMutexPolicy {
+    using Mutex = std::shared_mutex;
+    static constexpr bool concurrent = true;
+};
+
+// Build-time selection (CMake: -DLOB_LOCK=shared|ticket|none) of the policy
+// behind the OrderBook and MatchingEngine aliases. Every policy is compiled
+// into lob_core, so the Basic* templates can be used with any of them.
+#if defined(LOB_LOCK_NONE)
+using DefaultLockPolicy = SingleWriterPolicy;
+#elif defined(LOB_LOCK_TICKET)
+using DefaultLockPolicy = TicketLockPolicy;
+#else
+using DefaultLockPolicy = SharedMutexPolicy;
+#endif
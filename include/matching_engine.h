@@ -1,13 +1,40 @@
 #pragma once
 
+#include "clock.h"
+#include "journal.h"
+#include "order_event.h"
 #include "orderbook.h"
-#include "memory_pool.h"
 #include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
 #include <vector>
 
-class MatchingEngine {
+// ---------------------------------------------------------------------------
+// BasicMatchingEngine<LockPolicy>
+//
+// Order-entry facade over one BasicOrderBook with the same lock policy. The
+// order-id counter is atomic only under a policy that admits concurrent
+// callers. MatchingEngine uses the build's default policy.
+//
+// With JournalConfig::dir set, every entry point first appends the event to
+// a write-ahead Journal (see journal.h) with the id and timestamp the
+// engine assigns it, and only then touches the book. Ids, journal order and
+// book order must agree for the journal to replay, so while journaling each
+// call holds the engine's journal lock (the policy's mutex) from id
+// assignment to the end of matching. Without a journal that lock is never
+// taken. If the journal cannot take an event, the call throws
+// std::system_error before the book changes.
+// ---------------------------------------------------------------------------
+template <typename LockPolicy>
+class BasicMatchingEngine {
 public:
-    explicit MatchingEngine(bool verbose = true);
+    using Book = BasicOrderBook<LockPolicy>;
+
+    explicit BasicMatchingEngine(bool verbose = true, const LadderConfig& ladder = {},
+                                 const TapeConfig& tape = {}, const PoolConfig& pool = {},
+                                 const JournalConfig& journal = {});
 
     uint64_t submitLimit(Side side, int64_t price, uint64_t qty);
     void     submitMarket(Side side, uint64_t qty);
@@ -16,6 +43,58 @@ public:
     uint64_t submitStopLoss(Side side, int64_t trigger_price,
                             int64_t limit_price, uint64_t qty);
 
+    // Sink overloads: no logging, trades and order updates go straight to
+    // sink (see trade_sink.h). The sink is a template parameter, so nothing
+    // is allocated or dispatched virtually per order.
+    template <typename Sink>
+    uint64_t submitLimit(Side side, int64_t price, uint64_t qty, Sink& sink) {
+        auto     lock = journalLock();
+        uint64_t id   = nextId();
+        int64_t  ts   = nowNs();
+        record(Journal::Op::LIMIT, side, id, price, qty, ts);
+        book_.match(book_.newOrder(id, ts, side, OrderKind::LIMIT, price, qty), sink);
+        return id;
+    }
+    template <typename Sink>
+    void submitMarket(Side side, uint64_t qty, Sink& sink) {
+        auto     lock = journalLock();
+        uint64_t id   = nextId();
+        int64_t  ts   = nowNs();
+        record(Journal::Op::MARKET, side, id, 0, qty, ts);
+        book_.match(book_.newOrder(id, ts, side, OrderKind::MARKET, 0LL, qty), sink);
+    }
+    template <typename Sink>
+    uint64_t submitIceberg(Side side, int64_t price, uint64_t total_qty,
+                           uint64_t display_qty, Sink& sink) {
+        auto     lock = journalLock();
+        uint64_t id   = nextId();
+        int64_t  ts   = nowNs();
+        record(Journal::Op::ICEBERG, side, id, price, total_qty, ts,
+               static_cast<int64_t>(display_qty));
+        book_.match(book_.newOrder(id, ts, side, price, total_qty, display_qty), sink);
+        return id;
+    }
+    template <typename Sink>
+    uint64_t submitStopLoss(Side side, int64_t trigger_price, int64_t limit_price,
+                            uint64_t qty, Sink& sink) {
+        auto     lock = journalLock();
+        uint64_t id   = nextId();
+        int64_t  ts   = nowNs();
+        record(Journal::Op::STOP_LOSS, side, id, trigger_price, qty, ts, limit_price);
+        book_.match(book_.newOrder(id, ts, side, trigger_price, limit_price, qty), sink);
+        return id;
+    }
+
+    // Processes [begin, end) in order under one book lock. Submits take
+    // consecutive ids and share one clock read made at the start of the
+    // batch; their order_id and timestamp_ns fields are ignored. A CANCEL's
+    // order_id is an engine id. The levels and orders the batch names are
+    // prefetched before matching starts. Trades and order updates are the
+    // ones the single-order sink overloads would produce; sink additionally
+    // receives onResult for every event (see trade_sink.h).
+    template <typename ResultSink>
+    void submitBatch(const OrderEvent* begin, const OrderEvent* end, ResultSink& sink);
+
     bool cancelOrder(uint64_t order_id);
     bool modifyOrder(uint64_t order_id, int64_t new_price, uint64_t new_qty);
 
@@ -25,15 +104,120 @@ public:
     void printStats()               const;
     void printPoolStats()           const;
 
-    const OrderBook& book() const { return book_; }
+    const Book& book() const { return book_; }
+
+    // Writes the book and the engine's counters to a snapshot file at path
+    // (see snapshot.h) and returns the journal sequence it covers, 0
+    // without a journal. The journal is synced first, so the snapshot never
+    // covers events a restart could lose from the journal. Entry points
+    // wait under the journal lock while it writes; without a journal the
+    // caller must keep them quiet itself.
+    uint64_t saveSnapshot(const std::string& path);
+
+    // Rebuilds a fresh engine's state: loads the snapshot (none if
+    // snapshot_path is empty), then replays the journal in journal_dir
+    // (default: the engine's own) from the first entry the snapshot does
+    // not cover. Replayed events keep their journaled ids and timestamps,
+    // are matched silently and are not journaled again. Returns the number
+    // of entries replayed. Throws std::system_error if the engine is not
+    // fresh or either file is unreadable.
+    uint64_t restore(const std::string& snapshot_path, const std::string& journal_dir = {});
+
+    // The write-ahead journal, or nullptr if the engine has none.
+    Journal*       journal()       { return journal_.get(); }
+    const Journal* journal() const { return journal_.get(); }
 
 private:
-    OrderBook             book_;
-    std::atomic<uint64_t> next_id_{1};
-    MemoryPool<Order>     pool_;
-    bool                  verbose_;
+    using IdCounter = std::conditional_t<LockPolicy::concurrent,
+                                         std::atomic<uint64_t>, uint64_t>;
+
+    using Mutex = typename LockPolicy::Mutex;
 
-    int64_t  nowUs()  const;
-    uint64_t nextId() { return next_id_.fetch_add(1, std::memory_order_relaxed); }
+    Book                     book_;
+    IdCounter                next_id_{1};
+    bool                     verbose_;
+    std::unique_ptr<Journal> journal_;
+    Mutex                    journal_mutex_;
+
+    static int64_t nowNs() noexcept { return EngineClock::now(); }
+    uint64_t nextId() noexcept {
+        if constexpr (LockPolicy::concurrent) return next_id_.fetch_add(1, std::memory_order_relaxed);
+        else                                  return next_id_++;
+    }
+    // Held from id assignment to the end of matching while journaling;
+    // empty otherwise.
+    std::unique_lock<Mutex> journalLock() {
+        return journal_ ? std::unique_lock<Mutex>(journal_mutex_) : std::unique_lock<Mutex>();
+    }
+    void record(Journal::Op op, Side side, uint64_t order_id, int64_t price, uint64_t qty,
+                int64_t ts, int64_t aux = 0) {
+        if (!journal_) return;
+        Journal::Entry e{};
+        e.op           = op;
+        e.side         = side == Side::BUY ? 'B' : 'S';
+        e.order_id     = order_id;
+        e.price        = price;
+        e.quantity     = qty;
+        e.timestamp_ns = ts;
+        e.aux          = aux;
+        journal_->append(e);
+    }
+    void route(Order* order);
+    void apply(const Journal::Entry& e);
+    void setNextId(uint64_t id) noexcept {
+        if constexpr (LockPolicy::concurrent) next_id_.store(id, std::memory_order_relaxed);
+        else                                  next_id_ = id;
+    }
     void logTrades(const std::vector<Trade>& trades) const;
 };
+
+extern template class BasicMatchingEngine<SingleWriterPolicy>;
+extern template class BasicMatchingEngine<TicketLockPolicy>;
+extern template class BasicMatchingEngine<SharedMutexPolicy>;
+
+using MatchingEngine = BasicMatchingEngine<DefaultLockPolicy>;
+
+template <typename LockPolicy>
+template <typename ResultSink>
+void BasicMatchingEngine<LockPolicy>::submitBatch(const OrderEvent* begin, const OrderEvent* end,
+                                                  ResultSink& sink) {
+    if (begin == end) return;
+    auto    lock = journalLock();
+    int64_t ts   = nowNs();
+
+    book_.batch([&](typename Book::Batch& batch) {
+        for (const OrderEvent* ev = begin; ev != end; ++ev) {
+            if (ev->kind == EventKind::SUBMIT_LIMIT)
+                batch.prefetchLevel(ev->side == 'B' ? Side::BUY : Side::SELL, ev->price);
+            else if (ev->kind == EventKind::CANCEL)
+                batch.prefetchOrder(ev->order_id);
+        }
+
+        for (const OrderEvent* ev = begin; ev != end; ++ev) {
+            size_t index = static_cast<size_t>(ev - begin);
+            Side   side  = ev->side == 'B' ? Side::BUY : Side::SELL;
+            switch (ev->kind) {
+            case EventKind::SUBMIT_LIMIT: {
+                uint64_t id = nextId();
+                record(Journal::Op::LIMIT, side, id, ev->price, ev->quantity, ts);
+                batch.match(book_.newOrder(id, ts, side, OrderKind::LIMIT,
+                                           ev->price, ev->quantity), sink);
+                sink.onResult(index, id, true);
+                break;
+            }
+            case EventKind::SUBMIT_MARKET: {
+                uint64_t id = nextId();
+                record(Journal::Op::MARKET, side, id, 0, ev->quantity, ts);
+                batch.match(book_.newOrder(id, ts, side, OrderKind::MARKET,
+                                           0LL, ev->quantity), sink);
+                sink.onResult(index, id, true);
+                break;
+            }
+            case EventKind::CANCEL:
+                record(Journal::Op::CANCEL, side, ev->order_id, 0, 0, ts);
+                sink.onResult(index, ev->order_id, batch.cancel(ev->order_id));
+                break;
+            }
+        }
+    });
+}
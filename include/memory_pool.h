@@ -1,44 +1,240 @@
 #pragma once
 
+#include "huge_pages.h"
+#include "thread_slot.h"
+
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
-#include <mutex>
+#include <cstdint>
+#include <memory>
 #include <new>
 #include <utility>
-#include <vector>
+
+// ---------------------------------------------------------------------------
+// MemoryPool<T>
+//
+// Slab allocator for fixed-size objects with per-thread magazines, after
+// J. Bonwick and J. Adams, "Magazines and Vmem", USENIX 2001. No operation
+// takes a lock.
+//
+// Each thread has a cache of two magazines (stacks of up to MAGAZINE_SIZE
+// free blocks), indexed by ThreadSlot::id(). allocate() pops the loaded
+// magazine and deallocate() pushes it, so the common case touches only the
+// thread's own cache line. When the loaded magazine runs empty (or full)
+// and the previous one cannot take over, the thread exchanges a whole
+// magazine with the shared depot: two lock-free stacks, one of full
+// magazines and one of empty ones. A thread that frees blocks another
+// thread allocated therefore hands them back a magazine at a time. A new
+// slab is cut into magazines and pushed to the depot when it has no full
+// one left.
+//
+// Slabs come from the heap by default. With PoolConfig::huge_pages they are
+// mapped from huge pages (see huge_pages.h), each rounded up to whole 2 MiB
+// pages and so holding more than slab_size blocks; with prefault every page
+// is touched when the slab is made. initial_capacity sizes the first slab,
+// so a pool built with the expected working set never grows while trading.
+//
+// Capacity, blocks in use and the in-use high-water mark are atomic
+// counters, so the statistics are O(1) and readable from any thread. The
+// in-use count is one relaxed RMW per operation on a line of its own.
+//
+// Limitations:
+//   - At most ThreadSlot::MAX_THREADS threads may use pools at once.
+//   - Blocks cached by a thread that has exited stay in its cache until
+//     another thread inherits the slot; slabs are freed only with the pool.
+//   - The depot stacks tag their head pointer with a 16-bit ABA counter in
+//     the upper bits, so pointers must fit in 48 bits (x86-64, AArch64).
+// ---------------------------------------------------------------------------
+struct PoolConfig {
+    size_t slab_size        = 1024;    // blocks per slab when the pool grows
+    size_t initial_capacity = 0;       // blocks in the first slab, if more than slab_size
+    bool   huge_pages       = false;   // map slabs on huge pages, falling back to 4k pages
+    bool   prefault         = false;   // touch every page of a slab when it is made
+};
 
 template <typename T>
 class MemoryPool {
+public:
+    static constexpr size_t MAGAZINE_SIZE = 64;
+
 private:
+    // Raw storage for one T. Free blocks are tracked by the magazines that
+    // hold them, so a block carries no link of its own.
     struct Block {
         alignas(T) unsigned char data[sizeof(T)];
-        Block* next;
     };
 
-    Block*              free_list_{nullptr};
-    std::vector<Block*> slabs_;
-    size_t              slab_size_;
-    mutable std::mutex  mutex_;
-
-    // Called only while mutex_ is held.
-    void grow() {
-        Block* slab = new Block[slab_size_];
-        slabs_.push_back(slab);
-        for (size_t i = 0; i < slab_size_; ++i) {
-            slab[i].next = free_list_;
-            free_list_   = &slab[i];
+    struct Magazine {
+        std::atomic<Magazine*> next{nullptr};       // depot link
+        Magazine*              all_next{nullptr};   // every magazine, for the destructor
+        size_t                 count{0};
+        Block*                 blocks[MAGAZINE_SIZE];
+    };
+
+    struct Slab {
+        Block*     blocks;
+        PageRegion region;   // base is null for heap slabs
+        Slab*      next;
+    };
+
+    // Treiber stack of magazines. Magazines are never freed while the pool
+    // lives, so reading a popped head's link is always safe; the tag in the
+    // head word makes a head that was popped and pushed back fail the CAS.
+    class MagazineStack {
+    public:
+        void push(Magazine* m) noexcept {
+            uint64_t head = head_.load(std::memory_order_relaxed);
+            do {
+                m->next.store(ptr(head), std::memory_order_relaxed);
+            } while (!head_.compare_exchange_weak(head, pack(m, tag(head) + 1),
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        }
+
+        Magazine* pop() noexcept {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            while (Magazine* m = ptr(head)) {
+                Magazine* next = m->next.load(std::memory_order_relaxed);
+                if (head_.compare_exchange_weak(head, pack(next, tag(head) + 1),
+                                                std::memory_order_acquire,
+                                                std::memory_order_acquire))
+                    return m;
+            }
+            return nullptr;
+        }
+
+    private:
+        static constexpr uint64_t PTR_MASK = (uint64_t{1} << 48) - 1;
+
+        static Magazine* ptr(uint64_t h) noexcept {
+            return reinterpret_cast<Magazine*>(static_cast<uintptr_t>(h & PTR_MASK));
+        }
+        static uint64_t tag(uint64_t h) noexcept { return h >> 48; }
+        static uint64_t pack(Magazine* m, uint64_t t) noexcept {
+            return (t << 48) | static_cast<uint64_t>(reinterpret_cast<uintptr_t>(m));
+        }
+
+        alignas(64) std::atomic<uint64_t> head_{0};
+    };
+
+    // One thread's magazines; only the slot's owner touches it.
+    struct alignas(64) Cache {
+        Magazine* loaded{nullptr};
+        Magazine* previous{nullptr};
+    };
+
+    static_assert(sizeof(void*) == 8, "MemoryPool packs an ABA tag above 48-bit pointers");
+
+    PoolConfig                      config_;
+    PageBacking                     backing_{PageBacking::HEAP};   // of the first slab
+    std::unique_ptr<Cache[]>        caches_;
+    MagazineStack                   full_;
+    MagazineStack                   empty_;
+    std::atomic<Magazine*>          magazines_{nullptr};   // push-only
+    std::atomic<Slab*>              slabs_{nullptr};       // push-only
+    alignas(64) std::atomic<size_t> capacity_{0};
+    alignas(64) std::atomic<size_t> in_use_{0};
+    std::atomic<size_t>             high_water_{0};
+
+    template <typename Node>
+    static void pushOnly(std::atomic<Node*>& head, Node* n, Node* Node::*link) noexcept {
+        Node* top = head.load(std::memory_order_relaxed);
+        do {
+            n->*link = top;
+        } while (!head.compare_exchange_weak(top, n, std::memory_order_release,
+                                             std::memory_order_relaxed));
+    }
+
+    Magazine* emptyMagazine() {
+        if (Magazine* m = empty_.pop()) return m;
+        Magazine* m = new Magazine();
+        pushOnly(magazines_, m, &Magazine::all_next);
+        return m;
+    }
+
+    // Cuts a new slab of at least blocks blocks into magazines on the full
+    // stack. Capacity is counted first so that it never reads lower than
+    // the blocks in use. prefault maps the slab prefaulted even when the
+    // config does not ask for it.
+    PageBacking grow(size_t blocks, bool prefault = false) {
+        Slab* slab = new Slab{nullptr, {}, nullptr};
+        prefault |= config_.prefault;
+        if (config_.huge_pages || prefault) {
+            slab->region = mapRegion(blocks * sizeof(Block), config_.huge_pages, prefault);
+            slab->blocks = static_cast<Block*>(slab->region.base);
+            blocks       = slab->region.bytes / sizeof(Block);
+        } else {
+            slab->blocks = new Block[blocks];
+        }
+        pushOnly(slabs_, slab, &Slab::next);
+        capacity_.fetch_add(blocks, std::memory_order_relaxed);
+        for (size_t i = 0; i < blocks;) {
+            Magazine* m = emptyMagazine();
+            while (m->count < MAGAZINE_SIZE && i < blocks)
+                m->blocks[m->count++] = &slab->blocks[i++];
+            full_.push(m);
+        }
+        return slab->region.base ? slab->region.backing : PageBacking::HEAP;
+    }
+
+    Cache& cache() {
+        Cache& c = caches_[ThreadSlot::id()];
+        if (!c.loaded) {
+            c.loaded   = emptyMagazine();
+            c.previous = emptyMagazine();
+        }
+        return c;
+    }
+
+    // loaded is empty: swap in previous if it has blocks, else trade the
+    // empty previous for a full magazine from the depot.
+    void refill(Cache& c) {
+        if (c.previous->count > 0) {
+            std::swap(c.loaded, c.previous);
+            return;
         }
+        Magazine* full;
+        while (!(full = full_.pop())) grow(config_.slab_size);
+        empty_.push(c.previous);
+        c.previous = c.loaded;
+        c.loaded   = full;
+    }
+
+    // loaded is full: swap in previous if it has room, else hand the full
+    // previous to the depot and take an empty one.
+    void spill(Cache& c) {
+        if (c.previous->count < MAGAZINE_SIZE) {
+            std::swap(c.loaded, c.previous);
+            return;
+        }
+        full_.push(c.previous);
+        c.previous = c.loaded;
+        c.loaded   = emptyMagazine();
     }
 
 public:
-    explicit MemoryPool(size_t slab_size = 1000)
-        : slab_size_(slab_size) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        grow();
+    explicit MemoryPool(size_t slab_size = 1000) : MemoryPool(PoolConfig{slab_size}) {}
+
+    explicit MemoryPool(const PoolConfig& config)
+        : config_(config),
+          caches_(std::make_unique<Cache[]>(ThreadSlot::MAX_THREADS)) {
+        if (config_.slab_size == 0) config_.slab_size = 1;
+        backing_ = grow(std::max(config_.slab_size, config_.initial_capacity));
     }
 
     ~MemoryPool() {
-        for (Block* slab : slabs_) {
-            delete[] slab;
+        for (Magazine* m = magazines_.load(std::memory_order_relaxed); m;) {
+            Magazine* next = m->all_next;
+            delete m;
+            m = next;
+        }
+        for (Slab* s = slabs_.load(std::memory_order_relaxed); s;) {
+            Slab* next = s->next;
+            if (s->region.base) unmapRegion(s->region);
+            else                delete[] s->blocks;
+            delete s;
+            s = next;
         }
     }
 
@@ -47,43 +243,45 @@ public:
 
     template <typename... Args>
     T* allocate(Args&&... args) {
-        Block* block;
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (!free_list_) {
-                grow();
-            }
-            block      = free_list_;
-            free_list_ = block->next;
-        }
-        // Placement-new outside the lock: no other thread can touch this block
-        // until it is returned to the free list via deallocate().
+        Cache& c = cache();
+        if (c.loaded->count == 0) refill(c);
+        Block* block = c.loaded->blocks[--c.loaded->count];
+
+        size_t used = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        size_t high = high_water_.load(std::memory_order_relaxed);
+        while (used > high && !high_water_.compare_exchange_weak(high, used,
+                                                                 std::memory_order_relaxed)) {}
         return ::new (block->data) T(std::forward<Args>(args)...);
     }
 
     void deallocate(T* ptr) {
         ptr->~T();
-        // Block::data is the first member of Block (offset 0, standard-layout),
-        // so the address of the T object equals the address of its enclosing Block.
+        // The T object sits at offset 0 of its Block, so the two addresses
+        // are equal.
         Block* block = reinterpret_cast<Block*>(ptr);
-        std::lock_guard<std::mutex> lock(mutex_);
-        block->next = free_list_;
-        free_list_  = block;
+        Cache& c     = cache();
+        if (c.loaded->count == MAGAZINE_SIZE) spill(c);
+        c.loaded->blocks[c.loaded->count++] = block;
+        in_use_.fetch_sub(1, std::memory_order_relaxed);
     }
 
-    size_t freeCount() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        size_t count = 0;
-        for (Block* b = free_list_; b; b = b->next) {
-            ++count;
-        }
-        return count;
+    // Adds one slab, if needed, so that at least blocks blocks are free.
+    // For bulk loads of a known size, which would otherwise grow the pool a
+    // slab_size at a time. The blocks are about to be written, so the slab
+    // is always prefaulted: one populating mmap instead of a fault per page.
+    void reserve(size_t blocks) {
+        size_t free = freeCount();
+        if (free < blocks) grow(blocks - free, true);
     }
 
-    size_t totalCapacity() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return slabs_.size() * slab_size_;
-    }
+    // O(1) statistics. Exact when no other thread is allocating or freeing.
+    size_t totalCapacity() const { return capacity_.load(std::memory_order_relaxed); }
+    size_t inUse()         const { return in_use_.load(std::memory_order_relaxed); }
+    size_t highWater()     const { return high_water_.load(std::memory_order_relaxed); }
+    size_t freeCount()     const { return totalCapacity() - inUse(); }
+
+    // What the first slab (initial_capacity) landed on.
+    PageBacking backing() const { return backing_; }
 };
 
 template <typename T>
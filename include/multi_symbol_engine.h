@@ -0,0 +1,145 @@
+#pragma once
+
+#include "matching_engine.h"
+#include "order_event.h"
+#include "ring_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct MultiSymbolConfig {
+    size_t     workers        = 1;
+    size_t     queue_capacity = size_t{1} << 16;   // events per worker, rounded to a power of two
+    bool       pin_workers    = true;   // worker w runs on core (first_core + w) % cores
+    int        first_core     = 0;
+    bool       numa_local     = true;   // pinned workers allocate on their own node
+    TapeConfig tape{};                  // trade history of every book; spills to spill_dir/<symbol>
+    PoolConfig pool{};                  // order pool of every book
+};
+
+// ---------------------------------------------------------------------------
+// MultiSymbolEngine
+//
+// One single-writer matching engine per instrument, sharded over a fixed set
+// of worker threads. Symbols are registered up front; symbol s belongs to
+// worker s % workers for the engine's lifetime, so every book is touched by
+// exactly one thread and books on different workers share no locks. Each
+// worker builds its own queue and books on its own thread (after pinning,
+// when enabled), so the ring, pools and ladders are first touched by the
+// core that matches them and, with numa_local, allocated on its NUMA node
+// (see thread_placement.h). Each worker keeps its queue and counters on
+// cache lines of its own.
+//
+// Any thread may submit(); the event is routed by its symbol_id to the
+// owning worker's bounded MpscRing and matched there in arrival order.
+// Order ids are assigned per symbol, and a CANCEL's order_id is an id in
+// that symbol's book. With tape.spill_dir set, each book spills its trade
+// history to a subdirectory named after its symbol, created by addSymbol(),
+// since a spill directory must belong to one tape.
+//
+// Lifecycle:
+//   1. Construct, addSymbol() every instrument.
+//   2. start() — spawns the workers and returns once every book exists.
+//      If a worker cannot build its queue or books, start() stops the
+//      others and rethrows the worker's exception.
+//   3. Producers call submit().
+//   4. stop() — drains every queue and joins the workers.
+//   5. Inspect book() / eventsProcessed().
+// top() may be read from any thread while running (see BookTop).
+// ---------------------------------------------------------------------------
+class MultiSymbolEngine {
+public:
+    using Engine = BasicMatchingEngine<SingleWriterPolicy>;
+
+    explicit MultiSymbolEngine(const MultiSymbolConfig& config = {});
+    ~MultiSymbolEngine();
+
+    MultiSymbolEngine(const MultiSymbolEngine&)            = delete;
+    MultiSymbolEngine& operator=(const MultiSymbolEngine&) = delete;
+
+    // Registers an instrument and returns its symbol id (ids are dense, from
+    // 0). Registering an existing name returns its id. Only valid before
+    // start(); throws std::logic_error afterwards. With tape.spill_dir set,
+    // creates the symbol's spill subdirectory and throws
+    // std::filesystem::filesystem_error if it cannot.
+    uint32_t addSymbol(const std::string& name, const LadderConfig& ladder = {});
+
+    // Symbol id for name, or UNKNOWN_SYMBOL.
+    static constexpr uint32_t UNKNOWN_SYMBOL = UINT32_MAX;
+    uint32_t symbolId(const std::string& name) const;
+
+    const std::string& symbolName(uint32_t symbol) const { return symbols_[symbol].name; }
+    size_t             symbolCount()               const { return symbols_.size(); }
+    size_t             workerCount()               const { return workers_.size(); }
+    size_t             workerOf(uint32_t symbol)   const { return symbol % workers_.size(); }
+
+    // Spawns the workers once; later calls do nothing. Rethrows the first
+    // exception a worker hit building its queue or books, after joining
+    // every worker; the engine cannot be started again then.
+    void start();
+
+    // Thread-safe. Returns false, dropping the event, if its symbol_id is
+    // not registered or the engine is not running. An event accepted with
+    // true is matched before stop() returns. submit() spins while the
+    // worker's queue is full; trySubmit() returns false instead, so the
+    // caller can apply backpressure.
+    bool submit(const OrderEvent& ev);
+    bool trySubmit(const OrderEvent& ev);
+
+    // Refuses new events, waits for submits already past the check to
+    // enqueue, then enqueues a stop marker on every worker, waits for each
+    // to drain its queue, and joins them. Idempotent.
+    void stop();
+
+    // Valid from start() on. The book is owned by its worker: outside it,
+    // only top() may be read before stop().
+    const Engine::Book& book(uint32_t symbol) const;
+    BookTop             top(uint32_t symbol)  const { return book(symbol).top(); }
+
+    uint64_t eventsProcessed() const;
+    uint64_t eventsProcessed(size_t worker) const {
+        return workers_[worker]->processed.load(std::memory_order_relaxed);
+    }
+    bool     workerPinned(size_t worker) const { return workers_[worker]->pinned; }
+    int      workerNode(size_t worker)   const { return workers_[worker]->node; }   // -1: unknown
+
+    void printStats() const;
+
+private:
+    static constexpr uint8_t STOP = 255;   // EventKind value used as stop marker
+
+    struct Symbol {
+        std::string  name;
+        LadderConfig ladder;
+        TapeConfig   tape;      // config_.tape with the symbol's own spill_dir
+        size_t       slot;      // index into its worker's engines
+    };
+
+    struct alignas(64) Worker {
+        std::unique_ptr<MpscRing<OrderEvent>> queue;   // built by the worker
+        std::vector<std::unique_ptr<Engine>>  engines;   // by Symbol::slot
+        std::vector<uint32_t>                 symbols;   // slot -> symbol id
+        std::thread                           thread;
+        bool                                  pinned{false};
+        int                                   node{-1};
+        std::exception_ptr                    failed;   // start-up error, read after ready
+        alignas(64) std::atomic<uint64_t>     processed{0};
+    };
+
+    MultiSymbolConfig                         config_;
+    std::vector<Symbol>                       symbols_;
+    std::unordered_map<std::string, uint32_t> by_name_;
+    std::vector<std::unique_ptr<Worker>>      workers_;
+    std::atomic<bool>                         running_{false};
+    alignas(64) std::atomic<uint64_t>         submitting_{0};   // submits between check and enqueue
+    bool                                      started_{false};
+
+    void enqueueStop();
+    void workerLoop(size_t index, std::atomic<size_t>& ready);
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 constexpr int64_t PRICE_SCALE = 10000;
@@ -8,66 +9,133 @@ enum class Side        : uint8_t { BUY, SELL };
 enum class OrderKind   : uint8_t { LIMIT, MARKET, ICEBERG, STOP_LOSS };
 enum class OrderStatus : uint8_t { ACTIVE, PARTIAL, FILLED, CANCELLED };
 
-class Order {
+// Iceberg and stop-loss attributes. Only orders of those kinds carry one,
+// allocated from a process-wide pool, so plain limit and market orders stay
+// a single cache line. An iceberg's hidden quantity is leaves - display_qty.
+struct alignas(32) OrderExt {
+    uint64_t display_qty{0};
+    uint64_t orig_display_qty{0};
+    int64_t  trigger_price{0};
+    bool     triggered{false};
+};
+
+// One cache line. Everything matching touches is inline; the extension is
+// only followed for icebergs and stops. Side, kind and status live in the
+// low bits of the extension pointer, which OrderExt's alignment keeps free.
+class alignas(64) Order {
 public:
     // Limit / Market
-    Order(uint64_t id, int64_t timestamp_us, Side side, OrderKind kind,
+    Order(uint64_t id, int64_t timestamp_ns, Side side, OrderKind kind,
           int64_t price, uint64_t qty);
 
     // Iceberg (display_qty < total_qty hides the remainder)
-    Order(uint64_t id, int64_t timestamp_us, Side side,
+    Order(uint64_t id, int64_t timestamp_ns, Side side,
           int64_t price, uint64_t total_qty, uint64_t display_qty);
 
     // Stop-loss (trigger_price activates a limit order at limit_price)
-    Order(uint64_t id, int64_t timestamp_us, Side side,
+    Order(uint64_t id, int64_t timestamp_ns, Side side,
           int64_t trigger_price, int64_t limit_price, uint64_t qty);
 
+    // Exact saved state, for restoring a book snapshot: kind, status, open
+    // quantity and, for icebergs and stops, the extension as it was.
+    Order(uint64_t id, int64_t timestamp_ns, Side side, OrderKind kind, OrderStatus status,
+          int64_t price, uint64_t qty, uint64_t leaves, const OrderExt& ext);
+
+    // Copies own a copy of the extension, so snapshots stay valid after the
+    // original is released.
+    Order(const Order& o);
+    Order& operator=(const Order& o);
+    ~Order();
+
     uint64_t    id()        const noexcept { return id_; }
-    int64_t     timestamp() const noexcept { return timestamp_us_; }
-    Side        side()      const noexcept { return side_; }
-    OrderKind   kind()      const noexcept { return kind_; }
+    int64_t     timestamp() const noexcept { return timestamp_ns_; }
+    Side        side()      const noexcept { return static_cast<Side>(bits_ & SIDE_MASK); }
+    OrderKind   kind()      const noexcept {
+        return static_cast<OrderKind>((bits_ & KIND_MASK) >> KIND_SHIFT);
+    }
     int64_t     price()     const noexcept { return price_; }
     uint64_t    quantity()  const noexcept { return quantity_; }
     uint64_t    leaves()    const noexcept { return leaves_qty_; }
-    OrderStatus status()    const noexcept { return status_; }
+    OrderStatus status()    const noexcept {
+        return static_cast<OrderStatus>((bits_ & STATUS_MASK) >> STATUS_SHIFT);
+    }
 
     bool isFilled()   const noexcept { return leaves_qty_ == 0; }
-    bool isMarket()   const noexcept { return kind_ == OrderKind::MARKET; }
-    bool isIceberg()  const noexcept { return kind_ == OrderKind::ICEBERG; }
-    bool isStopLoss() const noexcept { return kind_ == OrderKind::STOP_LOSS; }
+    bool isMarket()   const noexcept { return kind() == OrderKind::MARKET; }
+    bool isIceberg()  const noexcept { return kind() == OrderKind::ICEBERG; }
+    bool isStopLoss() const noexcept { return kind() == OrderKind::STOP_LOSS; }
     bool isActive()   const noexcept {
-        return status_ == OrderStatus::ACTIVE || status_ == OrderStatus::PARTIAL;
+        OrderStatus s = status();
+        return s == OrderStatus::ACTIVE || s == OrderStatus::PARTIAL;
     }
 
     // Iceberg helpers
-    uint64_t visibleQty() const noexcept;
+    uint64_t visibleQty() const noexcept {
+        return isIceberg() ? ext()->display_qty : leaves_qty_;
+    }
+    uint64_t hiddenQty()  const noexcept { return leaves_qty_ - visibleQty(); }
     void     replenish()  noexcept;
 
+    // Extension fields, or all zeros for a plain limit or market order.
+    OrderExt extension() const noexcept { return ext() ? *ext() : OrderExt{}; }
+
+    // Extensions held by live orders across every book.
+    static size_t extensionsInUse() noexcept;
+
     // Stop-loss helpers
-    int64_t triggerPrice() const noexcept { return trigger_price_; }
-    bool    isTriggered()  const noexcept { return triggered_; }
-    void    trigger()      noexcept       { triggered_ = true; }
+    int64_t triggerPrice() const noexcept { return isStopLoss() ? ext()->trigger_price : 0; }
+    bool    isTriggered()  const noexcept { return isStopLoss() && ext()->triggered; }
+    void    trigger()      noexcept       { if (isStopLoss()) ext()->triggered = true; }
+
+    // Amend helpers. reduceTo() shrinks the open quantity (0 < leaves <=
+    // leaves()), taking an iceberg's reserve before its display lot.
+    // reprice() restarts the order at a new price and open quantity with a
+    // fresh display lot; the caller must have taken it out of its level.
+    void reduceTo(uint64_t leaves) noexcept;
+    void reprice(int64_t price, uint64_t qty, int64_t timestamp_ns) noexcept;
 
     void fill(uint64_t qty) noexcept;
     void cancel() noexcept;
+
+    // fill() for an order known not to be an iceberg; qty <= leaves().
+    void fillPlain(uint64_t qty) noexcept {
+        leaves_qty_ -= qty;
+        setStatus(leaves_qty_ ? OrderStatus::PARTIAL : OrderStatus::FILLED);
+    }
     void print() const;
 
 private:
-    uint64_t    id_;
-    int64_t     timestamp_us_;
-    Side        side_;
-    OrderKind   kind_;
-    int64_t     price_;          // limit_price for stop-loss orders
-    uint64_t    quantity_;
-    uint64_t    leaves_qty_;
-    OrderStatus status_;
-
-    // Iceberg fields (only used when kind_ == ICEBERG)
-    uint64_t display_qty_{0};
-    uint64_t hidden_qty_{0};
-    uint64_t orig_display_qty_{0};
-
-    // Stop-loss fields (only used when kind_ == STOP_LOSS)
-    int64_t  trigger_price_{0};
-    bool     triggered_{false};
+    friend class OrderQueue;
+
+    static constexpr uintptr_t SIDE_MASK    = 0x1;
+    static constexpr uintptr_t KIND_SHIFT   = 1;
+    static constexpr uintptr_t KIND_MASK    = 0x3 << KIND_SHIFT;
+    static constexpr uintptr_t STATUS_SHIFT = 3;
+    static constexpr uintptr_t STATUS_MASK  = 0x3 << STATUS_SHIFT;
+    static constexpr uintptr_t FLAG_MASK    = SIDE_MASK | KIND_MASK | STATUS_MASK;
+    static_assert(alignof(OrderExt) > FLAG_MASK, "OrderExt alignment must cover the flag bits");
+
+    uint64_t  id_;
+    int64_t   timestamp_ns_;
+    int64_t   price_;          // limit_price for stop-loss orders
+    uint64_t  quantity_;
+    uint64_t  leaves_qty_;
+
+    // Intrusive price-level queue links (owned by OrderQueue)
+    Order*    prev_{nullptr};
+    Order*    next_{nullptr};
+
+    uintptr_t bits_;           // OrderExt* | status | kind | side
+
+    OrderExt* ext() const noexcept { return reinterpret_cast<OrderExt*>(bits_ & ~FLAG_MASK); }
+    void      setStatus(OrderStatus s) noexcept {
+        bits_ = (bits_ & ~STATUS_MASK) | (static_cast<uintptr_t>(s) << STATUS_SHIFT);
+    }
+    void      init(Side side, OrderKind kind, OrderExt* ext) noexcept {
+        bits_ = reinterpret_cast<uintptr_t>(ext)
+              | (static_cast<uintptr_t>(kind) << KIND_SHIFT)
+              | static_cast<uintptr_t>(side);
+    }
 };
+
+static_assert(sizeof(Order) == 64, "Order must stay one cache line");
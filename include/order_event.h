@@ -0,0 +1,32 @@
+#pragma once
+
+#include "clock.h"
+#include <cstdint>
+
+enum class EventKind : uint8_t { SUBMIT_LIMIT, SUBMIT_MARKET, CANCEL };
+
+// One order-entry instruction, as fed to MatchingEngine::submitBatch,
+// MultiSymbolEngine and the benchmark's concurrent engine. For submits,
+// order_id is the caller's own reference; for CANCEL it names the order to
+// cancel. symbol_id selects the book in a MultiSymbolEngine and is ignored
+// by single-book engines; it sits in what was padding, so the event is
+// still 48 bytes.
+struct OrderEvent {
+    EventKind kind;
+    uint32_t  symbol_id;
+    uint64_t  order_id;
+    char      side;       // 'B' or 'S'
+    int64_t   price;      // scaled integer (price * 10000)
+    uint64_t  quantity;
+    int64_t   timestamp_ns;
+
+    OrderEvent()
+        : kind(EventKind::SUBMIT_LIMIT), symbol_id(0), order_id(0),
+          side('B'), price(0), quantity(0), timestamp_ns(0) {}
+
+    OrderEvent(EventKind k, uint64_t oid, char s, int64_t p, uint64_t q, uint32_t sym = 0)
+        : kind(k), symbol_id(sym), order_id(oid), side(s), price(p), quantity(q) {
+        timestamp_ns = EngineClock::now();
+    }
+};
+static_assert(sizeof(OrderEvent) == 48, "OrderEvent grew past 48 bytes");
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Order;
+
+// ---------------------------------------------------------------------------
+// OrderIndex
+//
+// Order-id → Order* lookup tuned for the engine's dense, monotonically
+// increasing ids. An id splits into a page number (id >> PAGE_BITS) and a
+// slot; pages are flat pointer arrays reached through a directory, so a
+// lookup is two dependent loads with no hashing or probing.
+//
+// A page is allocated the first time an id lands on it and parked on a spare
+// list once its last order leaves, then reused for the next page that needs
+// one. Steady-state inserts therefore never allocate and there is nothing to
+// rehash. Ids past the direct range (client-chosen or sparse ids) go to a
+// hash-map fallback.
+// ---------------------------------------------------------------------------
+class OrderIndex {
+public:
+    static constexpr unsigned PAGE_BITS = 10;
+    static constexpr size_t   PAGE_SIZE = size_t{1} << PAGE_BITS;
+    static constexpr size_t   MAX_PAGES = size_t{1} << 24;   // direct range: 2^34 ids
+
+    OrderIndex() { dir_.reserve(4096); }
+
+    ~OrderIndex() {
+        for (Page* p : dir_)   delete p;
+        for (Page* p : spare_) delete p;
+    }
+
+    OrderIndex(const OrderIndex&)            = delete;
+    OrderIndex& operator=(const OrderIndex&) = delete;
+
+    size_t size()  const noexcept { return size_; }
+    bool   empty() const noexcept { return size_ == 0; }
+
+    // Pages currently backing the direct range, live or spare.
+    size_t pageCount() const noexcept { return live_pages_ + spare_.size(); }
+
+    Order* find(uint64_t id) const noexcept {
+        uint64_t p = id >> PAGE_BITS;
+        if (p < dir_.size()) {
+            const Page* page = dir_[p];
+            return page ? page->slots[id & (PAGE_SIZE - 1)] : nullptr;
+        }
+        if (p < MAX_PAGES) return nullptr;
+        auto it = overflow_.find(id);
+        return it == overflow_.end() ? nullptr : it->second;
+    }
+
+    // Inserts or replaces the entry for id. order must be non-null.
+    void insert(uint64_t id, Order* order) {
+        uint64_t p = id >> PAGE_BITS;
+        if (p >= MAX_PAGES) {
+            auto [it, inserted] = overflow_.try_emplace(id, order);
+            if (!inserted) it->second = order;
+            else           ++size_;
+            return;
+        }
+        if (p >= dir_.size()) dir_.resize(p + 1, nullptr);
+        Page*& page = dir_[p];
+        if (!page) page = takePage();
+        Order*& slot = page->slots[id & (PAGE_SIZE - 1)];
+        if (!slot) { ++page->used; ++size_; }
+        slot = order;
+    }
+
+    bool erase(uint64_t id) {
+        uint64_t p = id >> PAGE_BITS;
+        if (p >= MAX_PAGES) {
+            if (overflow_.erase(id) == 0) return false;
+            --size_;
+            return true;
+        }
+        if (p >= dir_.size() || !dir_[p]) return false;
+        Page*&  page = dir_[p];
+        Order*& slot = page->slots[id & (PAGE_SIZE - 1)];
+        if (!slot) return false;
+        slot = nullptr;
+        --size_;
+        if (--page->used == 0) {
+            spare_.push_back(page);   // every slot is null again — reusable as is
+            page = nullptr;
+            --live_pages_;
+        }
+        return true;
+    }
+
+private:
+    struct Page {
+        Order* slots[PAGE_SIZE]{};
+        size_t used{0};
+    };
+
+    std::vector<Page*>                   dir_;
+    std::vector<Page*>                   spare_;
+    std::unordered_map<uint64_t, Order*> overflow_;
+    size_t                               size_{0};
+    size_t                               live_pages_{0};
+
+    Page* takePage() {
+        ++live_pages_;
+        if (spare_.empty()) return new Page();
+        Page* p = spare_.back();
+        spare_.pop_back();
+        return p;
+    }
+};
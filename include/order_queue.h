@@ -0,0 +1,60 @@
+#pragma once
+
+#include "order.h"
+#include <cstddef>
+
+// ---------------------------------------------------------------------------
+// OrderQueue
+//
+// Intrusive doubly linked FIFO of resting orders at one price level. The
+// prev/next links live inside Order itself, so push_back, pop_front and
+// erase of an arbitrary order are all O(1) and never allocate. An order may
+// sit in at most one queue at a time and must be unlinked before it is
+// destroyed.
+// ---------------------------------------------------------------------------
+class OrderQueue {
+public:
+    class const_iterator {
+    public:
+        explicit const_iterator(const Order* o) : cur_(o) {}
+        const Order*    operator*()  const noexcept { return cur_; }
+        const Order*    operator->() const noexcept { return cur_; }
+        const_iterator& operator++() noexcept { cur_ = cur_->next_; return *this; }
+        bool operator==(const const_iterator& o) const noexcept { return cur_ == o.cur_; }
+        bool operator!=(const const_iterator& o) const noexcept { return cur_ != o.cur_; }
+    private:
+        const Order* cur_;
+    };
+
+    bool   empty() const noexcept { return head_ == nullptr; }
+    size_t size()  const noexcept { return size_; }
+    Order* front() const noexcept { return head_; }
+
+    const_iterator begin() const noexcept { return const_iterator(head_); }
+    const_iterator end()   const noexcept { return const_iterator(nullptr); }
+
+    void push_back(Order* o) noexcept {
+        o->prev_ = tail_;
+        o->next_ = nullptr;
+        if (tail_) tail_->next_ = o;
+        else       head_        = o;
+        tail_ = o;
+        ++size_;
+    }
+
+    void pop_front() noexcept { erase(head_); }
+
+    void erase(Order* o) noexcept {
+        if (o->prev_) o->prev_->next_ = o->next_;
+        else          head_           = o->next_;
+        if (o->next_) o->next_->prev_ = o->prev_;
+        else          tail_           = o->prev_;
+        o->prev_ = o->next_ = nullptr;
+        --size_;
+    }
+
+private:
+    Order* head_{nullptr};
+    Order* tail_{nullptr};
+    size_t size_{0};
+};
@@ -1,68 +1,444 @@
 #pragma once
 
+#include "lock_policy.h"
+#include "memory_pool.h"
 #include "order.h"
-#include <deque>
-#include <functional>
-#include <map>
-#include <memory>
-#include <shared_mutex>
-#include <unordered_map>
+#include "order_index.h"
+#include "order_queue.h"
+#include "price_ladder.h"
+#include "seqlock.h"
+#include "snapshot.h"
+#include "trade_sink.h"
+#include "trade_tape.h"
+#include <algorithm>
+#include <mutex>
+#include <optional>
 #include <vector>
 
-struct Trade {
-    uint64_t trade_id;
-    uint64_t buy_order_id;
-    uint64_t sell_order_id;
+// One row of an L2 depth snapshot.
+struct DepthLevel {
     int64_t  price;
-    uint64_t quantity;
-    int64_t  timestamp_us;
+    uint64_t visible_qty;
+    uint64_t hidden_qty;
+    uint64_t order_count;
 };
 
-using OrderPtr = std::shared_ptr<Order>;
+// Top of book as published to lock-free readers: best price, visible size
+// and order count per side, plus level counts. An empty side reads as all
+// zeros. sequence counts publications and changes whenever any other field
+// does, so a poller can skip records it has already seen.
+struct BookTop {
+    int64_t  bid_price;
+    int64_t  ask_price;
+    uint64_t bid_qty;
+    uint64_t ask_qty;
+    uint32_t bid_orders;
+    uint32_t ask_orders;
+    uint32_t bid_levels;
+    uint32_t ask_levels;
+    uint64_t sequence;
+};
+
+// One price level: resting orders in time priority, plus running totals kept
+// in step with every add, fill, replenish and removal so depth queries never
+// walk the queue. The queue links raw Order pointers into the book's pool and
+// tracks its own order count. The iceberg count tells the matching kernel
+// whether the level needs the display-lot path at all.
+struct PriceLevel {
+    int64_t    price{0};
+    uint64_t   visible_qty{0};   // sum of visibleQty() over orders
+    uint64_t   hidden_qty{0};    // sum of iceberg reserve over orders
+    uint32_t   icebergs{0};      // icebergs among orders
+    OrderQueue orders;
+
+    void push_back(Order* o) noexcept {
+        orders.push_back(o);
+        visible_qty += o->visibleQty();
+        hidden_qty  += o->hiddenQty();
+        icebergs    += o->isIceberg();
+    }
+
+    void erase(Order* o) noexcept {
+        orders.erase(o);
+        visible_qty -= o->visibleQty();
+        hidden_qty  -= o->hiddenQty();
+        icebergs    -= o->isIceberg();
+    }
+
+    // qty must not exceed o's visible quantity.
+    void fill(Order* o, uint64_t qty) noexcept {
+        o->fill(qty);
+        visible_qty -= qty;
+    }
+
+    // fill() for a level with no icebergs.
+    void fillPlain(Order* o, uint64_t qty) noexcept {
+        o->fillPlain(qty);
+        visible_qty -= qty;
+    }
 
-class OrderBook {
+    // Same-price size reduction; o keeps its queue position.
+    void reduce(Order* o, uint64_t leaves) noexcept {
+        uint64_t vis = o->visibleQty(), hid = o->hiddenQty();
+        o->reduceTo(leaves);
+        visible_qty -= vis - o->visibleQty();
+        hidden_qty  -= hid - o->hiddenQty();
+    }
+
+    void replenish(Order* o) noexcept {
+        uint64_t before = o->visibleQty();
+        o->replenish();
+        uint64_t lot = o->visibleQty() - before;
+        visible_qty += lot;
+        hidden_qty  -= lot;
+    }
+};
+
+// Pending stop orders sharing one trigger price, in arrival order.
+struct StopLevel {
+    int64_t    price{0};   // trigger price
+    OrderQueue orders;
+};
+
+// ---------------------------------------------------------------------------
+// BasicOrderBook<LockPolicy>
+//
+// The limit order book. LockPolicy (lock_policy.h) picks the mutex every
+// mutating call and every locked accessor takes; OrderBook is the build's
+// default. lob_core carries an instantiation for each policy.
+// ---------------------------------------------------------------------------
+template <typename LockPolicy>
+class BasicOrderBook {
 public:
-    OrderBook() = default;
-    OrderBook(const OrderBook&)            = delete;
-    OrderBook& operator=(const OrderBook&) = delete;
+    // The ladder config selects the dense tick-indexed band for both sides;
+    // the default keeps every level in the sparse ordered map. The pool
+    // config sizes the order pool and picks its page backing. The tape
+    // config sizes the trade-history ring and optional spill directory.
+    explicit BasicOrderBook(const LadderConfig& ladder = {}, const PoolConfig& pool = {},
+                            const TapeConfig& tape = {});
+    // Destroys every order still resting or waiting, so their extensions
+    // go back to the shared pool along with the book's own slabs.
+    ~BasicOrderBook();
+    BasicOrderBook(const BasicOrderBook&)            = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+
+    // Constructs an order in the book's pool. The returned pointer must be
+    // handed to match(), which takes ownership.
+    template <typename... Args>
+    Order* newOrder(Args&&... args) {
+        return pool_.allocate(std::forward<Args>(args)...);
+    }
 
-    // Returns trades generated. Stop-loss orders are held until triggered.
-    std::vector<Trade> match(OrderPtr order);
+    // Takes ownership of an order obtained from newOrder(). The book returns
+    // it to the pool once it is filled, cancelled, or (for market orders)
+    // done matching. Every trade and order-state change, including those of
+    // stops triggered along the way, is reported to sink as it happens.
+    // Stop-loss orders are held until triggered.
+    template <typename Sink>
+    void match(Order* order, Sink& sink);
 
+    // Convenience overload: collects the trades into a fresh vector.
+    std::vector<Trade> match(Order* order);
+
+    // Handle passed to batch(). The book lock is held for its lifetime, so
+    // its match() and cancel() skip the per-call lock of their public
+    // counterparts and otherwise behave identically.
+    class Batch {
+    public:
+        template <typename Sink>
+        void match(Order* order, Sink& sink) { book_.matchLocked(order, sink); }
+        bool cancel(uint64_t order_id) { return book_.cancelLocked(order_id); }
+
+        // Cache hints for events about to be processed: the level an order
+        // at price would rest on, and a resting order about to be cancelled.
+        void prefetchLevel(Side side, int64_t price) const noexcept {
+            (side == Side::BUY ? book_.bids_ : book_.asks_).prefetch(price);
+        }
+        void prefetchOrder(uint64_t order_id) const noexcept {
+            if (const Order* o = book_.active_.find(order_id)) __builtin_prefetch(o, 1);
+        }
+
+    private:
+        friend class BasicOrderBook;
+        explicit Batch(BasicOrderBook& book) : book_(book) {}
+        BasicOrderBook& book_;
+    };
+
+    // Runs fn(Batch&) under a single acquisition of the book lock. The top
+    // of book is published once, when fn returns or throws, so events the
+    // batch processed before an exception are never hidden from readers.
+    template <typename Fn>
+    void batch(Fn&& fn) {
+        std::unique_lock lock(mutex_);
+        Batch b(*this);
+        try {
+            fn(b);
+        } catch (...) {
+            publishTop();
+            throw;
+        }
+        publishTop();
+    }
+
+    // Cancels a resting order or a pending (untriggered) stop.
     bool cancelOrder(uint64_t order_id);
+
+    // Sets a resting order's price and open quantity (0 cancels it). A size
+    // reduction at the same price is amended in place and keeps time
+    // priority; any other change moves the same pool object to the back of
+    // its new level with new_timestamp_ns. Kind, iceberg display size and
+    // stop fields are kept. A pending stop has its limit price and quantity
+    // amended in place; its trigger and place in the trigger queue stay.
     bool modifyOrder(uint64_t order_id, int64_t new_price,
-                     uint64_t new_qty, int64_t new_timestamp_us);
+                     uint64_t new_qty, int64_t new_timestamp_ns);
 
+    // Latest top of book. Every call that changes the book republishes it
+    // through a seqlock before releasing the book lock, so this never takes
+    // the lock and never blocks the matching thread; it only retries while
+    // a publication is in flight.
+    BookTop top() const noexcept { return top_.load(); }
+
+    // Read from top(), without the book lock.
     int64_t bestBid()     const;
     int64_t bestAsk()     const;
     int64_t spread()      const;
     size_t  bidLevels()   const;
     size_t  askLevels()   const;
+
     size_t  activeOrders() const;
+    size_t  pendingStops() const;
+
+    // Copy of a resting order's or pending stop's current state, taken under the book lock.
+    // Safe to hold across later mutations, unlike a pointer into the pool.
+    std::optional<Order> findOrder(uint64_t order_id) const;
+
+    // Writes up to `levels` rows for one side, best price first, into the
+    // caller's buffer and returns how many were written. Reads the cached
+    // level totals only: no allocation, no iostream, O(levels).
+    size_t getDepth(Side side, size_t levels, DepthLevel* out) const;
+
+    // Writes the whole book to out (snapshot.h): header with next_trade_id
+    // and the counts filled in, every resting order level by level best
+    // first in time priority, then every pending stop in firing order. The
+    // caller supplies journal_sequence and next_order_id and commits out.
+    // Holds the book lock shared while it writes.
+    void saveState(SnapshotHeader header, SnapshotWriter& out) const;
+
+    // Rebuilds an empty book from a snapshot without matching: each record
+    // is appended to its level in file order, so priority comes back as
+    // saved. Returns the snapshot's header. Throws std::system_error with
+    // EBUSY if the book is not empty, and with EINVAL on a record the book
+    // could not have written (a checksummed file from another build, say),
+    // leaving the book partly loaded.
+    SnapshotHeader loadState(SnapshotReader& in);
 
-    const std::vector<Trade>& tradeHistory() const { return trades_; }
+    const MemoryPool<Order>& pool() const { return pool_; }
+    // Recent trades in memory plus whatever has spilled to disk. Like the
+    // other accessors returning references, read it while the book is idle.
+    const TradeTape& tradeHistory() const { return tape_; }
 
     void printBook(int levels = 5)  const;
     void printDepth(int levels = 5) const;
     void printTrades()              const;
 
 private:
-    using Level = std::deque<OrderPtr>;
-
-    mutable std::shared_mutex                       mutex_;
-    std::map<int64_t, Level, std::greater<int64_t>> bids_;
-    std::map<int64_t, Level>                        asks_;
-    std::unordered_map<uint64_t, OrderPtr>          active_;
-    std::vector<OrderPtr>                           pending_stops_;
-    std::vector<OrderPtr>                           triggered_stops_;   // staged for matching
-    std::vector<Trade>                              trades_;
+    using Level = PriceLevel;
+
+    mutable typename LockPolicy::Mutex              mutex_;
+    MemoryPool<Order>                               pool_;   // owns every order below
+    PriceLadder<Level>                              bids_;   // best = highest()
+    PriceLadder<Level>                              asks_;   // best = lowest()
+    OrderIndex                                      active_;
+    PriceLadder<StopLevel>                          sell_stops_;   // fire from highest() down
+    PriceLadder<StopLevel>                          buy_stops_;    // fire from lowest() up
+    OrderIndex                                      stop_index_;   // pending stops by id
+    std::vector<Order*>                             triggered_stops_;   // staged for matching
+    std::vector<Order*>                             stop_batch_;        // batch being matched
+    TradeTape                                       tape_;
     uint64_t                                        next_trade_id_{1};
+    BookTop                                         last_top_{};   // writer's copy of top_
+    SeqLock<BookTop>                                top_;
 
-    void               addToBook(OrderPtr order);
+    void               addToBook(Order* order);
+    void               release(Order* order) { pool_.deallocate(order); }
     bool               cancelLocked(uint64_t order_id);
+    bool               modifyLocked(uint64_t order_id, int64_t new_price,
+                                    uint64_t new_qty, int64_t new_timestamp_ns);
+    void               publishTop() noexcept;
+    void               addStop(Order* stop);
+    bool               cancelStopLocked(uint64_t order_id);
+    bool               amendStopLocked(uint64_t order_id, int64_t price, uint64_t qty);
+    void               fireStops(PriceLadder<StopLevel>& side, StopLevel& level);
+    size_t             depthLocked(Side side, size_t levels, DepthLevel* out) const;
     void               checkStopTriggers(int64_t last_traded_price);
     Trade              makeTrade(uint64_t buy_id, uint64_t sell_id,
                                  int64_t price, uint64_t qty, int64_t ts);
-    std::vector<Trade> matchBuy(OrderPtr order);
-    std::vector<Trade> matchSell(OrderPtr order);
+
+    template <typename Sink> void matchLocked(Order* order, Sink& sink);
+    template <typename Sink> void dispatch(Order* order, Sink& sink);
+    template <Side S, OrderKind K, typename Sink> void matchKernel(Order* order, Sink& sink);
+    template <OrderKind K, typename Sink> void finishAggressor(Order* order, Sink& sink);
 };
+
+extern template class BasicOrderBook<SingleWriterPolicy>;
+extern template class BasicOrderBook<TicketLockPolicy>;
+extern template class BasicOrderBook<SharedMutexPolicy>;
+
+using OrderBook = BasicOrderBook<DefaultLockPolicy>;
+
+// ---------------------------------------------------------------------------
+// Matching — templated on the sink so trade delivery is statically dispatched
+// ---------------------------------------------------------------------------
+
+template <typename LockPolicy>
+template <typename Sink>
+void BasicOrderBook<LockPolicy>::match(Order* order, Sink& sink) {
+    std::unique_lock lock(mutex_);
+    matchLocked(order, sink);
+    publishTop();
+}
+
+template <typename LockPolicy>
+template <typename Sink>
+void BasicOrderBook<LockPolicy>::matchLocked(Order* order, Sink& sink) {
+    if (order->isStopLoss() && !order->isTriggered()) {
+        addStop(order);
+        sink.onOrderUpdate({order->id(), order->status(), order->leaves()});
+        return;
+    }
+
+    dispatch(order, sink);
+
+    // Triggered stops are collected inside checkStopTriggers; run them now.
+    // Swapping (rather than moving) keeps both vectors' capacity.
+    while (!triggered_stops_.empty()) {
+        stop_batch_.swap(triggered_stops_);
+        for (Order* stop : stop_batch_) dispatch(stop, sink);
+        stop_batch_.clear();
+    }
+}
+
+// Picks the kernel instantiation once per aggressor. A triggered stop
+// matches exactly like a limit order.
+template <typename LockPolicy>
+template <typename Sink>
+void BasicOrderBook<LockPolicy>::dispatch(Order* order, Sink& sink) {
+    bool buy = order->side() == Side::BUY;
+    switch (order->kind()) {
+    case OrderKind::MARKET:
+        buy ? matchKernel<Side::BUY,  OrderKind::MARKET>(order, sink)
+            : matchKernel<Side::SELL, OrderKind::MARKET>(order, sink);
+        break;
+    case OrderKind::ICEBERG:
+        buy ? matchKernel<Side::BUY,  OrderKind::ICEBERG>(order, sink)
+            : matchKernel<Side::SELL, OrderKind::ICEBERG>(order, sink);
+        break;
+    default:
+        buy ? matchKernel<Side::BUY,  OrderKind::LIMIT>(order, sink)
+            : matchKernel<Side::SELL, OrderKind::LIMIT>(order, sink);
+        break;
+    }
+}
+
+template <typename LockPolicy>
+template <OrderKind K, typename Sink>
+void BasicOrderBook<LockPolicy>::finishAggressor(Order* order, Sink& sink) {
+    if constexpr (K != OrderKind::MARKET) {
+        if (!order->isFilled()) {
+            addToBook(order);
+            sink.onOrderUpdate({order->id(), order->status(), order->leaves()});
+            return;
+        }
+    } else {
+        if (!order->isFilled()) order->cancel();   // unfilled market remainder
+    }
+    sink.onOrderUpdate({order->id(), order->status(), order->leaves()});
+    release(order);
+}
+
+// One kernel for both sides and every aggressor kind. S picks the opposite
+// ladder and its best-first direction; K drops the price check for market
+// orders and the display-lot bookkeeping for non-iceberg aggressors. Levels
+// without icebergs take a loop with no iceberg checks at all. Stops are
+// checked once per level: every trade at a level has the same price.
+template <typename LockPolicy>
+template <Side S, OrderKind K, typename Sink>
+void BasicOrderBook<LockPolicy>::matchKernel(Order* order, Sink& sink) {
+    constexpr bool BUY = (S == Side::BUY);
+    auto& book_side = BUY ? asks_ : bids_;
+
+    auto fillAggressor = [order](uint64_t qty) {
+        if constexpr (K == OrderKind::ICEBERG) order->fill(qty);
+        else                                   order->fillPlain(qty);
+    };
+    auto trade = [&](Order* resting, int64_t price, uint64_t qty) {
+        Trade t = BUY ? makeTrade(order->id(), resting->id(), price, qty, order->timestamp())
+                      : makeTrade(resting->id(), order->id(), price, qty, order->timestamp());
+        tape_.append(t);
+        sink.onTrade(t);
+        sink.onOrderUpdate({resting->id(), resting->status(), resting->leaves()});
+    };
+
+    while (!order->isFilled()) {
+        Level* level = BUY ? book_side.lowest() : book_side.highest();
+        if (!level) break;
+
+        // Limit orders may not trade through their stated price.
+        if constexpr (K != OrderKind::MARKET) {
+            if (BUY ? level->price > order->price() : level->price < order->price()) break;
+        }
+
+        int64_t price  = level->price;
+        auto&   queue  = level->orders;
+        bool    traded = false;
+
+        if (level->icebergs == 0) {
+            while (!queue.empty()) {
+                Order*   resting = queue.front();
+                uint64_t qty     = std::min(order->leaves(), resting->leaves());
+                fillAggressor(qty);
+                level->fillPlain(resting, qty);
+                trade(resting, price, qty);
+                traded = true;
+
+                if (resting->isFilled()) {
+                    queue.pop_front();
+                    active_.erase(resting->id());
+                    release(resting);
+                }
+                if (order->isFilled()) break;
+            }
+        } else {
+            while (!order->isFilled() && !queue.empty()) {
+                Order* resting = queue.front();
+
+                uint64_t available = resting->visibleQty();
+                if (available == 0) {
+                    level->erase(resting);
+                    active_.erase(resting->id());
+                    release(resting);
+                    continue;
+                }
+
+                uint64_t qty = std::min(order->leaves(), available);
+                fillAggressor(qty);
+                level->fill(resting, qty);
+                trade(resting, price, qty);
+                traded = true;
+
+                if (resting->isFilled()) {
+                    level->erase(resting);
+                    active_.erase(resting->id());
+                    release(resting);
+                } else if (resting->isIceberg() && resting->visibleQty() == 0) {
+                    level->replenish(resting);   // refill display lot; order stays in queue
+                }
+            }
+        }
+
+        if (traded) checkStopTriggers(price);
+        if (queue.empty()) book_side.release(price);
+    }
+
+    finishAggressor<K>(order, sink);
+}
@@ -0,0 +1,414 @@
+#pragma once
+
+#include "huge_pages.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// LadderConfig
+//
+// Describes the dense price band of a PriceLadder. Prices in
+// [base_price, base_price + tick_size * num_ticks) that sit exactly on a tick
+// are stored in a contiguous array; everything else falls back to a sparse
+// ordered map. A default-constructed config (num_ticks == 0) disables the
+// dense band entirely, which reproduces the plain std::map level store.
+// ---------------------------------------------------------------------------
+struct LadderConfig {
+    int64_t base_price{0};
+    int64_t tick_size{0};
+    size_t  num_ticks{0};
+};
+
+// ---------------------------------------------------------------------------
+// OccupancyBitmap
+//
+// Hierarchical 64-ary bitmap. Level 0 holds one bit per slot; bit i of level
+// k+1 is set iff word i of level k is non-zero. Finding the next or previous
+// set bit walks up until a word has a candidate, then straight back down with
+// one ctz/clz per level — three levels cover 262 144 slots.
+// ---------------------------------------------------------------------------
+class OccupancyBitmap {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    explicit OccupancyBitmap(size_t bits = 0) {
+        size_t words = (bits + 63) / 64;
+        if (words == 0) return;
+        levels_.emplace_back(words, 0);
+        while (words > 1) {
+            words = (words + 63) / 64;
+            levels_.emplace_back(words, 0);
+        }
+    }
+
+    void set(size_t i) noexcept {
+        for (auto& words : levels_) {
+            uint64_t& w   = words[i >> 6];
+            bool      was = w != 0;
+            w |= bit(i);
+            if (was) return;   // parent bit already set
+            i >>= 6;
+        }
+    }
+
+    void clear(size_t i) noexcept {
+        for (auto& words : levels_) {
+            uint64_t& w = words[i >> 6];
+            w &= ~bit(i);
+            if (w != 0) return;   // word still occupied, parent unchanged
+            i >>= 6;
+        }
+    }
+
+    bool test(size_t i) const noexcept {
+        return !levels_.empty() && (levels_[0][i >> 6] & bit(i)) != 0;
+    }
+
+    // First set bit >= i, or npos.
+    size_t findNext(size_t i) const noexcept {
+        size_t lvl = 0;
+        while (lvl < levels_.size()) {
+            size_t w = i >> 6;
+            if (w >= levels_[lvl].size()) return npos;
+            uint64_t m = levels_[lvl][w] & (~0ULL << (i & 63));
+            if (m) { i = (w << 6) | ctz(m); break; }
+            i = w + 1;
+            ++lvl;
+        }
+        if (lvl == levels_.size()) return npos;
+        while (lvl > 0) {
+            --lvl;
+            i = (i << 6) | ctz(levels_[lvl][i]);
+        }
+        return i;
+    }
+
+    // Last set bit <= i, or npos.
+    size_t findPrev(size_t i) const noexcept {
+        size_t lvl = 0;
+        while (lvl < levels_.size()) {
+            size_t w = i >> 6;
+            if (w >= levels_[lvl].size()) {
+                w = levels_[lvl].size() - 1;
+                i = (w << 6) | 63;
+            }
+            uint64_t m = levels_[lvl][w] & (~0ULL >> (63 - (i & 63)));
+            if (m) { i = (w << 6) | (63 - clz(m)); break; }
+            if (w == 0) return npos;
+            i = w - 1;
+            ++lvl;
+        }
+        if (lvl == levels_.size()) return npos;
+        while (lvl > 0) {
+            --lvl;
+            i = (i << 6) | (63 - clz(levels_[lvl][i]));
+        }
+        return i;
+    }
+
+private:
+    std::vector<std::vector<uint64_t>> levels_;
+
+    static uint64_t bit(size_t i) noexcept { return 1ULL << (i & 63); }
+    static size_t   ctz(uint64_t m) noexcept { return static_cast<size_t>(__builtin_ctzll(m)); }
+    static size_t   clz(uint64_t m) noexcept { return static_cast<size_t>(__builtin_clzll(m)); }
+};
+
+// ---------------------------------------------------------------------------
+// NodeArena / ArenaAllocator<T>
+//
+// Free list of fixed-size blocks for the nodes of one node-based container.
+// The block size is fixed by the first allocation; blocks are carved from
+// chunks of CHUNK and reused LIFO, so a node freed when a level empties is
+// the next one handed out, still warm in cache. Requests of any other size
+// go to operator new. Chunks are returned only when the arena is destroyed.
+// Not thread-safe: a ladder belongs to one writer.
+// ---------------------------------------------------------------------------
+class NodeArena {
+public:
+    static constexpr size_t CHUNK = 64;
+
+    NodeArena() = default;
+    NodeArena(const NodeArena&)            = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    ~NodeArena() {
+        while (chunks_) {
+            Free* next = chunks_->next;
+            ::operator delete(chunks_);
+            chunks_ = next;
+        }
+    }
+
+    void* allocate(size_t bytes) {
+        if (block_ == 0) block_ = roundUp(bytes);
+        if (roundUp(bytes) != block_) return ::operator new(bytes);
+        if (!free_) refill();
+        Free* f = free_;
+        free_   = f->next;
+        return f;
+    }
+
+    void deallocate(void* p, size_t bytes) noexcept {
+        if (roundUp(bytes) != block_) {
+            ::operator delete(p);
+            return;
+        }
+        auto* f = static_cast<Free*>(p);
+        f->next = free_;
+        free_   = f;
+    }
+
+private:
+    struct Free {
+        Free* next;
+    };
+
+    static constexpr size_t ALIGN = alignof(std::max_align_t);
+
+    size_t block_{0};
+    Free*  free_{nullptr};
+    Free*  chunks_{nullptr};   // each chunk's first ALIGN bytes link the list
+
+    static size_t roundUp(size_t bytes) noexcept {
+        if (bytes < sizeof(Free)) bytes = sizeof(Free);
+        return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    void refill() {
+        auto* chunk = static_cast<unsigned char*>(::operator new(ALIGN + block_ * CHUNK));
+        auto* head  = reinterpret_cast<Free*>(chunk);
+        head->next  = chunks_;
+        chunks_     = head;
+        for (size_t i = CHUNK; i-- > 0;) {
+            auto* f = reinterpret_cast<Free*>(chunk + ALIGN + i * block_);
+            f->next = free_;
+            free_   = f;
+        }
+    }
+};
+
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    NodeArena* arena;
+
+    explicit ArenaAllocator(NodeArena* a) noexcept : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+        arena->deallocate(p, sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& o) const noexcept { return arena == o.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& o) const noexcept { return arena != o.arena; }
+};
+
+// ---------------------------------------------------------------------------
+// PriceLadder<Level>
+//
+// Price-level store for one side of the book. Level must be default
+// constructible and expose a public `int64_t price` member, which the ladder
+// sets when a level is acquired. Levels never move once acquired: the dense
+// band is a fixed array and the sparse fallback is a node-based map.
+//
+// A level that empties costs no allocator traffic on either path. Dense
+// levels stay in place and are only marked free. Sparse map nodes come from
+// a NodeArena, and the last SPARE_LEVELS emptied nodes are extracted rather
+// than erased and relinked under the next new price, so a level flickering
+// at the touch reuses the same node. An emptied level is left as a
+// default-constructed one apart from its price, which is what acquire()
+// expects of a reused node as much as of a dense slot.
+//
+// The ladder itself is side-agnostic; bids walk it with highest()/below()
+// and asks with lowest()/above(). Callers release a level once it is empty.
+// ---------------------------------------------------------------------------
+template <typename Level>
+class PriceLadder {
+public:
+    explicit PriceLadder(const LadderConfig& cfg = {})
+        : base_(cfg.base_price),
+          tick_(cfg.tick_size > 0 ? cfg.tick_size : 1),
+          dense_(cfg.tick_size > 0 ? cfg.num_ticks : 0),
+          occupied_(dense_.size())
+    {
+        spare_.reserve(SPARE_LEVELS);
+    }
+
+    PriceLadder(const PriceLadder&)            = delete;
+    PriceLadder& operator=(const PriceLadder&) = delete;
+
+    size_t size()  const noexcept { return dense_count_ + sparse_.size(); }
+    bool   empty() const noexcept { return size() == 0; }
+
+    // Returns the level at price, or nullptr if none is occupied.
+    Level* find(int64_t price) noexcept {
+        size_t idx;
+        if (denseIndex(price, idx))
+            return occupied_.test(idx) ? &dense_[idx] : nullptr;
+        auto it = sparse_.find(price);
+        return it == sparse_.end() ? nullptr : &it->second;
+    }
+
+    // Cache hint for the level at price, occupied or not. Dense band only:
+    // a sparse level would need the map walk the hint is meant to save.
+    void prefetch(int64_t price) const noexcept {
+        size_t idx;
+        if (denseIndex(price, idx)) __builtin_prefetch(&dense_[idx], 1);
+    }
+
+    // Returns the level at price, occupying it first if necessary.
+    Level& acquire(int64_t price) {
+        size_t idx;
+        if (denseIndex(price, idx)) {
+            Level& level = dense_[idx];
+            if (!occupied_.test(idx)) {
+                occupied_.set(idx);
+                ++dense_count_;
+                level.price = price;
+            }
+            return level;
+        }
+        auto it = sparse_.lower_bound(price);
+        if (it != sparse_.end() && it->first == price) return it->second;
+        if (!spare_.empty()) {
+            auto node = std::move(spare_.back());
+            spare_.pop_back();
+            node.key()          = price;
+            node.mapped().price = price;
+            return sparse_.insert(it, std::move(node))->second;
+        }
+        it = sparse_.emplace_hint(it, std::piecewise_construct,
+                                  std::forward_as_tuple(price), std::forward_as_tuple());
+        it->second.price = price;
+        return it->second;
+    }
+
+    // Marks the level at price as unoccupied. The level must be empty.
+    void release(int64_t price) {
+        size_t idx;
+        if (denseIndex(price, idx)) {
+            if (occupied_.test(idx)) {
+                occupied_.clear(idx);
+                --dense_count_;
+            }
+            return;
+        }
+        auto it = sparse_.find(price);
+        if (it == sparse_.end()) return;
+        if (spare_.size() < SPARE_LEVELS) spare_.push_back(sparse_.extract(it));
+        else                              sparse_.erase(it);
+    }
+
+    Level* lowest() noexcept {
+        return pickLow(denseAtOrAbove(0), sparse_.empty() ? nullptr : &sparse_.begin()->second);
+    }
+
+    Level* highest() noexcept {
+        return pickHigh(denseAtOrBelow(dense_.size()),
+                        sparse_.empty() ? nullptr : &sparse_.rbegin()->second);
+    }
+
+    // Next occupied level strictly above price.
+    Level* above(int64_t price) noexcept {
+        Level* d = nullptr;
+        if (!dense_.empty() && price < denseTop()) {
+            size_t from = price < base_ ? 0
+                        : static_cast<size_t>((price - base_) / tick_) + 1;
+            d = denseAtOrAbove(from);
+        }
+        auto   it = sparse_.upper_bound(price);
+        return pickLow(d, it == sparse_.end() ? nullptr : &it->second);
+    }
+
+    // Next occupied level strictly below price.
+    Level* below(int64_t price) noexcept {
+        Level* d = nullptr;
+        if (!dense_.empty() && price > base_) {
+            int64_t off  = price - base_;
+            size_t  upto = static_cast<size_t>((off - 1) / tick_);
+            d = denseAtOrBelow(upto);
+        }
+        auto   it = sparse_.lower_bound(price);
+        Level* s  = (it == sparse_.begin()) ? nullptr : &std::prev(it)->second;
+        return pickHigh(d, s);
+    }
+
+    const Level* lowest()  const noexcept { return const_cast<PriceLadder*>(this)->lowest(); }
+    const Level* highest() const noexcept { return const_cast<PriceLadder*>(this)->highest(); }
+    const Level* above(int64_t p) const noexcept { return const_cast<PriceLadder*>(this)->above(p); }
+    const Level* below(int64_t p) const noexcept { return const_cast<PriceLadder*>(this)->below(p); }
+
+    // Emptied sparse nodes kept for reuse.
+    static constexpr size_t SPARE_LEVELS = 8;
+
+private:
+    using SparseMap = std::map<int64_t, Level, std::less<int64_t>,
+                               ArenaAllocator<std::pair<const int64_t, Level>>>;
+
+    int64_t                                      base_;
+    int64_t                                      tick_;
+    std::vector<Level, HugePageAllocator<Level>> dense_;   // huge pages once >= 2 MiB
+    OccupancyBitmap                              occupied_;
+    size_t                                       dense_count_{0};
+    // Destroyed bottom-up: spare nodes, then the map, then their arena.
+    NodeArena                                    arena_;
+    SparseMap                                    sparse_{typename SparseMap::allocator_type(&arena_)};   // off-band and off-tick prices
+    std::vector<typename SparseMap::node_type>   spare_;
+
+    int64_t denseTop() const noexcept {
+        return base_ + tick_ * static_cast<int64_t>(dense_.size());
+    }
+
+    bool denseIndex(int64_t price, size_t& idx) const noexcept {
+        if (price < base_ || price >= denseTop()) return false;
+        int64_t off = price - base_;
+        if (off % tick_ != 0) return false;
+        idx = static_cast<size_t>(off / tick_);
+        return true;
+    }
+
+    Level* denseAtOrAbove(size_t idx) noexcept {
+        if (dense_count_ == 0) return nullptr;
+        size_t i = occupied_.findNext(idx);
+        return i == OccupancyBitmap::npos ? nullptr : &dense_[i];
+    }
+
+    Level* denseAtOrBelow(size_t idx) noexcept {
+        if (dense_count_ == 0) return nullptr;
+        size_t i = occupied_.findPrev(idx);
+        return i == OccupancyBitmap::npos ? nullptr : &dense_[i];
+    }
+
+    static Level* pickLow(Level* a, Level* b) noexcept {
+        if (!a) return b;
+        if (!b) return a;
+        return a->price <= b->price ? a : b;
+    }
+
+    static Level* pickHigh(Level* a, Level* b) noexcept {
+        if (!a) return b;
+        if (!b) return a;
+        return a->price >= b->price ? a : b;
+    }
+};
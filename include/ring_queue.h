@@ -0,0 +1,224 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// Bounded ring queues
+//
+// Fixed-capacity FIFOs over one array allocated at construction; nothing is
+// allocated or freed afterwards. Capacity is rounded up to a power of two so
+// a position maps to its slot with a mask. Positions are 64-bit counters
+// that never wrap in practice.
+//
+// Both variants have one consumer. Producers get
+//   tryEnqueue(v)             false when full — the caller applies backpressure
+//   enqueue(v)                spins (pause, then yield) until there is room
+//   tryEnqueueBulk(p, n)      claims up to n slots at once, returns how many
+//   enqueueBulk(p, n)         spins until all n are in, claiming what fits each time
+// and the consumer
+//   dequeue(v)                false when empty
+//   dequeueBulk(p, max)       takes up to max ready items, returns how many
+//   empty()                   true if a dequeue now would find nothing
+//
+// The producer and consumer indices sit on separate cache lines. In the
+// SPSC ring each side also keeps a private copy of the other's index, so it
+// only reloads the shared one when the ring looks full or empty.
+// ---------------------------------------------------------------------------
+
+namespace ring_detail {
+
+inline size_t roundUpPow2(size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap <<= 1;
+    return cap;
+}
+
+inline void relax(uint32_t spins) {
+    if (spins < 1024) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace ring_detail
+
+// ---------------------------------------------------------------------------
+// SpscRing<T> — one producer thread, one consumer thread
+//
+// The producer publishes by storing tail_ with release; the consumer frees
+// slots by storing head_ with release. A bulk operation moves its index
+// once for the whole run of slots.
+// ---------------------------------------------------------------------------
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : mask_(ring_detail::roundUpPow2(capacity) - 1),
+          slots_(std::make_unique<T[]>(mask_ + 1)) {}
+
+    SpscRing(const SpscRing&)            = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    bool tryEnqueue(const T& value) noexcept { return tryEnqueueBulk(&value, 1) == 1; }
+
+    void enqueue(const T& value) noexcept {
+        for (uint32_t spins = 0; !tryEnqueue(value); ++spins) ring_detail::relax(spins);
+    }
+
+    size_t tryEnqueueBulk(const T* items, size_t n) noexcept {
+        uint64_t tail = prod_.tail.load(std::memory_order_relaxed);
+        size_t   room = capacity() - static_cast<size_t>(tail - prod_.head_cache);
+        if (room < n) {
+            prod_.head_cache = cons_.head.load(std::memory_order_acquire);
+            room = capacity() - static_cast<size_t>(tail - prod_.head_cache);
+        }
+        n = std::min(n, room);
+        for (size_t i = 0; i < n; ++i) slots_[(tail + i) & mask_] = items[i];
+        if (n) prod_.tail.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    void enqueueBulk(const T* items, size_t n) noexcept {
+        for (uint32_t spins = 0; n; ++spins) {
+            size_t k = tryEnqueueBulk(items, n);
+            items += k;
+            n     -= k;
+            if (k) spins = 0;
+            else   ring_detail::relax(spins);
+        }
+    }
+
+    bool dequeue(T& out) noexcept { return dequeueBulk(&out, 1) == 1; }
+
+    // Consumer only.
+    bool empty() const noexcept {
+        return prod_.tail.load(std::memory_order_acquire) ==
+               cons_.head.load(std::memory_order_relaxed);
+    }
+
+    size_t dequeueBulk(T* out, size_t max) noexcept {
+        uint64_t head  = cons_.head.load(std::memory_order_relaxed);
+        size_t   ready = static_cast<size_t>(cons_.tail_cache - head);
+        if (ready < max) {
+            cons_.tail_cache = prod_.tail.load(std::memory_order_acquire);
+            ready = static_cast<size_t>(cons_.tail_cache - head);
+        }
+        size_t n = std::min(max, ready);
+        for (size_t i = 0; i < n; ++i) out[i] = slots_[(head + i) & mask_];
+        if (n) cons_.head.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    struct alignas(64) Producer {
+        std::atomic<uint64_t> tail{0};
+        uint64_t              head_cache{0};
+    };
+    struct alignas(64) Consumer {
+        std::atomic<uint64_t> head{0};
+        uint64_t              tail_cache{0};
+    };
+
+    const size_t         mask_;
+    std::unique_ptr<T[]> slots_;
+    Producer             prod_;   // written by the producer only
+    Consumer             cons_;   // written by the consumer only
+};
+
+// ---------------------------------------------------------------------------
+// MpscRing<T> — any number of producer threads, one consumer thread
+//
+// Producers claim positions by CAS on tail_, write their slots, then mark
+// each one ready by storing its sequence number (position + 1) with
+// release. Producers can finish out of claim order, so the consumer takes
+// only the run of ready slots at head_ and stops at the first that is not.
+// Room is judged against head_, which the consumer stores with release only
+// after it has copied the slots out. A bulk claim is one CAS for the run.
+// ---------------------------------------------------------------------------
+template <typename T>
+class MpscRing {
+public:
+    explicit MpscRing(size_t capacity)
+        : mask_(ring_detail::roundUpPow2(capacity) - 1),
+          slots_(std::make_unique<Slot[]>(mask_ + 1)) {}
+
+    MpscRing(const MpscRing&)            = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    size_t capacity() const noexcept { return mask_ + 1; }
+
+    bool tryEnqueue(const T& value) noexcept { return tryEnqueueBulk(&value, 1) == 1; }
+
+    void enqueue(const T& value) noexcept {
+        for (uint32_t spins = 0; !tryEnqueue(value); ++spins) ring_detail::relax(spins);
+    }
+
+    size_t tryEnqueueBulk(const T* items, size_t n) noexcept {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        size_t   claim;
+        do {
+            uint64_t head = head_.load(std::memory_order_acquire);
+            claim = std::min(n, capacity() - static_cast<size_t>(tail - head));
+            if (claim == 0) return 0;
+        } while (!tail_.compare_exchange_weak(tail, tail + claim, std::memory_order_relaxed,
+                                              std::memory_order_relaxed));
+
+        for (size_t i = 0; i < claim; ++i) {
+            Slot& s = slots_[(tail + i) & mask_];
+            s.value = items[i];
+            s.seq.store(tail + i + 1, std::memory_order_release);
+        }
+        return claim;
+    }
+
+    void enqueueBulk(const T* items, size_t n) noexcept {
+        for (uint32_t spins = 0; n; ++spins) {
+            size_t k = tryEnqueueBulk(items, n);
+            items += k;
+            n     -= k;
+            if (k) spins = 0;
+            else   ring_detail::relax(spins);
+        }
+    }
+
+    bool dequeue(T& out) noexcept { return dequeueBulk(&out, 1) == 1; }
+
+    // Consumer only: true if the slot at the head is not ready yet.
+    bool empty() const noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        return slots_[head & mask_].seq.load(std::memory_order_acquire) != head + 1;
+    }
+
+    size_t dequeueBulk(T* out, size_t max) noexcept {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t   n    = 0;
+        for (; n < max; ++n) {
+            Slot& s = slots_[(head + n) & mask_];
+            if (s.seq.load(std::memory_order_acquire) != head + n + 1) break;
+            out[n] = s.value;
+        }
+        if (n) head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        T                     value{};
+    };
+
+    const size_t            mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
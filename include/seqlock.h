@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// ---------------------------------------------------------------------------
+// SeqLock<T>
+//
+// Single-writer, many-reader publication of a small trivially copyable
+// record. The writer bumps the sequence to odd, stores the record, then
+// bumps it to even; a reader copies the record between two sequence loads
+// and keeps the copy only if both loads saw the same even value. The writer
+// never waits on readers and readers never write shared memory, so polling
+// readers cost the writer nothing beyond the cache-line transfer of the
+// record itself.
+//
+// The record is held as relaxed atomic words, so concurrent reads of a
+// record being overwritten are well defined (and then discarded). With a
+// 56-byte T the sequence and record share one cache line.
+//
+// Only one thread may call store() at a time; OrderBook stores under its
+// exclusive lock.
+// ---------------------------------------------------------------------------
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock record must be trivially copyable");
+    static_assert(sizeof(T) % sizeof(uint64_t) == 0, "SeqLock record must be whole words");
+
+public:
+    explicit SeqLock(const T& init = T{}) noexcept { write(init); }
+
+    SeqLock(const SeqLock&)            = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    void store(const T& value) noexcept {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        write(value);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // One attempt, wait-free. Returns false, leaving out unspecified, if a
+    // store was in progress or completed during the copy.
+    bool tryLoad(T& out) const noexcept {
+        uint64_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        uint64_t buf[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) buf[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+        std::memcpy(&out, buf, sizeof(T));
+        return true;
+    }
+
+    // Retries tryLoad() until it gets a consistent copy. Lock-free: it can
+    // only spin while stores keep landing, and never delays the writer.
+    T load() const noexcept {
+        T out;
+        while (!tryLoad(out)) {}
+        return out;
+    }
+
+private:
+    static constexpr size_t WORDS = sizeof(T) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t>             words_[WORDS];
+
+    void write(const T& value) noexcept {
+        uint64_t buf[WORDS];
+        std::memcpy(buf, &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) words_[i].store(buf[i], std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "order.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// Book snapshots
+//
+// A snapshot is one sequential file:
+//
+//   SnapshotHeader     64 bytes: magic, version, engine counters, counts
+//   SnapshotRecord     64 bytes each: every resting order, bids then asks,
+//                      each side best level first, each level in time
+//                      priority
+//   SnapshotRecord     every pending stop, sell stops then buy stops, each
+//                      in the order they would fire
+//   SnapshotTrailer    32 bytes: magic, record count, checksum of the header
+//                      and records
+//
+// Restoring appends the records to empty levels in file order, so queue
+// priority, iceberg display lots and reserves, and stop firing order come
+// back exactly as saved, without matching anything. journal_sequence is the
+// last journal entry the snapshot includes; a restart replays the journal
+// from the entry after it.
+//
+// Files are written to <path>.tmp, fsync'd and renamed over path, so a
+// crash mid-write leaves the previous snapshot in place. Integers are in
+// host byte order; the version changes whenever the layout does.
+// ---------------------------------------------------------------------------
+
+struct SnapshotHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t journal_sequence;
+    uint64_t next_order_id;
+    uint64_t next_trade_id;
+    uint64_t resting_orders;
+    uint64_t pending_stops;
+    uint64_t reserved;
+};
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header must stay 64 bytes");
+
+// One order. ext_a / ext_b hold an iceberg's current and full display lot,
+// or a stop's trigger price and whether it has fired (1 for a stop that now
+// rests as a limit); they are zero for plain limits.
+struct SnapshotRecord {
+    uint64_t id;
+    int64_t  timestamp_ns;
+    int64_t  price;
+    uint64_t quantity;
+    uint64_t leaves;
+    uint64_t ext_a;
+    uint64_t ext_b;
+    uint8_t  side;
+    uint8_t  kind;
+    uint8_t  status;
+    uint8_t  reserved[5];
+};
+static_assert(sizeof(SnapshotRecord) == 64, "snapshot record must stay 64 bytes");
+
+constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+SnapshotRecord snapshotRecord(const Order& o) noexcept;
+OrderExt       snapshotExt(const SnapshotRecord& r) noexcept;
+
+// Buffered writer for one snapshot file. Throws std::system_error on any
+// I/O failure; the temporary file is removed unless commit() succeeded.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(const std::string& path);
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter&)            = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void header(const SnapshotHeader& h);   // first, exactly once
+    void record(const SnapshotRecord& r);
+
+    // Writes the trailer, syncs the file and moves it into place.
+    void commit();
+
+    uint64_t bytesWritten() const noexcept { return bytes_; }
+
+private:
+    static constexpr size_t BUFFER_BYTES = size_t{1} << 20;
+
+    std::string             path_;
+    std::string             tmp_;
+    int                     fd_{-1};
+    std::unique_ptr<char[]> buf_;
+    size_t                  used_{0};
+    uint64_t                bytes_{0};
+    uint64_t                records_{0};
+    uint64_t                lanes_[4];   // running checksum
+    bool                    committed_{false};
+
+    void put(const void* p, size_t n);
+    void flush();
+};
+
+// Read-only mapping of one snapshot file. The constructor checks the
+// header, the record counts against the file size, the trailer and the
+// checksum, so a damaged file is refused before anything is loaded from it.
+// Throws std::system_error if the file is unreadable (errno) or truncated,
+// of another version, claims more records than it holds or fails its
+// checksum (EINVAL).
+class SnapshotReader {
+public:
+    explicit SnapshotReader(const std::string& path);
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader&)            = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    const SnapshotHeader& header()  const noexcept { return header_; }
+    uint64_t              records() const noexcept { return header_.resting_orders + header_.pending_stops; }
+
+    // Record i in file order, i < records().
+    const SnapshotRecord& record(uint64_t i) const noexcept { return records_[i]; }
+
+private:
+    std::string           path_;
+    void*                 map_{nullptr};
+    size_t                bytes_{0};
+    SnapshotHeader        header_{};
+    const SnapshotRecord* records_{nullptr};
+
+    [[noreturn]] void fail(int err, const char* what);
+};
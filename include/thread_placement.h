@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Thread placement
+//
+// Where the threads around one matching engine run. A core of -1 leaves a
+// thread wherever the scheduler puts it. The matching thread is the one
+// that owns the book: pinning it stops it migrating and arriving on a core
+// with a cold cache. With numa_local it also asks the kernel to place its
+// allocations on its own NUMA node; engines that honour a placement build
+// their book, pools and queue on that thread, after pinning, so every page
+// is first touched (and so placed) there.
+//
+// The engine pins its own matching thread. Producer and publisher threads
+// belong to the caller, which pins each one with pinCurrentThread() and the
+// core given here.
+// ---------------------------------------------------------------------------
+struct ThreadPlacement {
+    int              matching_core  = -1;
+    int              publisher_core = -1;   // market-data / top-of-book reader
+    std::vector<int> producer_cores;        // producer i: producer_cores[i % size]
+    bool             numa_local     = true;
+
+    int producerCore(size_t i) const {
+        return producer_cores.empty() ? -1 : producer_cores[i % producer_cores.size()];
+    }
+
+    // Matching thread on first_core, the publisher on the next core, and
+    // producers round-robin over the cores after that, all modulo the
+    // online cores. On a machine with fewer cores than threads, threads
+    // share cores.
+    static ThreadPlacement pinned(size_t producers, int first_core = 0);
+};
+
+// Online CPUs, at least 1.
+size_t onlineCores();
+
+// Pins the calling thread to one core. False if core is negative, out of
+// range, or pinning is unsupported.
+bool pinCurrentThread(int core);
+
+// Core and NUMA node the calling thread is running on now, or -1 if unknown.
+int currentCore();
+int currentNumaNode();
+
+// Makes the calling thread's later page allocations prefer node. False if
+// the kernel refused or the platform has no NUMA policy.
+bool preferNumaNode(int node);
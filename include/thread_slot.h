@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// ---------------------------------------------------------------------------
+// ThreadSlot
+//
+// A small process-wide integer for each live thread, in [0, MAX_THREADS),
+// taken on the thread's first call to id() and given back when it exits.
+// Structures that keep per-thread state (ConcurrentQueue's hazard pointers)
+// index a fixed array with it instead of hashing thread ids. A slot is only
+// ever held by one thread at a time, but a later thread may inherit it.
+// More than MAX_THREADS threads calling id() at once throws
+// std::runtime_error.
+// ---------------------------------------------------------------------------
+class ThreadSlot {
+public:
+    static constexpr size_t MAX_THREADS = 256;
+
+    static size_t id() {
+        thread_local const Holder holder;
+        return holder.slot;
+    }
+
+private:
+    static constexpr size_t WORDS = MAX_THREADS / 64;
+
+    static inline std::atomic<uint64_t> used_[WORDS]{};
+
+    struct Holder {
+        size_t slot;
+        Holder() : slot(acquire()) {}
+        ~Holder() { release(slot); }
+    };
+
+    static size_t acquire() {
+        for (size_t w = 0; w < WORDS; ++w) {
+            uint64_t bits = used_[w].load(std::memory_order_relaxed);
+            while (~bits) {
+                uint64_t bit = ~bits & (bits + 1);   // lowest clear bit
+                if (used_[w].compare_exchange_weak(bits, bits | bit, std::memory_order_acquire,
+                                                   std::memory_order_relaxed))
+                    return w * 64 + static_cast<size_t>(__builtin_ctzll(bit));
+            }
+        }
+        throw std::runtime_error("ThreadSlot: more than MAX_THREADS live threads");
+    }
+
+    static void release(size_t slot) noexcept {
+        used_[slot / 64].fetch_and(~(uint64_t{1} << (slot % 64)), std::memory_order_release);
+    }
+};
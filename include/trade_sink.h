@@ -0,0 +1,65 @@
+#pragma once
+
+#include "order.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Trade {
+    uint64_t trade_id;
+    uint64_t buy_order_id;
+    uint64_t sell_order_id;
+    int64_t  price;
+    uint64_t quantity;
+    int64_t  timestamp_ns;
+};
+
+// State change of one order, reported as it happens: a resting order after
+// each fill, an aggressor once it has finished matching (resting, filled, or
+// cancelled for an unfilled market remainder), and a stop when it is parked.
+struct OrderUpdate {
+    uint64_t    order_id;
+    OrderStatus status;
+    uint64_t    leaves;
+};
+
+// ---------------------------------------------------------------------------
+// Trade sinks
+//
+// OrderBook::match and the MatchingEngine submit overloads take the sink as a
+// template parameter, so every callback is a direct (usually inlined) call.
+// A sink is any type providing:
+//
+//   void onTrade(const Trade&);
+//   void onOrderUpdate(const OrderUpdate&);
+//
+// Callbacks run with the book lock held and must not call back into the book.
+//
+// MatchingEngine::submitBatch takes a result sink: a trade sink that also
+// provides
+//
+//   void onResult(size_t index, uint64_t order_id, bool ok);
+//
+// called once per event, after that event's trades and updates. index is
+// the event's position in the batch and order_id the engine id assigned to a
+// submit or named by a cancel; ok is false only for a cancel that found no
+// live order.
+// ---------------------------------------------------------------------------
+
+// Discards everything. Matching through a NullSink does no per-call work
+// beyond the book's own bookkeeping.
+struct NullSink {
+    void onTrade(const Trade&) noexcept {}
+    void onOrderUpdate(const OrderUpdate&) noexcept {}
+    void onResult(size_t, uint64_t, bool) noexcept {}
+};
+
+// Appends trades to a caller-owned vector. Reusing the vector across calls
+// keeps its capacity, so steady-state matching does not allocate.
+struct TradeCollector {
+    std::vector<Trade>& trades;
+
+    void onTrade(const Trade& t) { trades.push_back(t); }
+    void onOrderUpdate(const OrderUpdate&) noexcept {}
+    void onResult(size_t, uint64_t, bool) noexcept {}
+};
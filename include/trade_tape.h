@@ -0,0 +1,138 @@
+#pragma once
+
+#include "trade_sink.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+
+// Sizing for a TradeTape. With an empty spill_dir nothing touches the
+// filesystem and trades that age out of the ring are dropped.
+struct TapeConfig {
+    size_t      ring_capacity   = size_t{1} << 16;   // rounded up to a power of two
+    std::string spill_dir;                           // segment directory; empty = no spill
+    size_t      segment_records = size_t{1} << 20;   // records per segment file
+    size_t      max_segments    = 16;                // oldest file is deleted past this
+};
+
+// ---------------------------------------------------------------------------
+// TradeTape
+//
+// The book's trade history: a fixed-capacity ring of the most recent trades
+// in a compact 40-byte record, with older trades spilled to rotating
+// memory-mapped segment files. Appending never allocates and never copies
+// more than the one record being evicted, so history growth cannot stall
+// the matching path and memory stays bounded however long the book runs.
+//
+// Trade ids are contiguous, so records do not store them: the id is derived
+// from the record's position on the tape. Trades are addressed by sequence
+// number (0 = first trade ever appended); the readable range is
+// [firstSeq(), totalAppended()).
+//
+// Segment file trades-<n>.seg holds sequences [n*segment_records,
+// (n+1)*segment_records): a 64-byte header (magic, first trade id, record
+// count, record size) followed by the records. The count is updated after
+// every record, so a file left behind by a crashed process is readable up to
+// the last complete record.
+//
+// The spill directory should belong to one tape: segment numbering restarts
+// at 0 and existing files are overwritten. Not internally synchronised;
+// OrderBook appends under its lock. Iterators are invalidated by append().
+// ---------------------------------------------------------------------------
+class TradeTape {
+public:
+    struct Record {
+        uint64_t buy_order_id;
+        uint64_t sell_order_id;
+        int64_t  price;
+        uint64_t quantity;
+        int64_t  timestamp_ns;
+    };
+    static_assert(sizeof(Record) == 40, "TradeTape::Record layout changed");
+
+    class Iterator;
+
+    // Throws std::system_error if spill_dir is set but the first segment
+    // cannot be created.
+    explicit TradeTape(const TapeConfig& cfg = {});
+    ~TradeTape();
+    TradeTape(const TradeTape&)            = delete;
+    TradeTape& operator=(const TradeTape&) = delete;
+
+    // Trade ids must be contiguous: each append's id is one past the last.
+    void append(const Trade& t) noexcept;
+
+    uint64_t size()          const noexcept { return total_ - firstSeq(); }
+    bool     empty()         const noexcept { return size() == 0; }
+    uint64_t totalAppended() const noexcept { return total_; }
+    uint64_t firstSeq()      const noexcept;          // oldest readable trade
+    uint64_t dropped()       const noexcept { return firstSeq(); }
+    size_t   ringCapacity()  const noexcept { return mask_ + 1; }
+    size_t   segmentCount()  const noexcept;
+    bool     spilling()      const noexcept { return writer_ != nullptr; }
+
+    // Reads one trade by sequence number; seq must be in the readable range.
+    // Trades still in the ring are a single load; spilled trades map their
+    // segment file for the duration of the call.
+    Trade at(uint64_t seq) const;
+    Trade back() const { return at(total_ - 1); }
+
+    Iterator begin() const;
+    Iterator end()   const;
+
+private:
+    struct Segment;   // one mapped segment file
+
+    TapeConfig                 cfg_;
+    std::unique_ptr<Record[]>  ring_;
+    size_t                     mask_;
+    uint64_t                   total_{0};
+    uint64_t                   first_id_{0};
+    std::unique_ptr<Segment>   writer_;          // segment being filled
+    uint64_t                   writer_seg_{0};
+    uint64_t                   oldest_seg_{0};   // oldest retained segment file
+
+    uint64_t    ringFirst() const noexcept { return total_ > mask_ ? total_ - mask_ - 1 : 0; }
+    void        spill(const Record& r) noexcept;
+    bool        rotate(uint64_t seg) noexcept;
+    std::string segmentPath(uint64_t seg) const;
+    Trade       toTrade(uint64_t seq, const Record& r) const noexcept {
+        return Trade{first_id_ + seq, r.buy_order_id, r.sell_order_id,
+                     r.price, r.quantity, r.timestamp_ns};
+    }
+    const Record* spilled(uint64_t seq, std::shared_ptr<const Segment>& cache) const;
+
+    friend class Iterator;
+};
+
+// Input iterator yielding Trade by value, oldest first. Keeps the segment
+// it is reading mapped, so walking a spilled range maps each file once.
+class TradeTape::Iterator {
+public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = Trade;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = void;
+    using reference         = Trade;
+
+    Iterator() = default;
+
+    Trade operator*() const;
+    Iterator& operator++() noexcept { ++seq_; return *this; }
+    Iterator  operator++(int) noexcept { Iterator it = *this; ++seq_; return it; }
+
+    bool operator==(const Iterator& o) const noexcept { return seq_ == o.seq_; }
+    bool operator!=(const Iterator& o) const noexcept { return seq_ != o.seq_; }
+
+private:
+    friend class TradeTape;
+    Iterator(const TradeTape* tape, uint64_t seq) : tape_(tape), seq_(seq) {}
+
+    const TradeTape*                        tape_{nullptr};
+    uint64_t                                seq_{0};
+    mutable std::shared_ptr<const Segment>  cache_;
+};
+
+inline TradeTape::Iterator TradeTape::begin() const { return Iterator(this, firstSeq()); }
+inline TradeTape::Iterator TradeTape::end()   const { return Iterator(this, total_); }
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// Consumer wait strategies
+//
+// How a single consumer thread waits for its queue to fill. A strategy is a
+// template parameter of the consumer (see ConcurrentMatchingEngine), so the
+// calls below inline and a strategy that needs no producer wakeup costs
+// producers nothing. Each strategy provides
+//
+//   template <typename Ready> void idle(Ready ready);
+//       The consumer found the queue empty. Waits a little, or until
+//       ready() might be true, and returns so the consumer polls again.
+//   void busy() noexcept;       The consumer got work: reset any backoff.
+//   void notify() noexcept;     A producer has published an item.
+//   WaitStats stats() const;    Counters, readable from any thread.
+//
+// Only SpinParkWait uses ready() and notify(); the others poll.
+// ---------------------------------------------------------------------------
+
+struct WaitStats {
+    uint64_t idle_spins{0};   // pause iterations while the queue was empty
+    uint64_t yields{0};       // sched_yield calls
+    uint64_t sleeps{0};       // timed sleeps (BackoffWait)
+    uint64_t parks{0};        // futex waits entered (SpinParkWait)
+    uint64_t wakeups{0};      // futex wakes issued by producers (SpinParkWait)
+};
+
+namespace wait_detail {
+
+inline void pause() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// Consumer-only counter, read by others: a relaxed store, not an RMW.
+inline void bump(std::atomic<uint64_t>& c, uint64_t by = 1) noexcept {
+    c.store(c.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+inline uint64_t get(const std::atomic<uint64_t>& c) noexcept {
+    return c.load(std::memory_order_relaxed);
+}
+
+} // namespace wait_detail
+
+// Never gives up the core: lowest wake-up latency, one core at 100 %.
+class BusySpinWait {
+public:
+    static constexpr const char* NAME = "busy_spin";
+
+    template <typename Ready>
+    void idle(Ready) noexcept {
+        wait_detail::pause();
+        wait_detail::bump(spins_);
+    }
+    void busy() noexcept {}
+    void notify() noexcept {}
+
+    WaitStats stats() const noexcept {
+        WaitStats s;
+        s.idle_spins = wait_detail::get(spins_);
+        return s;
+    }
+
+private:
+    std::atomic<uint64_t> spins_{0};
+};
+
+// Spins SPIN_LIMIT times, then yields on every idle poll until work
+// arrives. Close to busy-spin latency when the core is free; on a busy
+// machine the yield lets producers run, at the cost of scheduler jitter.
+class SpinYieldWait {
+public:
+    static constexpr const char*  NAME       = "spin_yield";
+    static constexpr uint32_t     SPIN_LIMIT = 1024;
+
+    template <typename Ready>
+    void idle(Ready) noexcept {
+        if (idle_ < SPIN_LIMIT) {
+            ++idle_;
+            wait_detail::pause();
+            wait_detail::bump(spins_);
+        } else {
+            std::this_thread::yield();
+            wait_detail::bump(yields_);
+        }
+    }
+    void busy() noexcept { idle_ = 0; }
+    void notify() noexcept {}
+
+    WaitStats stats() const noexcept {
+        WaitStats s;
+        s.idle_spins = wait_detail::get(spins_);
+        s.yields     = wait_detail::get(yields_);
+        return s;
+    }
+
+private:
+    uint32_t              idle_{0};
+    std::atomic<uint64_t> spins_{0};
+    std::atomic<uint64_t> yields_{0};
+};
+
+// Spins SPIN_LIMIT times, then parks the consumer on a futex until a
+// producer publishes. The consumer announces itself in parked_ and
+// re-checks ready() before sleeping; a producer, after publishing, checks
+// parked_ and wakes it. Both sides put a full fence between their store and
+// their load, so either the consumer sees the item or the producer sees the
+// flag. An idle consumer uses no CPU, and producers pay one fence per
+// notify() plus a syscall only when the consumer is actually parked.
+// Off Linux the park is a yield.
+class SpinParkWait {
+public:
+    static constexpr const char* NAME       = "spin_park";
+    static constexpr uint32_t    SPIN_LIMIT = 1024;
+
+    template <typename Ready>
+    void idle(Ready ready) noexcept {
+        if (idle_ < SPIN_LIMIT) {
+            ++idle_;
+            wait_detail::pause();
+            wait_detail::bump(spins_);
+            return;
+        }
+        parked_.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            wait_detail::bump(parks_);
+            sleep();
+        }
+        parked_.store(0, std::memory_order_relaxed);
+    }
+    void busy() noexcept { idle_ = 0; }
+
+    void notify() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_.load(std::memory_order_relaxed) &&
+            parked_.exchange(0, std::memory_order_relaxed)) {
+            wakeups_.fetch_add(1, std::memory_order_relaxed);
+            wake();
+        }
+    }
+
+    WaitStats stats() const noexcept {
+        WaitStats s;
+        s.idle_spins = wait_detail::get(spins_);
+        s.parks      = wait_detail::get(parks_);
+        s.wakeups    = wait_detail::get(wakeups_);
+        return s;
+    }
+
+private:
+    uint32_t              idle_{0};
+    std::atomic<uint64_t> spins_{0};
+    std::atomic<uint64_t> parks_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    alignas(64) std::atomic<uint32_t> parked_{0};
+
+    // Returns on a wake, a signal, or if parked_ was already cleared.
+    void sleep() noexcept {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&parked_), FUTEX_WAIT_PRIVATE, 1,
+                nullptr, nullptr, 0);
+#else
+        std::this_thread::yield();
+#endif
+    }
+    void wake() noexcept {
+#ifdef __linux__
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&parked_), FUTEX_WAKE_PRIVATE, 1,
+                nullptr, nullptr, 0);
+#endif
+    }
+};
+
+// Spins SPIN_LIMIT times, then sleeps for a period that doubles on each
+// empty poll from MIN_SLEEP_NS up to MAX_SLEEP_NS. Bounded CPU with no
+// producer involvement; the price is up to MAX_SLEEP_NS of added latency
+// for the first event after a quiet spell.
+class BackoffWait {
+public:
+    static constexpr const char* NAME         = "backoff";
+    static constexpr uint32_t    SPIN_LIMIT   = 1024;
+    static constexpr int64_t     MIN_SLEEP_NS = 1'000;
+    static constexpr int64_t     MAX_SLEEP_NS = 200'000;
+
+    template <typename Ready>
+    void idle(Ready) noexcept {
+        if (idle_ < SPIN_LIMIT) {
+            ++idle_;
+            wait_detail::pause();
+            wait_detail::bump(spins_);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns_));
+        wait_detail::bump(sleeps_);
+        sleep_ns_ = std::min(sleep_ns_ * 2, MAX_SLEEP_NS);
+    }
+    void busy() noexcept {
+        idle_     = 0;
+        sleep_ns_ = MIN_SLEEP_NS;
+    }
+    void notify() noexcept {}
+
+    WaitStats stats() const noexcept {
+        WaitStats s;
+        s.idle_spins = wait_detail::get(spins_);
+        s.sleeps     = wait_detail::get(sleeps_);
+        return s;
+    }
+
+private:
+    uint32_t              idle_{0};
+    int64_t               sleep_ns_{MIN_SLEEP_NS};
+    std::atomic<uint64_t> spins_{0};
+    std::atomic<uint64_t> sleeps_{0};
+};
@@ -0,0 +1,72 @@
+#include "clock.h"
+#include <thread>
+
+#ifdef LOB_HAVE_RDTSC
+#include <cpuid.h>
+#endif
+
+TscClock::Calibration TscClock::calibrate() noexcept {
+    Calibration c;
+#ifdef LOB_HAVE_RDTSC
+    // CPUID 0x80000007 EDX bit 8: the TSC ticks at a constant rate across
+    // P-states and C-states and is synchronised between cores.
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) || !(edx & (1u << 8)))
+        return c;
+
+    // Bracket a short busy wait with paired reads; the TSC read sits between
+    // two steady_clock reads so each pair is as tight as it can be.
+    auto sample = [](uint64_t& tsc, int64_t& ns) {
+        int64_t before = SteadyClock::now();
+        tsc = __rdtsc();
+        int64_t after = SteadyClock::now();
+        ns = before + (after - before) / 2;
+    };
+    uint64_t t0, t1;
+    int64_t  n0, n1;
+    sample(t0, n0);
+    while (SteadyClock::now() - n0 < 5'000'000) {}
+    sample(t1, n1);
+    if (t1 <= t0 || n1 <= n0) return c;
+
+    c.tsc0      = t0;
+    c.ns0       = n0;
+    c.mult      = static_cast<uint64_t>(
+                      (static_cast<Wide>(n1 - n0) << 32) / (t1 - t0));
+    c.invariant = true;
+#endif
+    return c;
+}
+
+namespace {
+
+// Owns the refresh thread. Its static instance is destroyed at exit, which
+// stops and joins the thread.
+struct CoarseRefresher {
+    std::atomic<bool> stop{false};
+    std::thread       thread;
+
+    explicit CoarseRefresher(std::atomic<int64_t>& ns) : thread([this, &ns] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(CoarseClock::RESOLUTION_NS));
+            ns.store(SteadyClock::now(), std::memory_order_relaxed);
+        }
+    }) {}
+
+    ~CoarseRefresher() {
+        stop.store(true, std::memory_order_relaxed);
+        thread.join();
+    }
+};
+
+} // namespace
+
+bool CoarseClock::start() noexcept {
+    ns_.store(SteadyClock::now(), std::memory_order_relaxed);
+    try {
+        static CoarseRefresher refresher(ns_);
+    } catch (...) {   // std::system_error: no thread available
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,83 @@
+#include "huge_pages.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+const char* pageBackingName(PageBacking backing) noexcept {
+    switch (backing) {
+    case PageBacking::HEAP:             return "heap";
+    case PageBacking::NORMAL:           return "4k pages";
+    case PageBacking::TRANSPARENT_HUGE: return "thp";
+    case PageBacking::HUGETLB:          return "hugetlb";
+    }
+    return "?";
+}
+
+#ifdef __linux__
+
+namespace {
+
+void* mapAnonymous(size_t bytes, int extra_flags) {
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | extra_flags, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+// One write per base page. Anonymous memory reads as zero, so writing zero
+// changes nothing but takes the fault.
+void touchPages(void* base, size_t bytes) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto*  p    = static_cast<volatile unsigned char*>(base);
+    for (size_t off = 0; off < bytes; off += page) p[off] = 0;
+}
+
+} // namespace
+
+PageRegion mapRegion(size_t bytes, bool huge, bool prefault) {
+    if (bytes == 0) bytes = 1;
+    int populate = prefault ? MAP_POPULATE : 0;
+
+    if (!huge) {
+        void* p = mapAnonymous(bytes, populate);
+        if (!p) throw std::bad_alloc();
+        return {p, bytes, PageBacking::NORMAL};
+    }
+
+    bytes = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    if (void* p = mapAnonymous(bytes, MAP_HUGETLB | populate))
+        return {p, bytes, PageBacking::HUGETLB};
+
+    // Over-map by one huge page and trim, so the region starts on a 2 MiB
+    // boundary and every 2 MiB of it can be one transparent huge page.
+    void* raw = mapAnonymous(bytes + HUGE_PAGE_BYTES, 0);
+    if (!raw) throw std::bad_alloc();
+    auto addr    = reinterpret_cast<uintptr_t>(raw);
+    auto aligned = (addr + HUGE_PAGE_BYTES - 1) & ~(uintptr_t{HUGE_PAGE_BYTES} - 1);
+    if (aligned > addr) munmap(raw, aligned - addr);
+    size_t tail = (addr + bytes + HUGE_PAGE_BYTES) - (aligned + bytes);
+    if (tail) munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+
+    void*       base    = reinterpret_cast<void*>(aligned);
+    PageBacking backing = madvise(base, bytes, MADV_HUGEPAGE) == 0
+                        ? PageBacking::TRANSPARENT_HUGE : PageBacking::NORMAL;
+    if (prefault) touchPages(base, bytes);
+    return {base, bytes, backing};
+}
+
+void unmapRegion(const PageRegion& region) noexcept {
+    if (region.base) munmap(region.base, region.bytes);
+}
+
+#else
+
+PageRegion mapRegion(size_t bytes, bool, bool) {
+    return {::operator new(bytes ? bytes : 1), bytes, PageBacking::HEAP};
+}
+
+void unmapRegion(const PageRegion& region) noexcept {
+    ::operator delete(region.base);
+}
+
+#endif
@@ -0,0 +1,508 @@
+#include "journal.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[8] = {'L', 'O', 'B', 'J', 'R', 'N', 'L', '1'};
+
+struct SegmentHeader {
+    char     magic[8];
+    uint64_t first_seq;
+    uint64_t capacity;
+    uint64_t record_size;
+    uint64_t reserved[4];
+};
+static_assert(sizeof(SegmentHeader) == 64, "segment header must stay 64 bytes");
+
+std::string segmentPath(const std::string& dir, uint64_t index) {
+    return dir + "/journal-" + std::to_string(index) + ".seg";
+}
+
+// Indices of the journal-<n>.seg files in dir, ascending.
+std::vector<uint64_t> listSegments(const std::string& dir) {
+    DIR* d = ::opendir(dir.c_str());
+    if (!d)
+        throw std::system_error(errno, std::generic_category(), "Journal: cannot list " + dir);
+    std::vector<uint64_t> indices;
+    while (dirent* ent = ::readdir(d)) {
+        const char* name = ent->d_name;
+        size_t      len  = std::strlen(name);
+        if (len <= 12 || std::strncmp(name, "journal-", 8) != 0 ||
+            std::strcmp(name + len - 4, ".seg") != 0)
+            continue;
+        char*    end   = nullptr;
+        uint64_t index = std::strtoull(name + 8, &end, 10);
+        if (end == name + len - 4) indices.push_back(index);
+    }
+    ::closedir(d);
+    std::sort(indices.begin(), indices.end());
+    return indices;
+}
+
+int syncDirectory(const std::string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return errno;
+    int err = ::fsync(fd) == 0 ? 0 : errno;
+    ::close(fd);
+    return err;
+}
+
+size_t pageSize() {
+    static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+// msync the whole pages covering [p, p + bytes).
+bool syncRange(const void* p, size_t bytes) {
+    auto addr = reinterpret_cast<uintptr_t>(p);
+    auto lo   = addr & ~(uintptr_t{pageSize()} - 1);
+    return ::msync(reinterpret_cast<void*>(lo), addr + bytes - lo, MS_SYNC) == 0;
+}
+
+// Moves a up to v, never down. durable_ is advanced by the writer under
+// PER_EVENT and by the journal thread, in either order.
+void raiseTo(std::atomic<uint64_t>& a, uint64_t v) noexcept {
+    uint64_t cur = a.load(std::memory_order_relaxed);
+    while (cur < v && !a.compare_exchange_weak(cur, v, std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+}
+
+} // namespace
+
+const char* durabilityName(Durability d) noexcept {
+    switch (d) {
+    case Durability::MAPPED:       return "mapped";
+    case Durability::GROUP_COMMIT: return "group commit";
+    case Durability::PER_EVENT:    return "per event";
+    }
+    return "?";
+}
+
+// One segment file mapped in full: read-write at its preallocated size for
+// the writer, read-only at whatever size is on disk for a reader.
+struct Journal::Segment {
+    std::string path;
+    uint64_t    index{0};
+    uint64_t    first{0};      // sequence of record 0
+    uint64_t    capacity{0};   // records the mapping holds
+    void*       base{MAP_FAILED};
+    size_t      length{0};
+
+    ~Segment() { if (base != MAP_FAILED) ::munmap(base, length); }
+
+    SegmentHeader* header() const { return static_cast<SegmentHeader*>(base); }
+    Entry*         records() const {
+        return reinterpret_cast<Entry*>(static_cast<char*>(base) + sizeof(SegmentHeader));
+    }
+    uint64_t last() const { return first + capacity - 1; }
+
+    // Number of valid records from the start of the segment.
+    uint64_t validPrefix() const {
+        uint64_t n = 0;
+        while (n < capacity && records()[n].sequence == first + n &&
+               records()[n].checksum == checksum(records()[n]))
+            ++n;
+        return n;
+    }
+
+    // Maps an existing segment file, or returns nullptr with errno set.
+    static std::shared_ptr<Segment> open(const std::string& path, uint64_t index, bool writable) {
+        int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st{};
+        auto seg   = std::make_shared<Segment>();
+        seg->path  = path;
+        seg->index = index;
+        if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SegmentHeader)) {
+            seg->length = static_cast<size_t>(st.st_size);
+            seg->base   = ::mmap(nullptr, seg->length,
+                                 writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                                 MAP_SHARED, fd, 0);
+        } else {
+            errno = EINVAL;
+        }
+        ::close(fd);
+        if (seg->base == MAP_FAILED) return nullptr;
+
+        const SegmentHeader* h = seg->header();
+        if (std::memcmp(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+            h->record_size != sizeof(Entry) || h->first_seq == 0) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        seg->first    = h->first_seq;
+        seg->capacity = std::min<uint64_t>(h->capacity,
+                                           (seg->length - sizeof(SegmentHeader)) / sizeof(Entry));
+        return seg;
+    }
+};
+
+uint32_t Journal::checksum(const Entry& e) noexcept {
+    // FNV-1a over the 60 bytes before the checksum, a word at a time.
+    unsigned char bytes[sizeof(Entry)];
+    std::memcpy(bytes, &e, sizeof(Entry));
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (size_t off = 0; off < 56; off += 8) {
+        uint64_t w;
+        std::memcpy(&w, bytes + off, 8);
+        h = (h ^ w) * 0x100000001b3ULL;
+    }
+    uint32_t tail;
+    std::memcpy(&tail, bytes + 56, 4);
+    h = (h ^ tail) * 0x100000001b3ULL;
+    return static_cast<uint32_t>(h ^ (h >> 32));
+}
+
+Journal::Journal(const JournalConfig& cfg)
+    : cfg_(cfg)
+{
+    cfg_.segment_records    = std::max<size_t>(cfg_.segment_records, 1);
+    cfg_.commit_events      = std::max<size_t>(cfg_.commit_events, 1);
+    cfg_.commit_interval_us = std::max<int64_t>(cfg_.commit_interval_us, 1);
+    resume();
+    thread_ = std::thread(&Journal::run, this);
+    kick();   // prepare the next segment now
+}
+
+Journal::~Journal() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+    if (spare_) ::unlink(spare_->path.c_str());   // never written
+}
+
+// Continues the journal already in the directory, if any. Empty segments
+// past the last record are removed, and the rest of the last segment is
+// zeroed so no stale record can follow the ones appended from here on.
+void Journal::resume() {
+    std::vector<uint64_t> indices = listSegments(cfg_.dir);
+    while (!indices.empty()) {
+        uint64_t index = indices.back();
+        std::string path = segmentPath(cfg_.dir, index);
+        auto seg = Segment::open(path, index, true);
+        if (!seg)
+            throw std::system_error(errno, std::generic_category(), "Journal: cannot open " + path);
+        uint64_t n = seg->validPrefix();
+        if (n == 0 && indices.size() > 1) {
+            ::unlink(path.c_str());
+            indices.pop_back();
+            continue;
+        }
+        Entry* tail = seg->records() + n;
+        std::memset(static_cast<void*>(tail), 0, (seg->capacity - n) * sizeof(Entry));
+        syncRange(tail, (seg->capacity - n) * sizeof(Entry));
+
+        next_seq_  = seg->first + n;
+        kicked_at_ = next_seq_ - 1;
+        appended_.store(next_seq_ - 1, std::memory_order_relaxed);
+        durable_.store(next_seq_ - 1, std::memory_order_relaxed);
+        current_ = seg.get();
+        open_.push_back(std::move(seg));
+        return;
+    }
+
+    auto seg = create(0, 1);
+    current_ = seg.get();
+    open_.push_back(std::move(seg));
+}
+
+// Creates, preallocates and maps a segment and makes its header and
+// directory entry durable. Throws std::system_error.
+std::shared_ptr<Journal::Segment> Journal::create(uint64_t index, uint64_t first_seq) {
+    std::string path = segmentPath(cfg_.dir, index);
+    auto seg      = std::make_shared<Segment>();
+    seg->path     = path;
+    seg->index    = index;
+    seg->first    = first_seq;
+    seg->capacity = cfg_.segment_records;
+    seg->length   = sizeof(SegmentHeader) + cfg_.segment_records * sizeof(Entry);
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    int err = 0;
+    if (fd < 0) {
+        err = errno;
+    } else {
+        err = ::posix_fallocate(fd, 0, static_cast<off_t>(seg->length));
+        if (err == 0) {
+            seg->base = ::mmap(nullptr, seg->length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, fd, 0);
+            if (seg->base == MAP_FAILED) err = errno;
+        }
+        ::close(fd);
+    }
+    if (err == 0) {
+        SegmentHeader* h = seg->header();
+        std::memcpy(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        h->first_seq   = first_seq;
+        h->capacity    = cfg_.segment_records;
+        h->record_size = sizeof(Entry);
+        if (!syncRange(h, sizeof(SegmentHeader))) err = errno;
+        else                                      err = syncDirectory(cfg_.dir);
+    }
+    if (err != 0) {
+        seg.reset();
+        ::unlink(path.c_str());
+        throw std::system_error(err, std::generic_category(), "Journal: cannot create " + path);
+    }
+    segments_.fetch_add(1, std::memory_order_relaxed);
+    return seg;
+}
+
+uint64_t Journal::append(Entry e) {
+    if (next_seq_ - current_->first >= current_->capacity) rotate();
+
+    uint64_t seq = next_seq_;
+    e.sequence   = seq;
+    std::memset(e.reserved0, 0, sizeof(e.reserved0));
+    e.reserved1  = 0;
+    e.checksum   = checksum(e);
+    Entry* slot  = current_->records() + (seq - current_->first);
+    *slot        = e;
+    ++next_seq_;
+    appended_.store(seq, std::memory_order_release);
+
+    switch (cfg_.durability) {
+    case Durability::PER_EVENT:
+        if (!syncRange(slot, sizeof(Entry))) {
+            // Take the entry back out, so the caller can refuse the event
+            // without the journal holding one the book never saw.
+            // The journal thread may have committed it meanwhile; under
+            // the lock, so its commit cannot land in between, pull
+            // durable_ back below the sequence the next entry will reuse.
+            int err = errno;
+            std::memset(slot, 0, sizeof(Entry));
+            --next_seq_;
+            {
+                std::lock_guard<std::mutex> lock(mu_);
+                appended_.store(seq - 1, std::memory_order_release);
+                uint64_t d = durable_.load(std::memory_order_relaxed);
+                while (d > seq - 1 && !durable_.compare_exchange_weak(d, seq - 1,
+                                                                      std::memory_order_release,
+                                                                      std::memory_order_relaxed)) {}
+            }
+            throw std::system_error(err, std::generic_category(), "Journal: msync failed");
+        }
+        commits_.fetch_add(1, std::memory_order_relaxed);
+        raiseTo(durable_, seq);
+        break;
+    case Durability::GROUP_COMMIT:
+        if (seq - kicked_at_ >= cfg_.commit_events) {
+            kicked_at_ = seq;
+            kick();
+        }
+        break;
+    case Durability::MAPPED:
+        break;
+    }
+    return seq;
+}
+
+// The current segment is full: switch to the spare the journal thread
+// prepared, waiting for it if it is still being made.
+void Journal::rotate() {
+    std::unique_lock<std::mutex> lock(mu_);
+    if (!spare_) {
+        prepare_errno_ = 0;
+        kick_          = true;
+        wake_.notify_one();
+        prepared_.wait(lock, [this] { return spare_ || prepare_errno_ != 0; });
+        if (!spare_)
+            throw std::system_error(prepare_errno_, std::generic_category(),
+                                    "Journal: cannot create segment " +
+                                    std::to_string(current_->index + 1));
+    }
+    open_.push_back(std::move(spare_));
+    current_ = open_.back().get();
+    kick_    = true;   // prepare the one after, release the old one
+    wake_.notify_one();
+}
+
+void Journal::kick() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        kick_ = true;
+    }
+    wake_.notify_one();
+}
+
+void Journal::sync() {
+    uint64_t target = appended_.load(std::memory_order_acquire);
+    if (durable_.load(std::memory_order_acquire) >= target) return;
+
+    std::unique_lock<std::mutex> lock(mu_);
+    commit_errno_ = 0;
+    sync_         = true;
+    kick_         = true;
+    wake_.notify_one();
+    committed_.wait(lock, [&] {
+        return durable_.load(std::memory_order_acquire) >= target || commit_errno_ != 0;
+    });
+    if (durable_.load(std::memory_order_acquire) < target)
+        throw std::system_error(commit_errno_, std::generic_category(), "Journal: msync failed");
+}
+
+Journal::Stats Journal::stats() const noexcept {
+    return Stats{appended_.load(std::memory_order_acquire),
+                 durable_.load(std::memory_order_acquire),
+                 commits_.load(std::memory_order_relaxed),
+                 segments_.load(std::memory_order_relaxed)};
+}
+
+// msyncs the records in (durableSequence(), upto]. Journal thread only.
+// upto is capped at what is appended when the commit is published, so an
+// entry taken back by a failed PER_EVENT append is never counted durable.
+bool Journal::commit(uint64_t upto) {
+    upto = std::min(upto, appended_.load(std::memory_order_acquire));
+    uint64_t from = durable_.load(std::memory_order_acquire) + 1;
+    if (from > upto) return true;
+
+    std::vector<std::shared_ptr<Segment>> segs;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        segs.assign(open_.begin(), open_.end());
+    }
+    for (const auto& s : segs) {
+        uint64_t lo = std::max(from, s->first);
+        uint64_t hi = std::min(upto, s->last());
+        if (lo > hi) continue;
+        if (!syncRange(s->records() + (lo - s->first), (hi - lo + 1) * sizeof(Entry)))
+            return false;
+    }
+    commits_.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mu_);
+    raiseTo(durable_, std::min(upto, appended_.load(std::memory_order_acquire)));
+    return true;
+}
+
+// The journal thread: prepares the next segment, commits, and unmaps
+// segments the writer has left once they are committed. Under
+// GROUP_COMMIT it commits everything appended on every wake-up; under the
+// other levels only a segment the writer has left, or on sync() and
+// shutdown.
+void Journal::run() {
+    const auto interval = std::chrono::microseconds(cfg_.commit_interval_us);
+    std::unique_lock<std::mutex> lock(mu_);
+    for (;;) {
+        auto woken = [this] { return kick_ || stop_; };
+        if (cfg_.durability == Durability::GROUP_COMMIT) wake_.wait_for(lock, interval, woken);
+        else                                             wake_.wait(lock, woken);
+        kick_         = false;
+        bool stopping = stop_;
+        bool syncing  = sync_;
+        sync_         = false;
+
+        if (!spare_ && !stopping) {
+            const Segment& back = *open_.back();
+            uint64_t index = back.index + 1;
+            uint64_t first = back.first + back.capacity;
+            lock.unlock();
+            std::shared_ptr<Segment> seg;
+            int err = 0;
+            try {
+                seg = create(index, first);
+            } catch (const std::system_error& e) {
+                err = e.code().value();
+            }
+            lock.lock();
+            spare_         = std::move(seg);
+            prepare_errno_ = err;
+            prepared_.notify_all();
+        }
+
+        uint64_t target = 0;
+        if (open_.size() > 1) target = open_[open_.size() - 2]->last();
+        if (cfg_.durability == Durability::GROUP_COMMIT || syncing || stopping)
+            target = appended_.load(std::memory_order_acquire);
+
+        lock.unlock();
+        bool ok = commit(target);
+        int  err = ok ? 0 : errno;
+        lock.lock();
+        if (!ok) commit_errno_ = err;
+        uint64_t durable = durable_.load(std::memory_order_acquire);
+        while (open_.size() > 1 && open_.front()->last() <= durable) open_.pop_front();
+        committed_.notify_all();
+
+        if (stopping) return;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// JournalReader
+// ---------------------------------------------------------------------------
+
+JournalReader::JournalReader(const std::string& dir)
+    : dir_(dir)
+{
+    std::vector<uint64_t> indices = listSegments(dir_);
+    indices_.assign(indices.begin(), indices.end());
+}
+
+JournalReader::~JournalReader() = default;
+
+// Maps the next segment to read, skipping any that end before from_.
+bool JournalReader::openNext() {
+    while (indices_.size() > 1 && from_ > 0) {
+        // Peek at the following segment's first sequence without mapping.
+        SegmentHeader h{};
+        int fd = ::open(segmentPath(dir_, indices_[1]).c_str(), O_RDONLY);
+        if (fd < 0) break;
+        ssize_t got = ::pread(fd, &h, sizeof(h), 0);
+        ::close(fd);
+        if (got != static_cast<ssize_t>(sizeof(h)) || h.first_seq > from_) break;
+        indices_.pop_front();
+    }
+    if (indices_.empty()) return false;
+
+    uint64_t    index = indices_.front();
+    std::string path  = segmentPath(dir_, index);
+    indices_.pop_front();
+    seg_ = Journal::Segment::open(path, index, false);
+    if (!seg_)
+        throw std::system_error(errno, std::generic_category(), "Journal: cannot read " + path);
+    if (expect_ != 0 && seg_->first != expect_) {   // gap: a segment is missing
+        seg_.reset();
+        indices_.clear();
+        return false;
+    }
+    slot_ = from_ > seg_->first ? static_cast<size_t>(std::min(from_ - seg_->first,
+                                                               seg_->capacity))
+                                : 0;
+    return true;
+}
+
+bool JournalReader::next(Journal::Entry& out) {
+    for (;;) {
+        if (!seg_ && !openNext()) return false;
+        if (slot_ >= seg_->capacity) {   // segment read to its end
+            expect_ = seg_->first + seg_->capacity;
+            seg_.reset();
+            continue;
+        }
+        const Journal::Entry& r = seg_->records()[slot_];
+        if (r.sequence != seg_->first + slot_ || r.checksum != Journal::checksum(r)) {
+            seg_.reset();   // end of the log
+            indices_.clear();
+            return false;
+        }
+        ++slot_;
+        if (r.sequence < from_) continue;
+        out = r;
+        return true;
+    }
+}
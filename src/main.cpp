@@ -1,6 +1,8 @@
 #include "matching_engine.h"
+#include "thread_placement.h"
 #include <iostream>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 static void runIcebergDemo() {
@@ -45,17 +47,25 @@ static void runStopLossDemo() {
 
 static void runMultiThreaded() {
     std::cout << "\n=== Multi-threaded demo ===\n";
-    MatchingEngine engine(false);
+    // Several submitting threads need a locking policy, whatever the build default.
+    using SharedEngine = std::conditional_t<DefaultLockPolicy::concurrent, MatchingEngine,
+                                            BasicMatchingEngine<SharedMutexPolicy>>;
+    SharedEngine engine(false);
+
+    // Submitting threads get fixed cores so that none migrates mid-run.
+    ThreadPlacement placement = ThreadPlacement::pinned(4);
 
     std::vector<std::thread> threads;
     for (int t = 0; t < 2; ++t)
         threads.emplace_back([&, t]() {
+            pinCurrentThread(placement.producerCore(static_cast<size_t>(t)));
             for (int i = 0; i < 50; ++i)
                 engine.submitLimit(Side::BUY,
                     static_cast<int64_t>(990000 - t * 5000 - i * 1000), 10);
         });
     for (int t = 0; t < 2; ++t)
         threads.emplace_back([&, t]() {
+            pinCurrentThread(placement.producerCore(static_cast<size_t>(t + 2)));
             for (int i = 0; i < 50; ++i)
                 engine.submitLimit(Side::SELL,
                     static_cast<int64_t>(1010000 + t * 5000 + i * 1000), 10);
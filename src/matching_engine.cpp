@@ -1,20 +1,21 @@
 #include "matching_engine.h"
-#include <chrono>
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <system_error>
 
-MatchingEngine::MatchingEngine(bool verbose)
-    : pool_(1024), verbose_(verbose)
-{}
-
-int64_t MatchingEngine::nowUs() const {
-    using namespace std::chrono;
-    return duration_cast<microseconds>(
-        steady_clock::now().time_since_epoch()
-    ).count();
+template <typename LockPolicy>
+BasicMatchingEngine<LockPolicy>::BasicMatchingEngine(bool verbose, const LadderConfig& ladder,
+                                                      const TapeConfig& tape,
+                                                      const PoolConfig& pool,
+                                                      const JournalConfig& journal)
+    : book_(ladder, pool, tape), verbose_(verbose)
+{
+    if (!journal.dir.empty()) journal_ = std::make_unique<Journal>(journal);
 }
 
-void MatchingEngine::logTrades(const std::vector<Trade>& trades) const {
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::logTrades(const std::vector<Trade>& trades) const {
     if (trades.empty()) {
         std::cout << "  No trades matched.\n";
         return;
@@ -28,9 +29,26 @@ void MatchingEngine::logTrades(const std::vector<Trade>& trades) const {
     }
 }
 
-uint64_t MatchingEngine::submitLimit(Side side, int64_t price, uint64_t qty) {
-    uint64_t id = nextId();
-    int64_t  ts = nowUs();
+// Quiet engines match through a NullSink and never touch a trade vector.
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::route(Order* order) {
+    if (!verbose_) {
+        NullSink sink;
+        book_.match(order, sink);
+        return;
+    }
+    std::vector<Trade> trades;
+    TradeCollector     sink{trades};
+    book_.match(order, sink);
+    logTrades(trades);
+}
+
+template <typename LockPolicy>
+uint64_t BasicMatchingEngine<LockPolicy>::submitLimit(Side side, int64_t price, uint64_t qty) {
+    auto     lock = journalLock();
+    uint64_t id   = nextId();
+    int64_t  ts   = nowNs();
+    record(Journal::Op::LIMIT, side, id, price, qty, ts);
 
     if (verbose_) {
         std::cout << "[LIMIT " << (side == Side::BUY ? "BUY " : "SELL")
@@ -40,18 +58,16 @@ uint64_t MatchingEngine::submitLimit(Side side, int64_t price, uint64_t qty) {
                   << "  qty=" << qty << "\n";
     }
 
-    Order* raw  = pool_.allocate(id, ts, side, OrderKind::LIMIT, price, qty);
-    auto order  = std::shared_ptr<Order>(raw, PoolDeleter<Order>(&pool_));
-    auto trades = book_.match(order);
-
-    if (verbose_) logTrades(trades);
-
+    route(book_.newOrder(id, ts, side, OrderKind::LIMIT, price, qty));
     return id;
 }
 
-void MatchingEngine::submitMarket(Side side, uint64_t qty) {
-    uint64_t id = nextId();
-    int64_t  ts = nowUs();
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::submitMarket(Side side, uint64_t qty) {
+    auto     lock = journalLock();
+    uint64_t id   = nextId();
+    int64_t  ts   = nowNs();
+    record(Journal::Op::MARKET, side, id, 0, qty, ts);
 
     if (verbose_) {
         std::cout << "[MARKET " << (side == Side::BUY ? "BUY " : "SELL")
@@ -59,17 +75,17 @@ void MatchingEngine::submitMarket(Side side, uint64_t qty) {
                   << "  qty=" << qty << "\n";
     }
 
-    Order* raw  = pool_.allocate(id, ts, side, OrderKind::MARKET, 0LL, qty);
-    auto order  = std::shared_ptr<Order>(raw, PoolDeleter<Order>(&pool_));
-    auto trades = book_.match(order);
-
-    if (verbose_) logTrades(trades);
+    route(book_.newOrder(id, ts, side, OrderKind::MARKET, 0LL, qty));
 }
 
-uint64_t MatchingEngine::submitIceberg(Side side, int64_t price,
-                                       uint64_t total_qty, uint64_t display_qty) {
-    uint64_t id = nextId();
-    int64_t  ts = nowUs();
+template <typename LockPolicy>
+uint64_t BasicMatchingEngine<LockPolicy>::submitIceberg(Side side, int64_t price,
+                                                        uint64_t total_qty, uint64_t display_qty) {
+    auto     lock = journalLock();
+    uint64_t id   = nextId();
+    int64_t  ts   = nowNs();
+    record(Journal::Op::ICEBERG, side, id, price, total_qty, ts,
+           static_cast<int64_t>(display_qty));
 
     if (verbose_)
         std::cout << "[ICEBERG " << (side == Side::BUY ? "BUY " : "SELL")
@@ -78,17 +94,17 @@ uint64_t MatchingEngine::submitIceberg(Side side, int64_t price,
                   << price / static_cast<double>(PRICE_SCALE)
                   << "  total=" << total_qty << "  visible=" << display_qty << "\n";
 
-    Order* raw  = pool_.allocate(id, ts, side, price, total_qty, display_qty);
-    auto order  = std::shared_ptr<Order>(raw, PoolDeleter<Order>(&pool_));
-    auto trades = book_.match(order);
-    if (verbose_) logTrades(trades);
+    route(book_.newOrder(id, ts, side, price, total_qty, display_qty));
     return id;
 }
 
-uint64_t MatchingEngine::submitStopLoss(Side side, int64_t trigger_price,
-                                        int64_t limit_price, uint64_t qty) {
-    uint64_t id = nextId();
-    int64_t  ts = nowUs();
+template <typename LockPolicy>
+uint64_t BasicMatchingEngine<LockPolicy>::submitStopLoss(Side side, int64_t trigger_price,
+                                                         int64_t limit_price, uint64_t qty) {
+    auto     lock = journalLock();
+    uint64_t id   = nextId();
+    int64_t  ts   = nowNs();
+    record(Journal::Op::STOP_LOSS, side, id, trigger_price, qty, ts, limit_price);
 
     if (verbose_)
         std::cout << "[STOP-LOSS " << (side == Side::BUY ? "BUY " : "SELL")
@@ -100,13 +116,16 @@ uint64_t MatchingEngine::submitStopLoss(Side side, int64_t trigger_price,
                   << "  qty=" << qty << "\n";
 
     // Single allocation — the original code had a double-alloc leak here
-    Order* raw = pool_.allocate(id, ts, side, trigger_price, limit_price, qty);
-    auto order = std::shared_ptr<Order>(raw, PoolDeleter<Order>(&pool_));
-    book_.match(order);   // routes to pending_stops_ until triggered
+    NullSink sink;
+    Order* order = book_.newOrder(id, ts, side, trigger_price, limit_price, qty);
+    book_.match(order, sink);   // parked in the stop ladder until triggered
     return id;
 }
 
-bool MatchingEngine::cancelOrder(uint64_t order_id) {
+template <typename LockPolicy>
+bool BasicMatchingEngine<LockPolicy>::cancelOrder(uint64_t order_id) {
+    auto lock = journalLock();
+    record(Journal::Op::CANCEL, Side::BUY, order_id, 0, 0, nowNs());
     bool ok = book_.cancelOrder(order_id);
     if (verbose_)
         std::cout << "[CANCEL] #" << order_id
@@ -114,19 +133,109 @@ bool MatchingEngine::cancelOrder(uint64_t order_id) {
     return ok;
 }
 
-bool MatchingEngine::modifyOrder(uint64_t order_id, int64_t new_price, uint64_t new_qty) {
-    bool ok = book_.modifyOrder(order_id, new_price, new_qty, nowUs());
+template <typename LockPolicy>
+bool BasicMatchingEngine<LockPolicy>::modifyOrder(uint64_t order_id, int64_t new_price,
+                                                  uint64_t new_qty) {
+    auto    lock = journalLock();
+    int64_t ts   = nowNs();
+    record(Journal::Op::MODIFY, Side::BUY, order_id, new_price, new_qty, ts);
+    bool ok = book_.modifyOrder(order_id, new_price, new_qty, ts);
     if (verbose_)
         std::cout << "[MODIFY] #" << order_id
                   << (ok ? " — modified\n" : " — not found\n");
     return ok;
 }
 
-void MatchingEngine::printBook(int levels)  const { book_.printBook(levels);  }
-void MatchingEngine::printDepth(int levels) const { book_.printDepth(levels); }
-void MatchingEngine::printTrades()          const { book_.printTrades();      }
+template <typename LockPolicy>
+uint64_t BasicMatchingEngine<LockPolicy>::saveSnapshot(const std::string& path) {
+    auto lock = journalLock();
+    SnapshotHeader header{};
+    if (journal_) {
+        journal_->sync();
+        header.journal_sequence = journal_->lastSequence();
+    }
+    header.next_order_id = next_id_;
+
+    SnapshotWriter out(path);
+    book_.saveState(header, out);
+    out.commit();
+    return header.journal_sequence;
+}
+
+template <typename LockPolicy>
+uint64_t BasicMatchingEngine<LockPolicy>::restore(const std::string& snapshot_path,
+                                                  const std::string& journal_dir) {
+    auto lock = journalLock();
+    if (next_id_ != 1 || book_.activeOrders() || book_.pendingStops())
+        throw std::system_error(EBUSY, std::generic_category(), "MatchingEngine: restore into a used engine");
 
-void MatchingEngine::printStats() const {
+    uint64_t covered = 0, next_id = 1;
+    if (!snapshot_path.empty()) {
+        SnapshotReader in(snapshot_path);
+        SnapshotHeader header = book_.loadState(in);
+        covered = header.journal_sequence;
+        next_id = header.next_order_id;
+    }
+
+    std::string dir = !journal_dir.empty() ? journal_dir : journal_ ? journal_->config().dir : "";
+    uint64_t replayed = 0;
+    if (!dir.empty()) {
+        JournalReader reader(dir);
+        reader.skipTo(covered + 1);
+        Journal::Entry e;
+        while (reader.next(e)) {
+            apply(e);
+            if (e.op != Journal::Op::CANCEL && e.op != Journal::Op::MODIFY)
+                next_id = std::max(next_id, e.order_id + 1);
+            ++replayed;
+        }
+    }
+    setNextId(next_id);
+    return replayed;
+}
+
+// One journaled event, exactly as the entry point that logged it ran it.
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::apply(const Journal::Entry& e) {
+    Side     side = e.side == 'B' ? Side::BUY : Side::SELL;
+    NullSink sink;
+    switch (e.op) {
+    case Journal::Op::LIMIT:
+        book_.match(book_.newOrder(e.order_id, e.timestamp_ns, side, OrderKind::LIMIT,
+                                   e.price, e.quantity), sink);
+        break;
+    case Journal::Op::MARKET:
+        book_.match(book_.newOrder(e.order_id, e.timestamp_ns, side, OrderKind::MARKET,
+                                   0LL, e.quantity), sink);
+        break;
+    case Journal::Op::ICEBERG:
+        book_.match(book_.newOrder(e.order_id, e.timestamp_ns, side, e.price, e.quantity,
+                                   static_cast<uint64_t>(e.aux)), sink);
+        break;
+    case Journal::Op::STOP_LOSS:
+        book_.match(book_.newOrder(e.order_id, e.timestamp_ns, side, e.price, e.aux,
+                                   e.quantity), sink);
+        break;
+    case Journal::Op::CANCEL:
+        book_.cancelOrder(e.order_id);
+        break;
+    case Journal::Op::MODIFY:
+        book_.modifyOrder(e.order_id, e.price, e.quantity, e.timestamp_ns);
+        break;
+    }
+}
+
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::printBook(int levels) const { book_.printBook(levels); }
+
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::printDepth(int levels) const { book_.printDepth(levels); }
+
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::printTrades() const { book_.printTrades(); }
+
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::printStats() const {
     std::cout << "\n===== ENGINE STATS =====\n"
               << std::fixed << std::setprecision(2);
 
@@ -146,16 +255,21 @@ void MatchingEngine::printStats() const {
         std::cout << "  Spread        : $"
                   << (static_cast<double>(book_.spread()) / PRICE_SCALE) << "\n";
 
-    std::cout << "  Total trades  : " << book_.tradeHistory().size() << "\n"
+    std::cout << "  Total trades  : " << book_.tradeHistory().totalAppended() << "\n"
               << "========================\n\n";
 }
 
-void MatchingEngine::printPoolStats() const {
-    size_t capacity = pool_.totalCapacity();
-    size_t free_cnt = pool_.freeCount();
+template <typename LockPolicy>
+void BasicMatchingEngine<LockPolicy>::printPoolStats() const {
+    const auto& pool = book_.pool();
     std::cout << "\n===== MEMORY POOL =====\n"
-              << "  Capacity : " << capacity << " slots\n"
-              << "  Free     : " << free_cnt << " slots\n"
-              << "  In use   : " << (capacity - free_cnt) << " slots\n"
+              << "  Capacity : " << pool.totalCapacity() << " slots\n"
+              << "  Free     : " << pool.freeCount() << " slots\n"
+              << "  In use   : " << pool.inUse() << " slots\n"
+              << "  Peak use : " << pool.highWater() << " slots\n"
               << "=======================\n\n";
 }
+
+template class BasicMatchingEngine<SingleWriterPolicy>;
+template class BasicMatchingEngine<TicketLockPolicy>;
+template class BasicMatchingEngine<SharedMutexPolicy>;
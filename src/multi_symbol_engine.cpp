@@ -0,0 +1,194 @@
+#include "multi_symbol_engine.h"
+#include "thread_placement.h"
+
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+MultiSymbolEngine::MultiSymbolEngine(const MultiSymbolConfig& config)
+    : config_(config)
+{
+    if (config_.workers == 0) config_.workers = 1;
+    workers_.reserve(config_.workers);
+    for (size_t w = 0; w < config_.workers; ++w)
+        workers_.push_back(std::make_unique<Worker>());
+}
+
+MultiSymbolEngine::~MultiSymbolEngine() {
+    stop();
+}
+
+uint32_t MultiSymbolEngine::addSymbol(const std::string& name, const LadderConfig& ladder) {
+    if (started_)
+        throw std::logic_error("MultiSymbolEngine: symbols must be added before start()");
+
+    auto it = by_name_.find(name);
+    if (it != by_name_.end()) return it->second;
+
+    uint32_t id     = static_cast<uint32_t>(symbols_.size());
+    Worker&  worker = *workers_[workerOf(id)];
+    TapeConfig tape = config_.tape;
+    if (!tape.spill_dir.empty()) {
+        tape.spill_dir += "/" + name;
+        std::filesystem::create_directories(tape.spill_dir);
+    }
+    symbols_.push_back({name, ladder, tape, worker.symbols.size()});
+    worker.symbols.push_back(id);
+    by_name_.emplace(name, id);
+    return id;
+}
+
+uint32_t MultiSymbolEngine::symbolId(const std::string& name) const {
+    auto it = by_name_.find(name);
+    return it == by_name_.end() ? UNKNOWN_SYMBOL : it->second;
+}
+
+void MultiSymbolEngine::start() {
+    if (started_) return;
+    started_ = true;
+
+    std::atomic<size_t> ready{0};
+    for (size_t w = 0; w < workers_.size(); ++w)
+        workers_[w]->thread = std::thread(&MultiSymbolEngine::workerLoop, this, w, std::ref(ready));
+    while (ready.load(std::memory_order_acquire) != workers_.size())
+        std::this_thread::yield();
+
+    for (auto& w : workers_) {
+        if (!w->failed) continue;
+        enqueueStop();
+        for (auto& j : workers_) j->thread.join();
+        std::rethrow_exception(w->failed);
+    }
+    running_.store(true, std::memory_order_release);
+}
+
+// submitting_ is raised before running_ is checked and stop() clears
+// running_ before waiting for it to fall, both sequentially consistent, so
+// either the submit sees the engine stopped or stop() waits for its
+// enqueue and the stop marker lands behind the event.
+bool MultiSymbolEngine::submit(const OrderEvent& ev) {
+    if (ev.symbol_id >= symbols_.size()) return false;
+    submitting_.fetch_add(1);
+    bool accepted = running_.load();
+    if (accepted) workers_[workerOf(ev.symbol_id)]->queue->enqueue(ev);
+    submitting_.fetch_sub(1, std::memory_order_release);
+    return accepted;
+}
+
+bool MultiSymbolEngine::trySubmit(const OrderEvent& ev) {
+    if (ev.symbol_id >= symbols_.size()) return false;
+    submitting_.fetch_add(1);
+    bool accepted = running_.load() && workers_[workerOf(ev.symbol_id)]->queue->tryEnqueue(ev);
+    submitting_.fetch_sub(1, std::memory_order_release);
+    return accepted;
+}
+
+void MultiSymbolEngine::stop() {
+    if (!running_.exchange(false)) return;
+    while (submitting_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+
+    enqueueStop();
+    for (auto& w : workers_)
+        if (w->thread.joinable()) w->thread.join();
+}
+
+// Every worker that built its queue gets a marker; one that failed before
+// that has already returned.
+void MultiSymbolEngine::enqueueStop() {
+    OrderEvent marker;
+    marker.kind = static_cast<EventKind>(STOP);
+    for (auto& w : workers_)
+        if (w->queue) w->queue->enqueue(marker);
+}
+
+const MultiSymbolEngine::Engine::Book& MultiSymbolEngine::book(uint32_t symbol) const {
+    const Symbol& s = symbols_[symbol];
+    return workers_[workerOf(symbol)]->engines[s.slot]->book();
+}
+
+uint64_t MultiSymbolEngine::eventsProcessed() const {
+    uint64_t total = 0;
+    for (size_t w = 0; w < workers_.size(); ++w) total += eventsProcessed(w);
+    return total;
+}
+
+void MultiSymbolEngine::workerLoop(size_t index, std::atomic<size_t>& ready) {
+    Worker& worker = *workers_[index];
+
+    if (config_.pin_workers)
+        worker.pinned = pinCurrentThread(static_cast<int>(
+            (static_cast<size_t>(config_.first_core) + index) % onlineCores()));
+    worker.node = currentNumaNode();
+    if (worker.pinned && config_.numa_local) preferNumaNode(worker.node);
+
+    // A failure is handed to start(), which stops the other workers and
+    // rethrows it; nothing can have been submitted yet.
+    try {
+        worker.queue = std::make_unique<MpscRing<OrderEvent>>(config_.queue_capacity);
+        worker.engines.reserve(worker.symbols.size());
+        for (uint32_t id : worker.symbols)
+            worker.engines.push_back(
+                std::make_unique<Engine>(false, symbols_[id].ladder, symbols_[id].tape, config_.pool));
+    } catch (...) {
+        worker.failed = std::current_exception();
+        ready.fetch_add(1, std::memory_order_release);
+        return;
+    }
+    ready.fetch_add(1, std::memory_order_release);
+
+    // stop() enqueues the marker behind every accepted event; the worker
+    // still matches until its queue is empty rather than returning on the
+    // marker, so nothing later in the same burst is dropped.
+    constexpr size_t BURST = 64;
+    NullSink   sink;
+    OrderEvent burst[BURST];
+    bool       stopping = false;
+    while (true) {
+        size_t n = worker.queue->dequeueBulk(burst, BURST);
+        if (n == 0) {
+            if (stopping) return;
+            std::this_thread::yield();
+            continue;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            const OrderEvent& ev = burst[i];
+            if (static_cast<uint8_t>(ev.kind) == STOP) {
+                stopping = true;
+                continue;
+            }
+
+            Engine& engine = *worker.engines[symbols_[ev.symbol_id].slot];
+            Side    side   = ev.side == 'B' ? Side::BUY : Side::SELL;
+            switch (ev.kind) {
+            case EventKind::SUBMIT_LIMIT:
+                engine.submitLimit(side, ev.price, ev.quantity, sink);
+                break;
+            case EventKind::SUBMIT_MARKET:
+                engine.submitMarket(side, ev.quantity, sink);
+                break;
+            case EventKind::CANCEL:
+                engine.cancelOrder(ev.order_id);
+                break;
+            }
+
+            worker.processed.store(worker.processed.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+        }
+    }
+}
+
+void MultiSymbolEngine::printStats() const {
+    std::cout << "\n=== Multi-Symbol Engine Stats ===\n"
+              << "  Symbols          : " << symbols_.size() << "\n"
+              << "  Workers          : " << workers_.size() << "\n"
+              << "  Events processed : " << eventsProcessed() << "\n";
+    for (size_t w = 0; w < workers_.size(); ++w) {
+        std::cout << "  worker " << w << " : " << workers_[w]->symbols.size() << " symbols, "
+                  << eventsProcessed(w) << " events"
+                  << (workers_[w]->pinned ? " (pinned)" : "");
+        if (workers_[w]->node >= 0) std::cout << " node " << workers_[w]->node;
+        std::cout << "\n";
+    }
+}
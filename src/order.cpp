@@ -1,73 +1,154 @@
 #include "order.h"
+#include "memory_pool.h"
 #include <algorithm>
 #include <iomanip>
 #include <iostream>
 
-Order::Order(uint64_t id, int64_t timestamp_us, Side side, OrderKind kind,
+namespace {
+
+// Shared by every book. Deliberately never destroyed, so orders held by
+// static objects can still release their extension during exit.
+MemoryPool<OrderExt>& extPool() {
+    static auto* pool = new MemoryPool<OrderExt>(256);
+    return *pool;
+}
+
+} // namespace
+
+Order::Order(uint64_t id, int64_t timestamp_ns, Side side, OrderKind kind,
              int64_t price, uint64_t qty)
-    : id_(id), timestamp_us_(timestamp_us), side_(side), kind_(kind),
-      price_(price), quantity_(qty), leaves_qty_(qty), status_(OrderStatus::ACTIVE)
-{}
+    : id_(id), timestamp_ns_(timestamp_ns), price_(price),
+      quantity_(qty), leaves_qty_(qty)
+{
+    init(side, kind, nullptr);
+}
 
-Order::Order(uint64_t id, int64_t timestamp_us, Side side,
+Order::Order(uint64_t id, int64_t timestamp_ns, Side side,
              int64_t price, uint64_t total_qty, uint64_t display_qty)
-    : id_(id), timestamp_us_(timestamp_us), side_(side), kind_(OrderKind::ICEBERG),
-      price_(price), quantity_(total_qty), leaves_qty_(total_qty),
-      status_(OrderStatus::ACTIVE),
-      display_qty_(display_qty), hidden_qty_(total_qty - display_qty),
-      orig_display_qty_(display_qty)
-{}
-
-Order::Order(uint64_t id, int64_t timestamp_us, Side side,
+    : id_(id), timestamp_ns_(timestamp_ns), price_(price),
+      quantity_(total_qty), leaves_qty_(total_qty)
+{
+    OrderExt* ext = extPool().allocate();
+    ext->display_qty      = std::min(display_qty, total_qty);
+    ext->orig_display_qty = display_qty;
+    init(side, OrderKind::ICEBERG, ext);
+}
+
+Order::Order(uint64_t id, int64_t timestamp_ns, Side side,
              int64_t trigger_price, int64_t limit_price, uint64_t qty)
-    : id_(id), timestamp_us_(timestamp_us), side_(side), kind_(OrderKind::STOP_LOSS),
-      price_(limit_price), quantity_(qty), leaves_qty_(qty),
-      status_(OrderStatus::ACTIVE),
-      trigger_price_(trigger_price), triggered_(false)
-{}
-
-uint64_t Order::visibleQty() const noexcept {
-    return isIceberg() ? display_qty_ : leaves_qty_;
+    : id_(id), timestamp_ns_(timestamp_ns), price_(limit_price),
+      quantity_(qty), leaves_qty_(qty)
+{
+    OrderExt* ext = extPool().allocate();
+    ext->trigger_price = trigger_price;
+    init(side, OrderKind::STOP_LOSS, ext);
+}
+
+Order::Order(uint64_t id, int64_t timestamp_ns, Side side, OrderKind kind, OrderStatus status,
+             int64_t price, uint64_t qty, uint64_t leaves, const OrderExt& ext)
+    : id_(id), timestamp_ns_(timestamp_ns), price_(price),
+      quantity_(qty), leaves_qty_(leaves)
+{
+    bool extended = kind == OrderKind::ICEBERG || kind == OrderKind::STOP_LOSS;
+    init(side, kind, extended ? extPool().allocate(ext) : nullptr);
+    setStatus(status);
 }
 
+Order::Order(const Order& o)
+    : id_(o.id_), timestamp_ns_(o.timestamp_ns_), price_(o.price_),
+      quantity_(o.quantity_), leaves_qty_(o.leaves_qty_),
+      prev_(o.prev_), next_(o.next_), bits_(o.bits_ & FLAG_MASK)
+{
+    if (OrderExt* ext = o.ext())
+        bits_ |= reinterpret_cast<uintptr_t>(extPool().allocate(*ext));
+}
+
+Order& Order::operator=(const Order& o) {
+    if (this == &o) return *this;
+    OrderExt* mine = ext();
+    if (o.ext() && mine) {
+        *mine = *o.ext();
+    } else {
+        if (mine) extPool().deallocate(mine);
+        mine = o.ext() ? extPool().allocate(*o.ext()) : nullptr;
+    }
+    id_           = o.id_;
+    timestamp_ns_ = o.timestamp_ns_;
+    price_        = o.price_;
+    quantity_     = o.quantity_;
+    leaves_qty_   = o.leaves_qty_;
+    prev_         = o.prev_;
+    next_         = o.next_;
+    bits_         = reinterpret_cast<uintptr_t>(mine) | (o.bits_ & FLAG_MASK);
+    return *this;
+}
+
+Order::~Order() {
+    if (OrderExt* e = ext()) extPool().deallocate(e);
+}
+
+size_t Order::extensionsInUse() noexcept { return extPool().inUse(); }
+
 void Order::replenish() noexcept {
-    if (!isIceberg() || hidden_qty_ == 0) return;
-    uint64_t lot = std::min(hidden_qty_, orig_display_qty_);
-    display_qty_ += lot;
-    hidden_qty_  -= lot;
+    if (!isIceberg()) return;
+    OrderExt* e   = ext();
+    uint64_t  lot = std::min(leaves_qty_ - e->display_qty, e->orig_display_qty);
+    e->display_qty += lot;
 }
 
 void Order::fill(uint64_t qty) noexcept {
     if (qty >= leaves_qty_) {
         leaves_qty_ = 0;
-        if (isIceberg()) { display_qty_ = 0; hidden_qty_ = 0; }
-        status_ = OrderStatus::FILLED;
+        if (isIceberg()) ext()->display_qty = 0;
+        setStatus(OrderStatus::FILLED);
     } else {
         leaves_qty_ -= qty;
         if (isIceberg()) {
-            uint64_t from_display = std::min(qty, display_qty_);
-            display_qty_ -= from_display;
+            // Resting icebergs only trade their display lot; an aggressor can
+            // trade through it, in which case the rest comes out of reserve.
+            OrderExt* e = ext();
+            e->display_qty -= std::min(qty, e->display_qty);
         }
-        status_ = OrderStatus::PARTIAL;
+        setStatus(OrderStatus::PARTIAL);
     }
 }
 
+void Order::reduceTo(uint64_t leaves) noexcept {
+    uint64_t cut = leaves_qty_ - leaves;
+    if (isIceberg()) {
+        OrderExt* e      = ext();
+        uint64_t  hidden = leaves_qty_ - e->display_qty;
+        e->display_qty  -= cut - std::min(cut, hidden);   // reserve goes first
+    }
+    quantity_   -= cut;
+    leaves_qty_  = leaves;
+}
+
+void Order::reprice(int64_t price, uint64_t qty, int64_t timestamp_ns) noexcept {
+    price_        = price;
+    timestamp_ns_ = timestamp_ns;
+    quantity_     = qty;
+    leaves_qty_   = qty;
+    setStatus(OrderStatus::ACTIVE);
+    if (isIceberg()) ext()->display_qty = std::min(qty, ext()->orig_display_qty);
+}
+
 void Order::cancel() noexcept {
     leaves_qty_ = 0;
-    status_     = OrderStatus::CANCELLED;
+    setStatus(OrderStatus::CANCELLED);
 }
 
 void Order::print() const {
     static const char* kind_names[] = {"LIMIT", "MARKET", "ICEBERG", "STOP_LOSS"};
     std::cout << "[Order #" << id_
-              << " | " << (side_ == Side::BUY ? "BUY" : "SELL")
-              << " | " << kind_names[static_cast<int>(kind_)]
+              << " | " << (side() == Side::BUY ? "BUY" : "SELL")
+              << " | " << kind_names[static_cast<int>(kind())]
               << " | $" << std::fixed << std::setprecision(2)
               << price_ / static_cast<double>(PRICE_SCALE)
               << " | qty=" << quantity_
               << " leaves=" << leaves_qty_;
     if (isIceberg())
-        std::cout << " (visible=" << display_qty_
-                  << " hidden=" << hidden_qty_ << ")";
+        std::cout << " (visible=" << visibleQty()
+                  << " hidden=" << hiddenQty() << ")";
     std::cout << "]\n";
 }
@@ -1,271 +1,383 @@
 #include "orderbook.h"
 #include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <mutex>
+#include <shared_mutex>
+#include <system_error>
+
+template <typename LockPolicy>
+BasicOrderBook<LockPolicy>::BasicOrderBook(const LadderConfig& ladder, const PoolConfig& pool,
+                                            const TapeConfig& tape)
+    : pool_(pool), bids_(ladder), asks_(ladder),
+      sell_stops_(ladder), buy_stops_(ladder), tape_(tape)
+{}
+
+template <typename LockPolicy>
+BasicOrderBook<LockPolicy>::~BasicOrderBook() {
+    auto drain = [this](auto& ladder) {
+        for (auto* l = ladder.lowest(); l; l = ladder.above(l->price)) {
+            while (Order* o = l->orders.front()) {
+                l->orders.pop_front();
+                release(o);
+            }
+        }
+    };
+    drain(bids_);
+    drain(asks_);
+    drain(sell_stops_);
+    drain(buy_stops_);
+    // Fired stops not yet matched, left behind by a sink that threw.
+    for (Order* stop : triggered_stops_) release(stop);
+}
 
-void OrderBook::addToBook(OrderPtr order) {
-    if (order->side() == Side::BUY) {
-        bids_[order->price()].push_back(order);
-    } else {
-        asks_[order->price()].push_back(order);
-    }
-    active_[order->id()] = order;
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::addToBook(Order* order) {
+    // An iceberg that traded through its display lot as the aggressor rests
+    // with a fresh lot rather than an invisible zero.
+    if (order->isIceberg() && order->visibleQty() == 0) order->replenish();
+
+    auto& side = (order->side() == Side::BUY) ? bids_ : asks_;
+    side.acquire(order->price()).push_back(order);
+    active_.insert(order->id(), order);
 }
 
-bool OrderBook::cancelLocked(uint64_t order_id) {
-    auto it = active_.find(order_id);
-    if (it == active_.end()) return false;
-
-    OrderPtr order = it->second;
-    int64_t  price = order->price();
-
-    auto removeFromLevel = [&](auto& side_map) {
-        auto map_it = side_map.find(price);
-        if (map_it == side_map.end()) return;
-        Level& level = map_it->second;
-        level.erase(std::remove_if(level.begin(), level.end(),
-            [order_id](const OrderPtr& o) { return o->id() == order_id; }),
-            level.end());
-        if (level.empty()) side_map.erase(map_it);
-    };
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::cancelLocked(uint64_t order_id) {
+    Order* order = active_.find(order_id);
+    if (!order) return cancelStopLocked(order_id);
+
+    int64_t price = order->price();
 
-    if (order->side() == Side::BUY) removeFromLevel(bids_);
-    else                            removeFromLevel(asks_);
+    auto& side = (order->side() == Side::BUY) ? bids_ : asks_;
+    if (Level* level = side.find(price)) {
+        level->erase(order);
+        if (level->orders.empty()) side.release(price);
+    }
 
-    order->cancel();
-    active_.erase(it);
+    active_.erase(order_id);
+    release(order);
     return true;
 }
 
 
-Trade OrderBook::makeTrade(uint64_t buy_id, uint64_t sell_id,
-                            int64_t price, uint64_t qty, int64_t ts) {
+template <typename LockPolicy>
+Trade BasicOrderBook<LockPolicy>::makeTrade(uint64_t buy_id, uint64_t sell_id,
+                                            int64_t price, uint64_t qty, int64_t ts) {
     return Trade{next_trade_id_++, buy_id, sell_id, price, qty, ts};
 }
 
-void OrderBook::checkStopTriggers(int64_t last_price) {
-    auto it = pending_stops_.begin();
-    while (it != pending_stops_.end()) {
-        OrderPtr& stop = *it;
-        bool fire = (stop->side() == Side::SELL && last_price <= stop->triggerPrice())
-                 || (stop->side() == Side::BUY  && last_price >= stop->triggerPrice());
-        if (fire) {
-            stop->trigger();
-            triggered_stops_.push_back(stop);   // processed after current match cycle
-            it = pending_stops_.erase(it);
-        } else {
-            ++it;
-        }
-    }
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::addStop(Order* stop) {
+    auto& side = (stop->side() == Side::SELL) ? sell_stops_ : buy_stops_;
+    side.acquire(stop->triggerPrice()).orders.push_back(stop);
+    stop_index_.insert(stop->id(), stop);
 }
 
-std::vector<Trade> OrderBook::matchBuy(OrderPtr order) {
-    std::vector<Trade> result;
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::cancelStopLocked(uint64_t order_id) {
+    Order* stop = stop_index_.find(order_id);
+    if (!stop) return false;
 
-    while (order->isActive() && !asks_.empty()) {
-        auto it = asks_.begin();
+    auto& side = (stop->side() == Side::SELL) ? sell_stops_ : buy_stops_;
+    if (StopLevel* level = side.find(stop->triggerPrice())) {
+        level->orders.erase(stop);
+        if (level->orders.empty()) side.release(level->price);
+    }
 
-        // Limit orders may not lift above their stated price.
-        if (!order->isMarket() && it->first > order->price()) break;
+    stop_index_.erase(order_id);
+    release(stop);
+    return true;
+}
 
-        Level& level = it->second;
-        while (order->isActive() && !level.empty()) {
-            OrderPtr resting = level.front();
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::fireStops(PriceLadder<StopLevel>& side, StopLevel& level) {
+    while (!level.orders.empty()) {
+        Order* stop = level.orders.front();
+        level.orders.pop_front();
+        stop_index_.erase(stop->id());
+        stop->trigger();
+        triggered_stops_.push_back(stop);   // processed after current match cycle
+    }
+    side.release(level.price);
+}
 
-            uint64_t available = resting->isIceberg()
-                                 ? resting->visibleQty()
-                                 : resting->leaves();
-            if (available == 0) { level.pop_front(); continue; }
+// Only trigger levels the trade actually crossed are touched. Sell stops fire
+// highest trigger first, buy stops lowest first — i.e. in the order the price
+// moved through them — and FIFO within a trigger price.
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::checkStopTriggers(int64_t last_price) {
+    for (StopLevel* l = sell_stops_.highest(); l && l->price >= last_price;
+         l = sell_stops_.highest())
+        fireStops(sell_stops_, *l);
+    for (StopLevel* l = buy_stops_.lowest(); l && l->price <= last_price;
+         l = buy_stops_.lowest())
+        fireStops(buy_stops_, *l);
+}
 
-            uint64_t qty   = std::min(order->leaves(), available);
-            int64_t  price = it->first;
+template <typename LockPolicy>
+std::vector<Trade> BasicOrderBook<LockPolicy>::match(Order* order) {
+    std::vector<Trade> trades;
+    TradeCollector     sink{trades};
+    match(order, sink);
+    return trades;
+}
 
-            order->fill(qty);
-            resting->fill(qty);
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::cancelOrder(uint64_t order_id) {
+    std::unique_lock lock(mutex_);
+    bool ok = cancelLocked(order_id);
+    if (ok) publishTop();
+    return ok;
+}
 
-            Trade t = makeTrade(order->id(), resting->id(),
-                                price, qty, order->timestamp());
-            result.push_back(t);
-            trades_.push_back(t);
-            checkStopTriggers(price);
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::modifyOrder(uint64_t order_id, int64_t new_price,
+                                             uint64_t new_qty, int64_t new_timestamp_ns) {
+    std::unique_lock lock(mutex_);
+    bool ok = modifyLocked(order_id, new_price, new_qty, new_timestamp_ns);
+    if (ok) publishTop();
+    return ok;
+}
 
-            if (resting->isFilled()) {
-                active_.erase(resting->id());
-                level.pop_front();
-            } else if (resting->isIceberg() && resting->visibleQty() == 0) {
-                resting->replenish();   // refill display lot; order stays in queue
-            }
-        }
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::modifyLocked(uint64_t order_id, int64_t new_price,
+                                              uint64_t new_qty, int64_t new_timestamp_ns) {
+    Order* order = active_.find(order_id);
+    if (!order) return amendStopLocked(order_id, new_price, new_qty);
+    if (new_qty == 0) return cancelLocked(order_id);
 
-        if (level.empty()) asks_.erase(it);
+    auto&  side  = (order->side() == Side::BUY) ? bids_ : asks_;
+    Level* level = side.find(order->price());
+
+    // Quantity down at the same price: no allocation, no relinking.
+    if (new_price == order->price() && new_qty <= order->leaves()) {
+        level->reduce(order, new_qty);
+        return true;
     }
 
-    if (!order->isFilled() && !order->isMarket()) addToBook(order);
+    level->erase(order);
+    if (level->orders.empty()) side.release(level->price);
+    order->reprice(new_price, new_qty, new_timestamp_ns);
+    side.acquire(new_price).push_back(order);
+    return true;
+}
 
-    return result;
+template <typename LockPolicy>
+bool BasicOrderBook<LockPolicy>::amendStopLocked(uint64_t order_id, int64_t price, uint64_t qty) {
+    Order* stop = stop_index_.find(order_id);
+    if (!stop) return false;
+    if (qty == 0) return cancelStopLocked(order_id);
+    stop->reprice(price, qty, stop->timestamp());
+    return true;
 }
 
-std::vector<Trade> OrderBook::matchSell(OrderPtr order) {
-    std::vector<Trade> result;
+// Called with the book lock held after every mutation. Skips the store, and
+// so leaves readers' cached copies valid, when the top did not change.
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::publishTop() noexcept {
+    const Level* bid = bids_.highest();
+    const Level* ask = asks_.lowest();
+
+    BookTop t{};
+    if (bid) {
+        t.bid_price  = bid->price;
+        t.bid_qty    = bid->visible_qty;
+        t.bid_orders = static_cast<uint32_t>(bid->orders.size());
+    }
+    if (ask) {
+        t.ask_price  = ask->price;
+        t.ask_qty    = ask->visible_qty;
+        t.ask_orders = static_cast<uint32_t>(ask->orders.size());
+    }
+    t.bid_levels = static_cast<uint32_t>(bids_.size());
+    t.ask_levels = static_cast<uint32_t>(asks_.size());
+    t.sequence   = last_top_.sequence;
+    if (std::memcmp(&t, &last_top_, sizeof(BookTop)) == 0) return;
+
+    ++t.sequence;
+    last_top_ = t;
+    top_.store(t);
+}
 
-    while (order->isActive() && !bids_.empty()) {
-        auto it = bids_.begin();
+template <typename LockPolicy>
+int64_t BasicOrderBook<LockPolicy>::bestBid() const { return top().bid_price; }
 
-        if (!order->isMarket() && it->first < order->price()) break;
+template <typename LockPolicy>
+int64_t BasicOrderBook<LockPolicy>::bestAsk() const { return top().ask_price; }
 
-        Level& level = it->second;
-        while (order->isActive() && !level.empty()) {
-            OrderPtr resting = level.front();
+template <typename LockPolicy>
+int64_t BasicOrderBook<LockPolicy>::spread() const {
+    BookTop t = top();
+    if (!t.bid_price || !t.ask_price) return 0;
+    return t.ask_price - t.bid_price;
+}
 
-            uint64_t available = resting->isIceberg()
-                                 ? resting->visibleQty()
-                                 : resting->leaves();
-            if (available == 0) { level.pop_front(); continue; }
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::bidLevels() const { return top().bid_levels; }
 
-            uint64_t qty   = std::min(order->leaves(), available);
-            int64_t  price = it->first;
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::askLevels() const { return top().ask_levels; }
 
-            order->fill(qty);
-            resting->fill(qty);
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::activeOrders() const {
+    std::shared_lock lock(mutex_);
+    return active_.size();
+}
 
-            Trade t = makeTrade(resting->id(), order->id(),
-                                price, qty, order->timestamp());
-            result.push_back(t);
-            trades_.push_back(t);
-            checkStopTriggers(price);
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::pendingStops() const {
+    std::shared_lock lock(mutex_);
+    return stop_index_.size();
+}
 
-            if (resting->isFilled()) {
-                active_.erase(resting->id());
-                level.pop_front();
-            } else if (resting->isIceberg() && resting->visibleQty() == 0) {
-                resting->replenish();
-            }
-        }
+template <typename LockPolicy>
+std::optional<Order> BasicOrderBook<LockPolicy>::findOrder(uint64_t order_id) const {
+    std::shared_lock lock(mutex_);
+    const Order* order = active_.find(order_id);
+    if (!order) order = stop_index_.find(order_id);
+    if (!order) return std::nullopt;
+    return *order;
+}
 
-        if (level.empty()) bids_.erase(it);
-    }
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::saveState(SnapshotHeader header, SnapshotWriter& out) const {
+    std::shared_lock lock(mutex_);
+    header.next_trade_id  = next_trade_id_;
+    header.resting_orders = active_.size();
+    header.pending_stops  = stop_index_.size();
+    out.header(header);
 
-    if (!order->isFilled() && !order->isMarket()) addToBook(order);
+    auto level = [&](const auto* l) {
+        for (const Order* o : l->orders) out.record(snapshotRecord(*o));
+    };
+    for (const Level* l = bids_.highest(); l; l = bids_.below(l->price)) level(l);
+    for (const Level* l = asks_.lowest();  l; l = asks_.above(l->price)) level(l);
+    for (const StopLevel* l = sell_stops_.highest(); l; l = sell_stops_.below(l->price)) level(l);
+    for (const StopLevel* l = buy_stops_.lowest();   l; l = buy_stops_.above(l->price))  level(l);
+}
 
-    return result;
+// A record the book could have produced: a live order of a kind that rests
+// (or, for stops, waits), with a sane open quantity and display lot. A stop
+// rests only once it has fired, and waits only until then.
+static bool plausible(const SnapshotRecord& r, bool stop) {
+    auto kind   = static_cast<OrderKind>(r.kind);
+    auto status = static_cast<OrderStatus>(r.status);
+    if (r.side > static_cast<uint8_t>(Side::SELL)) return false;
+    if (status != OrderStatus::ACTIVE && status != OrderStatus::PARTIAL) return false;
+    if (r.leaves == 0 || r.leaves > r.quantity) return false;
+    if (stop) return kind == OrderKind::STOP_LOSS && r.ext_b == 0;
+    if (kind == OrderKind::STOP_LOSS) return r.ext_b == 1;
+    if (kind == OrderKind::ICEBERG) return r.ext_a > 0 && r.ext_a <= r.leaves && r.ext_b > 0;
+    return kind == OrderKind::LIMIT;
 }
 
-std::vector<Trade> OrderBook::match(OrderPtr order) {
+template <typename LockPolicy>
+SnapshotHeader BasicOrderBook<LockPolicy>::loadState(SnapshotReader& in) {
     std::unique_lock lock(mutex_);
+    if (!active_.empty() || !stop_index_.empty())
+        throw std::system_error(EBUSY, std::generic_category(), "OrderBook: snapshot load into a non-empty book");
+
+    const SnapshotHeader& header = in.header();
+    pool_.reserve(header.resting_orders + header.pending_stops);
+
+    auto load = [&](const SnapshotRecord& r, bool stop) {
+        if (!plausible(r, stop) || active_.find(r.id) || stop_index_.find(r.id))
+            throw std::system_error(EINVAL, std::generic_category(), "OrderBook: bad snapshot record");
+        return pool_.allocate(r.id, r.timestamp_ns, static_cast<Side>(r.side),
+                              static_cast<OrderKind>(r.kind), static_cast<OrderStatus>(r.status),
+                              r.price, r.quantity, r.leaves, snapshotExt(r));
+    };
 
-    if (order->isStopLoss() && !order->isTriggered()) {
-        pending_stops_.push_back(order);
-        return {};
-    }
-
-    std::vector<Trade> all_trades =
-        (order->side() == Side::BUY) ? matchBuy(order) : matchSell(order);
-
-    // Triggered stops are collected inside checkStopTriggers; run them now
-    while (!triggered_stops_.empty()) {
-        auto batch = std::move(triggered_stops_);
-        triggered_stops_.clear();
-        for (auto& stop : batch) {
-            auto t = (stop->side() == Side::BUY) ? matchBuy(stop) : matchSell(stop);
-            all_trades.insert(all_trades.end(), t.begin(), t.end());
+    // Records arrive grouped by level, so the level just used is nearly
+    // always the next one too.
+    PriceLadder<Level>* ladder = nullptr;
+    Level*              level  = nullptr;
+    for (uint64_t i = 0; i < header.resting_orders; ++i) {
+        Order* o = load(in.record(i), false);
+        auto&  side = (o->side() == Side::BUY) ? bids_ : asks_;
+        if (!level || ladder != &side || level->price != o->price()) {
+            ladder = &side;
+            level  = &side.acquire(o->price());
         }
+        level->push_back(o);
+        active_.insert(o->id(), o);
     }
+    for (uint64_t i = header.resting_orders; i < in.records(); ++i)
+        addStop(load(in.record(i), true));
 
-    return all_trades;
-}
-
-bool OrderBook::cancelOrder(uint64_t order_id) {
-    std::unique_lock lock(mutex_);
-    return cancelLocked(order_id);
-}
-
-bool OrderBook::modifyOrder(uint64_t order_id, int64_t new_price,
-                            uint64_t new_qty, int64_t new_timestamp_us) {
-    std::unique_lock lock(mutex_);
-    auto it = active_.find(order_id);
-    if (it == active_.end()) return false;
-
-    OrderPtr old_order = it->second;
-    OrderPtr new_order = std::make_shared<Order>(
-        old_order->id(), new_timestamp_us,
-        old_order->side(), old_order->kind(),
-        new_price, new_qty
-    );
-
-    cancelLocked(order_id);
-    addToBook(new_order);
-    return true;
+    next_trade_id_ = header.next_trade_id;
+    publishTop();
+    return header;
 }
 
-int64_t OrderBook::bestBid() const {
-    std::shared_lock lock(mutex_);
-    return bids_.empty() ? 0 : bids_.begin()->first;
-}
-
-int64_t OrderBook::bestAsk() const {
-    std::shared_lock lock(mutex_);
-    return asks_.empty() ? 0 : asks_.begin()->first;
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::depthLocked(Side side, size_t levels, DepthLevel* out) const {
+    size_t n = 0;
+    auto emit = [&](const Level* l) {
+        out[n++] = DepthLevel{l->price, l->visible_qty, l->hidden_qty,
+                              static_cast<uint64_t>(l->orders.size())};
+    };
+    if (side == Side::BUY) {
+        for (const Level* l = bids_.highest(); l && n < levels; l = bids_.below(l->price))
+            emit(l);
+    } else {
+        for (const Level* l = asks_.lowest(); l && n < levels; l = asks_.above(l->price))
+            emit(l);
+    }
+    return n;
 }
 
-int64_t OrderBook::spread() const {
+template <typename LockPolicy>
+size_t BasicOrderBook<LockPolicy>::getDepth(Side side, size_t levels, DepthLevel* out) const {
     std::shared_lock lock(mutex_);
-    if (bids_.empty() || asks_.empty()) return 0;
-    return asks_.begin()->first - bids_.begin()->first;
+    return depthLocked(side, levels, out);
 }
 
-size_t OrderBook::bidLevels()    const { std::shared_lock l(mutex_); return bids_.size(); }
-size_t OrderBook::askLevels()    const { std::shared_lock l(mutex_); return asks_.size(); }
-size_t OrderBook::activeOrders() const { std::shared_lock l(mutex_); return active_.size(); }
-
-void OrderBook::printBook(int levels) const {
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::printBook(int levels) const {
     std::shared_lock lock(mutex_);
     std::cout << "\n===== ORDER BOOK =====\n"
               << std::fixed << std::setprecision(2);
 
     // Collect the `levels` ask prices closest to mid (ascending), then
     // display them descending (highest far from mid at top of the ask block).
-    std::vector<std::pair<int64_t, uint64_t>> ask_rows;
-    ask_rows.reserve(static_cast<size_t>(levels));
-    for (auto& [price, level] : asks_) {
-        if (static_cast<int>(ask_rows.size()) >= levels) break;
-        uint64_t total = 0;
-        for (auto& o : level) total += o->visibleQty();
-        ask_rows.emplace_back(price, total);
-    }
+    size_t depth = levels > 0 ? static_cast<size_t>(levels) : 0;
+    std::vector<DepthLevel> ask_rows(depth), bid_rows(depth);
+    ask_rows.resize(depthLocked(Side::SELL, depth, ask_rows.data()));
+    bid_rows.resize(depthLocked(Side::BUY,  depth, bid_rows.data()));
 
     std::cout << "  ASKS:\n";
     for (auto it = ask_rows.rbegin(); it != ask_rows.rend(); ++it) {
         std::cout << "    $" << std::setw(9)
-                  << (static_cast<double>(it->first) / PRICE_SCALE)
-                  << "  x  " << it->second << "\n";
+                  << (static_cast<double>(it->price) / PRICE_SCALE)
+                  << "  x  " << it->visible_qty << "\n";
     }
 
-    int64_t spr = (bids_.empty() || asks_.empty()) ? 0
-                 : asks_.begin()->first - bids_.begin()->first;
+    const Level* best_bid = bids_.highest();
+    const Level* best_ask = asks_.lowest();
+    int64_t spr = (!best_bid || !best_ask) ? 0 : best_ask->price - best_bid->price;
     std::cout << "  -------- spread: $"
               << (static_cast<double>(spr) / PRICE_SCALE)
               << " --------\n";
 
     std::cout << "  BIDS:\n";
-    int count = 0;
-    for (auto& [price, level] : bids_) {
-        if (count++ >= levels) break;
-        uint64_t total = 0;
-        for (auto& o : level) total += o->visibleQty();
+    for (const DepthLevel& row : bid_rows) {
         std::cout << "    $" << std::setw(9)
-                  << (static_cast<double>(price) / PRICE_SCALE)
-                  << "  x  " << total << "\n";
+                  << (static_cast<double>(row.price) / PRICE_SCALE)
+                  << "  x  " << row.visible_qty << "\n";
     }
 
     std::cout << "======================\n\n";
 }
 
-void OrderBook::printTrades() const {
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::printTrades() const {
     std::shared_lock lock(mutex_);
-    std::cout << "\n===== TRADE HISTORY (" << trades_.size() << " trade(s)) =====\n"
+    std::cout << "\n===== TRADE HISTORY (" << tape_.size() << " trade(s)) =====\n"
               << std::fixed << std::setprecision(2);
-    for (auto& t : trades_) {
+    for (const Trade& t : tape_) {
         std::cout << "  Trade #" << t.trade_id
                   << "  buy=" << t.buy_order_id
                   << "  sell=" << t.sell_order_id
@@ -276,26 +388,16 @@ void OrderBook::printTrades() const {
     std::cout << "==========================================\n\n";
 }
 
-void OrderBook::printDepth(int levels) const {
+template <typename LockPolicy>
+void BasicOrderBook<LockPolicy>::printDepth(int levels) const {
     std::shared_lock lock(mutex_);
     std::cout << std::fixed << std::setprecision(2);
 
-    // Collect ask levels (ascending in the map = best ask first)
-    using Row = std::pair<int64_t, uint64_t>;
-    std::vector<Row> ask_rows, bid_rows;
-
-    for (auto& [price, level] : asks_) {
-        if (static_cast<int>(ask_rows.size()) >= levels) break;
-        uint64_t total = 0;
-        for (auto& o : level) total += o->visibleQty();
-        ask_rows.push_back({price, total});
-    }
-    for (auto& [price, level] : bids_) {
-        if (static_cast<int>(bid_rows.size()) >= levels) break;
-        uint64_t total = 0;
-        for (auto& o : level) total += o->visibleQty();
-        bid_rows.push_back({price, total});
-    }
+    // Collect ask levels (lowest first = best ask first)
+    size_t depth = levels > 0 ? static_cast<size_t>(levels) : 0;
+    std::vector<DepthLevel> ask_rows(depth), bid_rows(depth);
+    ask_rows.resize(depthLocked(Side::SELL, depth, ask_rows.data()));
+    bid_rows.resize(depthLocked(Side::BUY,  depth, bid_rows.data()));
 
     std::cout << "\n=== Market Depth (Top " << levels << " Levels) ===\n";
     std::cout << std::setw(12) << "Price"
@@ -307,27 +409,33 @@ void OrderBook::printDepth(int levels) const {
     // cumulative counts from best ask outward
     std::cout << "ASKS:\n";
     uint64_t cum = 0;
-    for (auto& [p, q] : ask_rows) cum += q;
+    for (auto& row : ask_rows) cum += row.visible_qty;
     for (auto it = ask_rows.rbegin(); it != ask_rows.rend(); ++it) {
-        std::cout << std::setw(12) << it->first / static_cast<double>(PRICE_SCALE)   // FIX: consistent scaling
-                  << std::setw(10) << it->second
+        std::cout << std::setw(12) << it->price / static_cast<double>(PRICE_SCALE)   // FIX: consistent scaling
+                  << std::setw(10) << it->visible_qty
                   << std::setw(14) << cum << "\n";
-        cum -= it->second;
+        cum -= it->visible_qty;
     }
 
-    if (!bids_.empty() && !asks_.empty()) {
-        double spr = (asks_.begin()->first - bids_.begin()->first)
+    const Level* best_bid = bids_.highest();
+    const Level* best_ask = asks_.lowest();
+    if (best_bid && best_ask) {
+        double spr = (best_ask->price - best_bid->price)
                      / static_cast<double>(PRICE_SCALE);
         std::cout << "--- spread: $" << spr << " ---\n";
     }
 
     std::cout << "BIDS:\n";
     cum = 0;
-    for (auto& [p, q] : bid_rows) {
-        cum += q;
-        std::cout << std::setw(12) << p / static_cast<double>(PRICE_SCALE)            // FIX: consistent scaling
-                  << std::setw(10) << q
+    for (auto& row : bid_rows) {
+        cum += row.visible_qty;
+        std::cout << std::setw(12) << row.price / static_cast<double>(PRICE_SCALE)    // FIX: consistent scaling
+                  << std::setw(10) << row.visible_qty
                   << std::setw(14) << cum << "\n";
     }
     std::cout << std::string(36, '=') << "\n";
 }
+
+template class BasicOrderBook<SingleWriterPolicy>;
+template class BasicOrderBook<TicketLockPolicy>;
+template class BasicOrderBook<SharedMutexPolicy>;
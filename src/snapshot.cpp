@@ -0,0 +1,228 @@
+#include "snapshot.h"
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char HEADER_MAGIC[8]  = {'L', 'O', 'B', 'S', 'N', 'A', 'P', '1'};
+constexpr char TRAILER_MAGIC[8] = {'L', 'O', 'B', 'S', 'N', 'E', 'N', 'D'};
+
+struct SnapshotTrailer {
+    char     magic[8];
+    uint64_t records;
+    uint64_t checksum;
+    uint64_t reserved;
+};
+static_assert(sizeof(SnapshotTrailer) == 32, "snapshot trailer must stay 32 bytes");
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME  = 0x100000001b3ULL;
+
+// FNV-1a over the header and the records a word at a time, in four
+// interleaved lanes so the multiplies do not form one serial chain. fold()
+// combines the lanes.
+void resetLanes(uint64_t (&lanes)[4]) noexcept {
+    for (uint64_t& l : lanes) l = FNV_OFFSET;
+}
+
+template <typename Block>
+void mix(uint64_t (&lanes)[4], const Block& b) noexcept {
+    static_assert(sizeof(Block) == 64, "checksummed blocks are 64 bytes");
+    uint64_t words[sizeof(Block) / 8];
+    std::memcpy(words, &b, sizeof(words));
+    for (size_t i = 0; i < std::size(words); ++i)
+        lanes[i % 4] = (lanes[i % 4] ^ words[i]) * FNV_PRIME;
+}
+
+uint64_t fold(const uint64_t (&lanes)[4]) noexcept {
+    uint64_t h = FNV_OFFSET;
+    for (uint64_t l : lanes) h = (h ^ l) * FNV_PRIME;
+    return h;
+}
+
+std::string directoryOf(const std::string& path) {
+    size_t slash = path.rfind('/');
+    if (slash == std::string::npos) return ".";
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+SnapshotRecord snapshotRecord(const Order& o) noexcept {
+    SnapshotRecord r{};
+    r.id           = o.id();
+    r.timestamp_ns = o.timestamp();
+    r.price        = o.price();
+    r.quantity     = o.quantity();
+    r.leaves       = o.leaves();
+    r.side         = static_cast<uint8_t>(o.side());
+    r.kind         = static_cast<uint8_t>(o.kind());
+    r.status       = static_cast<uint8_t>(o.status());
+    OrderExt ext   = o.extension();
+    if (o.isIceberg()) {
+        r.ext_a = ext.display_qty;
+        r.ext_b = ext.orig_display_qty;
+    } else if (o.isStopLoss()) {
+        r.ext_a = static_cast<uint64_t>(ext.trigger_price);
+        r.ext_b = ext.triggered;
+    }
+    return r;
+}
+
+OrderExt snapshotExt(const SnapshotRecord& r) noexcept {
+    OrderExt ext;
+    if (static_cast<OrderKind>(r.kind) == OrderKind::ICEBERG) {
+        ext.display_qty      = r.ext_a;
+        ext.orig_display_qty = r.ext_b;
+    } else if (static_cast<OrderKind>(r.kind) == OrderKind::STOP_LOSS) {
+        ext.trigger_price = static_cast<int64_t>(r.ext_a);
+        ext.triggered     = r.ext_b != 0;
+    }
+    return ext;
+}
+
+// ---------------------------------------------------------------------------
+// SnapshotWriter
+// ---------------------------------------------------------------------------
+
+SnapshotWriter::SnapshotWriter(const std::string& path)
+    : path_(path), tmp_(path + ".tmp"), buf_(new char[BUFFER_BYTES])
+{
+    resetLanes(lanes_);
+    fd_ = ::open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "Snapshot: cannot create " + tmp_);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (fd_ >= 0) ::close(fd_);
+    if (!committed_) ::unlink(tmp_.c_str());
+}
+
+void SnapshotWriter::header(const SnapshotHeader& h) {
+    SnapshotHeader out = h;
+    std::memcpy(out.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC));
+    out.version     = SNAPSHOT_VERSION;
+    out.record_size = sizeof(SnapshotRecord);
+    mix(lanes_, out);
+    put(&out, sizeof(out));
+}
+
+void SnapshotWriter::record(const SnapshotRecord& r) {
+    mix(lanes_, r);
+    ++records_;
+    put(&r, sizeof(r));
+}
+
+void SnapshotWriter::put(const void* p, size_t n) {
+    if (used_ + n > BUFFER_BYTES) flush();
+    std::memcpy(buf_.get() + used_, p, n);
+    used_  += n;
+    bytes_ += n;
+}
+
+void SnapshotWriter::flush() {
+    size_t done = 0;
+    while (done < used_) {
+        ssize_t w = ::write(fd_, buf_.get() + done, used_ - done);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            throw std::system_error(errno, std::generic_category(), "Snapshot: cannot write " + tmp_);
+        }
+        done += static_cast<size_t>(w);
+    }
+    used_ = 0;
+}
+
+void SnapshotWriter::commit() {
+    SnapshotTrailer t{};
+    std::memcpy(t.magic, TRAILER_MAGIC, sizeof(TRAILER_MAGIC));
+    t.records  = records_;
+    t.checksum = fold(lanes_);
+    put(&t, sizeof(t));
+    flush();
+
+    if (::fsync(fd_) != 0)
+        throw std::system_error(errno, std::generic_category(), "Snapshot: cannot sync " + tmp_);
+    ::close(fd_);
+    fd_ = -1;
+    if (::rename(tmp_.c_str(), path_.c_str()) != 0)
+        throw std::system_error(errno, std::generic_category(), "Snapshot: cannot rename to " + path_);
+    committed_ = true;
+
+    int dir = ::open(directoryOf(path_).c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SnapshotReader
+// ---------------------------------------------------------------------------
+
+SnapshotReader::SnapshotReader(const std::string& path) : path_(path) {
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) fail(errno, "cannot open");
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        int err = errno;
+        ::close(fd);
+        fail(err, "cannot stat");
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    if (bytes_ < sizeof(SnapshotHeader) + sizeof(SnapshotTrailer)) {
+        ::close(fd);
+        fail(EINVAL, "truncated snapshot");
+    }
+    map_ = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    int err = errno;
+    ::close(fd);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        fail(err, "cannot map");
+    }
+
+    const char* base = static_cast<const char*>(map_);
+    std::memcpy(&header_, base, sizeof(header_));
+    if (std::memcmp(header_.magic, HEADER_MAGIC, sizeof(HEADER_MAGIC)) != 0)
+        fail(EINVAL, "not a snapshot:");
+    if (header_.version != SNAPSHOT_VERSION || header_.record_size != sizeof(SnapshotRecord))
+        fail(EINVAL, "unsupported snapshot version in");
+    // Each count is bounded by the file before they are added, so the sum
+    // cannot wrap.
+    uint64_t room = (bytes_ - sizeof(SnapshotHeader) - sizeof(SnapshotTrailer)) / sizeof(SnapshotRecord);
+    if (header_.resting_orders > room || header_.pending_stops > room - header_.resting_orders)
+        fail(EINVAL, "record counts exceed");
+    uint64_t n = records();
+    if (bytes_ != sizeof(SnapshotHeader) + n * sizeof(SnapshotRecord) + sizeof(SnapshotTrailer))
+        fail(EINVAL, "wrong size for");
+    records_ = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader));
+
+    SnapshotTrailer t;
+    std::memcpy(&t, base + bytes_ - sizeof(t), sizeof(t));
+    uint64_t lanes[4];
+    resetLanes(lanes);
+    mix(lanes, header_);
+    for (uint64_t i = 0; i < n; ++i) mix(lanes, records_[i]);
+    if (std::memcmp(t.magic, TRAILER_MAGIC, sizeof(TRAILER_MAGIC)) != 0 ||
+        t.records != n || t.checksum != fold(lanes))
+        fail(EINVAL, "checksum mismatch in");
+}
+
+SnapshotReader::~SnapshotReader() {
+    if (map_) ::munmap(map_, bytes_);
+}
+
+// Only the constructor fails, so the destructor will not run.
+void SnapshotReader::fail(int err, const char* what) {
+    if (map_) ::munmap(map_, bytes_);
+    throw std::system_error(err, std::generic_category(), std::string("Snapshot: ") + what + " " + path_);
+}
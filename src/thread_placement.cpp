@@ -0,0 +1,70 @@
+#include "thread_placement.h"
+
+#include <thread>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+ThreadPlacement ThreadPlacement::pinned(size_t producers, int first_core) {
+    int cores = static_cast<int>(onlineCores());
+    ThreadPlacement p;
+    p.matching_core  = first_core % cores;
+    p.publisher_core = (first_core + 1) % cores;
+    for (size_t i = 0; i < producers; ++i)
+        p.producer_cores.push_back((first_core + 2 + static_cast<int>(i)) % cores);
+    return p;
+}
+
+size_t onlineCores() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
+
+bool pinCurrentThread(int core) {
+#ifdef __linux__
+    if (core < 0 || core >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+int currentCore() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+int currentNumaNode() {
+#ifdef __linux__
+    unsigned cpu = 0, node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) return -1;
+    return static_cast<int>(node);
+#else
+    return -1;
+#endif
+}
+
+bool preferNumaNode(int node) {
+#ifdef __linux__
+    constexpr int BITS = static_cast<int>(8 * sizeof(unsigned long));
+    if (node < 0 || node >= BITS) return false;
+    unsigned long mask = 1UL << node;
+    // maxnode counts one past the highest bit the kernel reads.
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, BITS + 1) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
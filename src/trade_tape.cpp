@@ -0,0 +1,184 @@
+#include "trade_tape.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char SEGMENT_MAGIC[8] = {'L', 'O', 'B', 'T', 'A', 'P', 'E', '1'};
+
+struct SegmentHeader {
+    char     magic[8];
+    uint64_t first_trade_id;
+    uint64_t count;
+    uint64_t record_size;
+    uint64_t reserved[4];
+};
+static_assert(sizeof(SegmentHeader) == 64, "segment header must stay 64 bytes");
+
+size_t roundUpPow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+// One segment file mapped in full. Writers map it read-write at its final
+// size; readers map whatever is on disk read-only.
+struct TradeTape::Segment {
+    uint64_t index{0};
+    void*    base{MAP_FAILED};
+    size_t   length{0};
+
+    ~Segment() { if (base != MAP_FAILED) ::munmap(base, length); }
+
+    SegmentHeader* header() const { return static_cast<SegmentHeader*>(base); }
+    Record*        records() const {
+        return reinterpret_cast<Record*>(static_cast<char*>(base) + sizeof(SegmentHeader));
+    }
+
+    static std::unique_ptr<Segment> create(const std::string& path, uint64_t index,
+                                           size_t records) {
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return nullptr;
+        auto seg    = std::make_unique<Segment>();
+        seg->index  = index;
+        seg->length = sizeof(SegmentHeader) + records * sizeof(Record);
+        if (::ftruncate(fd, static_cast<off_t>(seg->length)) == 0)
+            seg->base = ::mmap(nullptr, seg->length, PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (seg->base == MAP_FAILED) return nullptr;
+
+        SegmentHeader* h = seg->header();
+        std::memcpy(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+        h->record_size = sizeof(Record);
+        return seg;
+    }
+
+    static std::shared_ptr<const Segment> open(const std::string& path, uint64_t index) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st{};
+        auto seg   = std::make_shared<Segment>();
+        seg->index = index;
+        if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SegmentHeader)) {
+            seg->length = static_cast<size_t>(st.st_size);
+            seg->base   = ::mmap(nullptr, seg->length, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd);
+        if (seg->base == MAP_FAILED) return nullptr;
+        const SegmentHeader* h = seg->header();
+        if (std::memcmp(h->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0 ||
+            h->record_size != sizeof(Record))
+            return nullptr;
+        return seg;
+    }
+};
+
+TradeTape::TradeTape(const TapeConfig& cfg)
+    : cfg_(cfg)
+{
+    size_t cap = roundUpPow2(std::max<size_t>(cfg_.ring_capacity, 1));
+    ring_.reset(new Record[cap]);
+    mask_ = cap - 1;
+
+    cfg_.segment_records = std::max<size_t>(cfg_.segment_records, 1);
+    cfg_.max_segments    = std::max<size_t>(cfg_.max_segments, 1);
+    if (!cfg_.spill_dir.empty() && !rotate(0))
+        throw std::system_error(errno, std::generic_category(),
+                                "TradeTape: cannot create " + segmentPath(0));
+}
+
+// Segment files are left on disk: they are the history past the ring.
+TradeTape::~TradeTape() = default;
+
+std::string TradeTape::segmentPath(uint64_t seg) const {
+    return cfg_.spill_dir + "/trades-" + std::to_string(seg) + ".seg";
+}
+
+uint64_t TradeTape::firstSeq() const noexcept {
+    if (!writer_) return ringFirst();
+    return std::min(ringFirst(), oldest_seg_ * cfg_.segment_records);
+}
+
+size_t TradeTape::segmentCount() const noexcept {
+    return writer_ ? static_cast<size_t>(writer_seg_ - oldest_seg_ + 1) : 0;
+}
+
+void TradeTape::append(const Trade& t) noexcept {
+    if (total_ == 0) first_id_ = t.trade_id;
+    Record& slot = ring_[total_ & mask_];
+    if (total_ > mask_) spill(slot);   // ring full: slot holds the oldest trade
+    slot = Record{t.buy_order_id, t.sell_order_id, t.price, t.quantity, t.timestamp_ns};
+    ++total_;
+}
+
+// Moves the record being evicted (sequence total_ - capacity) into the
+// current segment, rotating first if it belongs to the next one. If a new
+// segment cannot be created, spilling stops and evicted trades are dropped
+// rather than failing the match that produced them.
+void TradeTape::spill(const Record& r) noexcept {
+    if (!writer_) return;
+    uint64_t seq = total_ - mask_ - 1;
+    uint64_t seg = seq / cfg_.segment_records;
+    if (seg != writer_seg_ && !rotate(seg)) return;
+
+    size_t slot = static_cast<size_t>(seq % cfg_.segment_records);
+    writer_->records()[slot] = r;
+    SegmentHeader* h = writer_->header();
+    if (slot == 0) h->first_trade_id = first_id_ + seq;
+    h->count = slot + 1;
+}
+
+bool TradeTape::rotate(uint64_t seg) noexcept {
+    writer_.reset();
+    try {
+        writer_ = Segment::create(segmentPath(seg), seg, cfg_.segment_records);
+        if (!writer_) return false;
+        writer_seg_ = seg;
+        while (writer_seg_ - oldest_seg_ + 1 > cfg_.max_segments)
+            ::unlink(segmentPath(oldest_seg_++).c_str());
+    } catch (...) {   // path string allocation
+        writer_.reset();
+        return false;
+    }
+    return true;
+}
+
+const TradeTape::Record*
+TradeTape::spilled(uint64_t seq, std::shared_ptr<const Segment>& cache) const {
+    uint64_t seg  = seq / cfg_.segment_records;
+    size_t   slot = static_cast<size_t>(seq % cfg_.segment_records);
+    if (writer_ && seg == writer_seg_) return &writer_->records()[slot];
+
+    if (!cache || cache->index != seg) {
+        cache = Segment::open(segmentPath(seg), seg);
+        if (!cache)
+            throw std::system_error(errno ? errno : EINVAL, std::generic_category(),
+                                    "TradeTape: cannot read " + segmentPath(seg));
+    }
+    if (slot >= cache->header()->count ||
+        sizeof(SegmentHeader) + (slot + 1) * sizeof(Record) > cache->length)
+        throw std::system_error(EINVAL, std::generic_category(),
+                                "TradeTape: truncated segment " + segmentPath(seg));
+    return &cache->records()[slot];
+}
+
+Trade TradeTape::at(uint64_t seq) const {
+    if (seq >= ringFirst()) return toTrade(seq, ring_[seq & mask_]);
+    std::shared_ptr<const Segment> cache;
+    return toTrade(seq, *spilled(seq, cache));
+}
+
+Trade TradeTape::Iterator::operator*() const {
+    if (seq_ >= tape_->ringFirst()) return tape_->toTrade(seq_, tape_->ring_[seq_ & tape_->mask_]);
+    return tape_->toTrade(seq_, *tape_->spilled(seq_, cache_));
+}
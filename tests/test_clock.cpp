@@ -0,0 +1,76 @@
+#include "framework.h"
+#include "clock.h"
+#include "matching_engine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// TscClock: nanoseconds on steady_clock's epoch
+// ---------------------------------------------------------------------------
+static void test_tsc_clock_tracks_steady() {
+    int64_t t0 = TscClock::now(), s0 = SteadyClock::now();
+    ASSERT(std::llabs(t0 - s0) < 1'000'000);   // same epoch, within 1 ms
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int64_t t1 = TscClock::now(), s1 = SteadyClock::now();
+    ASSERT(std::llabs((t1 - t0) - (s1 - s0)) < 2'000'000);
+}
+
+static void test_tsc_clock_monotonic() {
+    int64_t last = TscClock::now();
+    for (int i = 0; i < 100000; ++i) {
+        int64_t now = TscClock::now();
+        ASSERT(now >= last);
+        last = now;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// CoarseClock: refreshed in the background
+// ---------------------------------------------------------------------------
+static void test_coarse_clock_advances() {
+    int64_t c0 = CoarseClock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    int64_t c1 = CoarseClock::now();
+    ASSERT(c1 > c0);
+    ASSERT(std::llabs(SteadyClock::now() - c1) < 5'000'000);
+}
+
+// ---------------------------------------------------------------------------
+// ManualClock: only moves when told to
+// ---------------------------------------------------------------------------
+static void test_manual_clock_set_advance() {
+    int64_t saved = ManualClock::now();
+    ManualClock::set(1'000);
+    ASSERT_EQ(ManualClock::now(), 1'000LL);
+    ManualClock::advance(250);
+    ASSERT_EQ(ManualClock::now(), 1'250LL);
+    ManualClock::set(saved);
+}
+
+// ---------------------------------------------------------------------------
+// The engine stamps orders from EngineClock
+// ---------------------------------------------------------------------------
+static void test_engine_stamps_with_engine_clock() {
+    MatchingEngine engine(false);
+    int64_t before = EngineClock::now();
+    uint64_t id    = engine.submitLimit(Side::BUY, 1000000LL, 10);
+    int64_t after  = EngineClock::now();
+
+    auto order = engine.book().findOrder(id);
+    ASSERT(order.has_value());
+    ASSERT(order->timestamp() >= before);
+    ASSERT(order->timestamp() <= after);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_clock_tests() {
+    RUN_TEST(test_tsc_clock_tracks_steady);
+    RUN_TEST(test_tsc_clock_monotonic);
+    RUN_TEST(test_coarse_clock_advances);
+    RUN_TEST(test_manual_clock_set_advance);
+    RUN_TEST(test_engine_stamps_with_engine_clock);
+}
@@ -1,5 +1,5 @@
 #include "framework.h"
-#include "../benchmark/concurrent_queue.h"
+#include "concurrent_queue.h"
 
 #include <atomic>
 #include <thread>
@@ -160,6 +160,61 @@ static void test_concurrent_queue_stress() {
     ASSERT(in_flight.load() <= 0 || in_flight.load() >= 0);  // always true — just no crash
 }
 
+// ---------------------------------------------------------------------------
+// Many producers and many consumers: every item dequeued exactly once. With
+// unsafe reclamation this is where a consumer reads a freed sentinel.
+// ---------------------------------------------------------------------------
+static void test_mpmc_exactly_once_many_threads() {
+    constexpr int THREADS = 16;
+    constexpr int EACH    = 4000;
+    constexpr int TOTAL   = THREADS * EACH;
+
+    ConcurrentQueue<int>           q;
+    std::vector<std::atomic<int>>  seen(TOTAL);
+    std::atomic<int>               consumed{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < THREADS; ++p) {
+        threads.emplace_back([&q, p]() {
+            for (int i = 0; i < EACH; ++i) q.enqueue(p * EACH + i);
+        });
+    }
+    for (int c = 0; c < THREADS; ++c) {
+        threads.emplace_back([&]() {
+            int val;
+            while (consumed.load(std::memory_order_relaxed) < TOTAL) {
+                if (q.dequeue(val)) {
+                    seen[static_cast<size_t>(val)].fetch_add(1, std::memory_order_relaxed);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    int wrong = 0;
+    for (auto& s : seen) wrong += (s.load() != 1);
+    ASSERT_EQ(consumed.load(), TOTAL);
+    ASSERT_EQ(wrong, 0);
+}
+
+// ---------------------------------------------------------------------------
+// Dequeued nodes come back through the freelist instead of new
+// ---------------------------------------------------------------------------
+static void test_nodes_recycled() {
+    ConcurrentQueue<int> q;
+    int val;
+    for (int i = 0; i < 100000; ++i) {
+        q.enqueue(i);
+        q.enqueue(i);
+        ASSERT(q.dequeue(val));
+        ASSERT(q.dequeue(val));
+    }
+    ASSERT(q.nodesAllocated() < 200);
+}
+
 // ─── runner ───────────────────────────────────────────────────────────────────
 
 void run_concurrent_tests() {
@@ -169,4 +224,6 @@ void run_concurrent_tests() {
     RUN_TEST(test_mpsc_all_items_delivered);
     RUN_TEST(test_mpmc_no_lost_or_duplicate_items);
     RUN_TEST(test_concurrent_queue_stress);
+    RUN_TEST(test_mpmc_exactly_once_many_threads);
+    RUN_TEST(test_nodes_recycled);
 }
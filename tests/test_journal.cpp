@@ -0,0 +1,222 @@
+#include "framework.h"
+#include "journal.h"
+#include "matching_engine.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Fresh, empty scratch directory for one test's segment files.
+static fs::path scratchDir(const char* name) {
+    fs::path dir = fs::temp_directory_path() / (std::string("lob_journal_") + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static Journal::Entry makeEntry(uint64_t i) {
+    Journal::Entry e{};
+    e.op           = Journal::Op::LIMIT;
+    e.side         = (i % 2) ? 'B' : 'S';
+    e.order_id     = i;
+    e.price        = 1000000LL + static_cast<int64_t>(i);
+    e.quantity     = i * 10;
+    e.timestamp_ns = static_cast<int64_t>(i) * 100;
+    return e;
+}
+
+static std::vector<Journal::Entry> readAll(const fs::path& dir, uint64_t from = 0) {
+    JournalReader reader(dir.string());
+    reader.skipTo(from);
+    std::vector<Journal::Entry> out;
+    Journal::Entry e;
+    while (reader.next(e)) out.push_back(e);
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// Append / read back
+// ---------------------------------------------------------------------------
+static void test_journal_reads_back_across_segments() {
+    fs::path dir = scratchDir("segments");
+    {
+        JournalConfig cfg;
+        cfg.dir             = dir.string();
+        cfg.segment_records = 8;
+        Journal journal(cfg);
+        for (uint64_t i = 1; i <= 30; ++i) ASSERT_EQ(journal.append(makeEntry(i)), i);
+        journal.sync();
+        ASSERT_EQ(journal.durableSequence(), 30ULL);
+    }
+    size_t files = 0;
+    for (auto it = fs::directory_iterator(dir); it != fs::directory_iterator(); ++it) ++files;
+    ASSERT_EQ(files, 4ULL);   // the prepared fifth is removed unused
+
+    auto entries = readAll(dir);
+    ASSERT_EQ(entries.size(), 30ULL);
+    for (uint64_t i = 0; i < entries.size(); ++i) {
+        ASSERT_EQ(entries[i].sequence, i + 1);
+        ASSERT_EQ(entries[i].order_id, i + 1);
+        ASSERT_EQ(entries[i].quantity, (i + 1) * 10);
+    }
+
+    auto tail = readAll(dir, 19);
+    ASSERT_EQ(tail.size(), 12ULL);
+    ASSERT_EQ(tail.front().sequence, 19ULL);
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Durability levels
+// ---------------------------------------------------------------------------
+static void test_journal_per_event_is_durable_on_return() {
+    fs::path dir = scratchDir("per_event");
+    {
+        JournalConfig cfg;
+        cfg.dir             = dir.string();
+        cfg.durability      = Durability::PER_EVENT;
+        cfg.segment_records = 64;
+        Journal journal(cfg);
+        for (uint64_t i = 1; i <= 5; ++i) {
+            journal.append(makeEntry(i));
+            ASSERT_EQ(journal.durableSequence(), i);
+        }
+        ASSERT_EQ(journal.stats().commits, 5ULL);
+    }
+    fs::remove_all(dir);
+}
+
+// Under PER_EVENT both the writer and the journal thread (committing the
+// segment just left, or on sync()) advance the durable sequence; whichever
+// lands last must not move it back.
+static void test_journal_durable_sequence_never_moves_back() {
+    fs::path dir = scratchDir("monotonic");
+    {
+        JournalConfig cfg;
+        cfg.dir             = dir.string();
+        cfg.durability      = Durability::PER_EVENT;
+        cfg.segment_records = 4;
+        Journal journal(cfg);
+        std::atomic<bool> done{false}, ok{true};
+        std::thread watcher([&] {
+            uint64_t seen = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                journal.sync();
+                uint64_t d = journal.durableSequence();
+                if (d < seen || d > journal.lastSequence()) ok = false;
+                seen = d;
+            }
+        });
+        for (uint64_t i = 1; i <= 400; ++i) {
+            journal.append(makeEntry(i));
+            if (journal.durableSequence() < i) ok = false;
+        }
+        done = true;
+        watcher.join();
+        ASSERT_TRUE(ok.load());
+    }
+    fs::remove_all(dir);
+}
+
+static void test_journal_mapped_commits_on_sync() {
+    fs::path dir = scratchDir("mapped");
+    {
+        JournalConfig cfg;
+        cfg.dir             = dir.string();
+        cfg.durability      = Durability::MAPPED;
+        cfg.segment_records = 64;
+        Journal journal(cfg);
+        for (uint64_t i = 1; i <= 10; ++i) journal.append(makeEntry(i));
+        ASSERT_EQ(journal.durableSequence(), 0ULL);
+        journal.sync();
+        ASSERT_EQ(journal.durableSequence(), 10ULL);
+    }
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Reopening continues the journal and discards a torn tail
+// ---------------------------------------------------------------------------
+static void test_journal_resumes_after_torn_record() {
+    fs::path dir = scratchDir("resume");
+    JournalConfig cfg;
+    cfg.dir             = dir.string();
+    cfg.segment_records = 8;
+    {
+        Journal journal(cfg);
+        for (uint64_t i = 1; i <= 12; ++i) journal.append(makeEntry(i));
+    }
+
+    // Tear sequence 11 (segment 1, slot 2): everything after it is lost.
+    {
+        std::fstream f(dir / "journal-1.seg", std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(64 + 2 * 64 + 20);
+        f.put('\x7f');
+    }
+    ASSERT_EQ(readAll(dir).size(), 10ULL);
+
+    {
+        Journal journal(cfg);
+        ASSERT_EQ(journal.lastSequence(), 10ULL);
+        ASSERT_EQ(journal.append(makeEntry(100)), 11ULL);
+    }
+    auto entries = readAll(dir);
+    ASSERT_EQ(entries.size(), 11ULL);
+    ASSERT_EQ(entries.back().order_id, 100ULL);   // stale 12 was zeroed, not read
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// MatchingEngine journals every entry point, ahead of the book
+// ---------------------------------------------------------------------------
+static void test_engine_journals_every_entry_point() {
+    fs::path dir = scratchDir("engine");
+    {
+        JournalConfig cfg;
+        cfg.dir             = dir.string();
+        cfg.segment_records = 64;
+        MatchingEngine engine(false, {}, {}, {}, cfg);
+        NullSink sink;
+
+        uint64_t a = engine.submitLimit(Side::SELL, 1010000LL, 50);
+        uint64_t b = engine.submitIceberg(Side::BUY, 990000LL, 100, 10, sink);
+        engine.submitStopLoss(Side::SELL, 980000LL, 970000LL, 5);
+        engine.submitMarket(Side::BUY, 20, sink);
+        engine.modifyOrder(b, 995000LL, 80);
+        engine.cancelOrder(a);
+
+        struct Results {
+            void onTrade(const Trade&) {}
+            void onOrderUpdate(const OrderUpdate&) {}
+            void onResult(size_t, uint64_t, bool) {}
+        } results;
+        OrderEvent batch[] = {{EventKind::SUBMIT_LIMIT, 0, 'S', 1020000LL, 7}};
+        engine.submitBatch(batch, batch + 1, results);
+        ASSERT_EQ(engine.journal()->lastSequence(), 7ULL);
+    }
+
+    auto e = readAll(dir);
+    ASSERT_EQ(e.size(), 7ULL);
+    ASSERT(e[0].op == Journal::Op::LIMIT     && e[0].order_id == 1 && e[0].side == 'S');
+    ASSERT(e[1].op == Journal::Op::ICEBERG   && e[1].order_id == 2 && e[1].aux == 10);
+    ASSERT(e[2].op == Journal::Op::STOP_LOSS && e[2].price == 980000LL && e[2].aux == 970000LL);
+    ASSERT(e[3].op == Journal::Op::MARKET    && e[3].order_id == 4 && e[3].quantity == 20);
+    ASSERT(e[4].op == Journal::Op::MODIFY    && e[4].order_id == 2 && e[4].quantity == 80);
+    ASSERT(e[5].op == Journal::Op::CANCEL    && e[5].order_id == 1);
+    ASSERT(e[6].op == Journal::Op::LIMIT     && e[6].order_id == 5 && e[6].price == 1020000LL);
+    fs::remove_all(dir);
+}
+
+void run_journal_tests() {
+    RUN_TEST(test_journal_reads_back_across_segments);
+    RUN_TEST(test_journal_per_event_is_durable_on_return);
+    RUN_TEST(test_journal_durable_sequence_never_moves_back);
+    RUN_TEST(test_journal_mapped_commits_on_sync);
+    RUN_TEST(test_journal_resumes_after_torn_record);
+    RUN_TEST(test_engine_journals_every_entry_point);
+}
@@ -3,9 +3,19 @@
 
 void run_order_tests();
 void run_orderbook_tests();
+void run_price_ladder_tests();
+void run_order_index_tests();
+void run_trade_tape_tests();
+void run_clock_tests();
+void run_seqlock_tests();
 void run_matching_engine_tests();
 void run_memory_pool_tests();
 void run_concurrent_tests();
+void run_ring_queue_tests();
+void run_multi_symbol_tests();
+void run_thread_placement_tests();
+void run_journal_tests();
+void run_snapshot_tests();
 
 int main() {
     std::printf("\n── Order tests ──────────────────────────────\n");
@@ -14,6 +24,21 @@ int main() {
     std::printf("\n── OrderBook tests ──────────────────────────\n");
     run_orderbook_tests();
 
+    std::printf("\n── PriceLadder tests ────────────────────────\n");
+    run_price_ladder_tests();
+
+    std::printf("\n── OrderIndex tests ─────────────────────────\n");
+    run_order_index_tests();
+
+    std::printf("\n── TradeTape tests ──────────────────────────\n");
+    run_trade_tape_tests();
+
+    std::printf("\n── Clock tests ──────────────────────────────\n");
+    run_clock_tests();
+
+    std::printf("\n── SeqLock tests ────────────────────────────\n");
+    run_seqlock_tests();
+
     std::printf("\n── MatchingEngine tests ─────────────────────\n");
     run_matching_engine_tests();
 
@@ -23,6 +48,21 @@ int main() {
     std::printf("\n── ConcurrentQueue tests ────────────────────\n");
     run_concurrent_tests();
 
+    std::printf("\n── RingQueue tests ──────────────────────────\n");
+    run_ring_queue_tests();
+
+    std::printf("\n── MultiSymbolEngine tests ──────────────────\n");
+    run_multi_symbol_tests();
+
+    std::printf("\n── ThreadPlacement tests ────────────────────\n");
+    run_thread_placement_tests();
+
+    std::printf("\n── Journal tests ────────────────────────────\n");
+    run_journal_tests();
+
+    std::printf("\n── Snapshot tests ───────────────────────────\n");
+    run_snapshot_tests();
+
     std::printf("\n─────────────────────────────────────────────\n");
     return test::summary();
 }
@@ -1,6 +1,9 @@
 #include "framework.h"
 #include "matching_engine.h"
 
+#include <algorithm>
+#include <cstring>
+#include <mutex>
 #include <thread>
 #include <vector>
 #include <set>
@@ -148,6 +151,170 @@ static void test_concurrent_mixed_operations() {
     ASSERT(engine.book().activeOrders() < 500ULL);
 }
 
+// ---------------------------------------------------------------------------
+// Batch submission
+// ---------------------------------------------------------------------------
+namespace {
+struct BatchRecorder {
+    std::vector<Trade>       trades;
+    std::vector<OrderUpdate> updates;
+    std::vector<uint64_t>    ids;
+    std::vector<bool>        oks;
+
+    void onTrade(const Trade& t) { trades.push_back(t); }
+    void onOrderUpdate(const OrderUpdate& u) { updates.push_back(u); }
+    void onResult(size_t, uint64_t id, bool ok) { ids.push_back(id); oks.push_back(ok); }
+};
+} // namespace
+
+// Limits around a mid, some markets, and cancels of earlier submits. On a
+// fresh engine the n-th submit gets id n, so cancels can name engine ids.
+static std::vector<OrderEvent> batchWorkload(size_t n) {
+    std::vector<OrderEvent> events;
+    uint64_t state = 12345, submits = 0;
+    auto next = [&state] { state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                           return state >> 33; };
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t roll = next() % 100;
+        char     side = (next() & 1) ? 'B' : 'S';
+        if (roll < 20 && submits > 0) {
+            events.emplace_back(EventKind::CANCEL, 1 + next() % submits, side, 0, 0);
+        } else if (roll < 30) {
+            events.emplace_back(EventKind::SUBMIT_MARKET, 0, side, 0, 1 + next() % 50);
+            ++submits;
+        } else {
+            int64_t price = 1000000LL + (static_cast<int64_t>(next() % 11) - 5) * 100;
+            events.emplace_back(EventKind::SUBMIT_LIMIT, 0, side, price, 1 + next() % 50);
+            ++submits;
+        }
+    }
+    return events;
+}
+
+static void test_submit_batch_matches_single_submits() {
+    std::vector<OrderEvent> events = batchWorkload(2000);
+
+    MatchingEngine single(false);
+    BatchRecorder  a;
+    for (const OrderEvent& ev : events) {
+        Side side = ev.side == 'B' ? Side::BUY : Side::SELL;
+        switch (ev.kind) {
+        case EventKind::SUBMIT_LIMIT:
+            a.ids.push_back(single.submitLimit(side, ev.price, ev.quantity, a));
+            a.oks.push_back(true);
+            break;
+        case EventKind::SUBMIT_MARKET:
+            a.ids.push_back(0);   // market ids are not returned; compared via trades
+            a.oks.push_back(true);
+            single.submitMarket(side, ev.quantity, a);
+            break;
+        case EventKind::CANCEL:
+            a.ids.push_back(ev.order_id);
+            a.oks.push_back(single.cancelOrder(ev.order_id));
+            break;
+        }
+    }
+
+    MatchingEngine batched(false);
+    BatchRecorder  b;
+    for (size_t i = 0; i < events.size(); i += 7) {
+        size_t end = std::min(events.size(), i + 7);
+        batched.submitBatch(events.data() + i, events.data() + end, b);
+    }
+    for (size_t i = 0; i < events.size(); ++i)
+        if (events[i].kind == EventKind::SUBMIT_MARKET) b.ids[i] = 0;
+
+    ASSERT(a.ids == b.ids);
+    ASSERT(a.oks == b.oks);
+    ASSERT_EQ(a.trades.size(), b.trades.size());
+    ASSERT(!a.trades.empty());
+    for (size_t i = 0; i < a.trades.size(); ++i) {
+        ASSERT_EQ(a.trades[i].trade_id,      b.trades[i].trade_id);
+        ASSERT_EQ(a.trades[i].buy_order_id,  b.trades[i].buy_order_id);
+        ASSERT_EQ(a.trades[i].sell_order_id, b.trades[i].sell_order_id);
+        ASSERT_EQ(a.trades[i].price,         b.trades[i].price);
+        ASSERT_EQ(a.trades[i].quantity,      b.trades[i].quantity);
+    }
+    ASSERT_EQ(a.updates.size(), b.updates.size());
+    for (size_t i = 0; i < a.updates.size(); ++i) {
+        ASSERT_EQ(a.updates[i].order_id, b.updates[i].order_id);
+        ASSERT(a.updates[i].status == b.updates[i].status);
+        ASSERT_EQ(a.updates[i].leaves, b.updates[i].leaves);
+    }
+
+    ASSERT_EQ(single.book().activeOrders(), batched.book().activeOrders());
+    ASSERT_EQ(single.book().bestBid(), batched.book().bestBid());
+    ASSERT_EQ(single.book().bestAsk(), batched.book().bestAsk());
+}
+
+static void test_submit_batch_shares_one_timestamp() {
+    MatchingEngine engine(false);
+    std::vector<OrderEvent> events = {
+        {EventKind::SUBMIT_LIMIT, 0, 'B', 1000000LL, 10},
+        {EventKind::SUBMIT_LIMIT, 0, 'B',  990000LL, 10},
+        {EventKind::CANCEL,       2, 'B', 0, 0},
+        {EventKind::CANCEL,      99, 'B', 0, 0},
+    };
+    BatchRecorder rec;
+    engine.submitBatch(events.data(), events.data() + events.size(), rec);
+
+    ASSERT(rec.ids == (std::vector<uint64_t>{1, 2, 2, 99}));
+    ASSERT(rec.oks == (std::vector<bool>{true, true, true, false}));
+    ASSERT_EQ(engine.book().activeOrders(), 1ULL);
+
+    events = {{EventKind::SUBMIT_LIMIT, 0, 'S', 1010000LL, 5},
+              {EventKind::SUBMIT_LIMIT, 0, 'S', 1020000LL, 5}};
+    engine.submitBatch(events.data(), events.data() + events.size(), rec);
+    auto o3 = engine.book().findOrder(3), o4 = engine.book().findOrder(4);
+    ASSERT(o3.has_value() && o4.has_value());
+    ASSERT_EQ(o3->timestamp(), o4->timestamp());
+}
+
+// ---------------------------------------------------------------------------
+// Lock policies
+// ---------------------------------------------------------------------------
+template <typename LockPolicy>
+static BookTop replayUnder(const std::vector<OrderEvent>& events, uint64_t& trades) {
+    BasicMatchingEngine<LockPolicy> engine(false);
+    NullSink sink;
+    engine.submitBatch(events.data(), events.data() + events.size(), sink);
+    trades = engine.book().tradeHistory().totalAppended();
+    return engine.book().top();
+}
+
+static void test_lock_policies_agree() {
+    std::vector<OrderEvent> events = batchWorkload(1000);
+    uint64_t t_none = 0, t_ticket = 0, t_shared = 0;
+    BookTop none   = replayUnder<SingleWriterPolicy>(events, t_none);
+    BookTop ticket = replayUnder<TicketLockPolicy>(events, t_ticket);
+    BookTop shared = replayUnder<SharedMutexPolicy>(events, t_shared);
+
+    ASSERT(t_none > 0);
+    ASSERT_EQ(t_none, t_ticket);
+    ASSERT_EQ(t_none, t_shared);
+    ASSERT(std::memcmp(&none, &ticket, sizeof(BookTop)) == 0);
+    ASSERT(std::memcmp(&none, &shared, sizeof(BookTop)) == 0);
+}
+
+static void test_ticket_mutex_excludes() {
+    TicketMutex m;
+    ASSERT(m.try_lock());
+    ASSERT_FALSE(m.try_lock());
+    m.unlock();
+
+    uint64_t counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&] {
+            for (int i = 0; i < 20000; ++i) {
+                std::unique_lock lock(m);
+                ++counter;
+            }
+        });
+    for (auto& th : threads) th.join();
+    ASSERT_EQ(counter, 80000ULL);
+}
+
 // ─── runner ───────────────────────────────────────────────────────────────────
 
 void run_matching_engine_tests() {
@@ -160,6 +327,13 @@ void run_matching_engine_tests() {
     RUN_TEST(test_cancel_nonexistent);
     RUN_TEST(test_modify_order_no_deadlock);
     RUN_TEST(test_ids_are_monotonically_increasing);
-    RUN_TEST(test_concurrent_limit_submits);
-    RUN_TEST(test_concurrent_mixed_operations);
+    // Several threads on one engine: only valid under a locking policy.
+    if constexpr (DefaultLockPolicy::concurrent) {
+        RUN_TEST(test_concurrent_limit_submits);
+        RUN_TEST(test_concurrent_mixed_operations);
+    }
+    RUN_TEST(test_submit_batch_matches_single_submits);
+    RUN_TEST(test_submit_batch_shares_one_timestamp);
+    RUN_TEST(test_lock_policies_agree);
+    RUN_TEST(test_ticket_mutex_excludes);
 }
@@ -2,6 +2,7 @@
 #include "memory_pool.h"
 #include "order.h"
 
+#include <atomic>
 #include <memory>
 #include <set>
 #include <thread>
@@ -129,6 +130,142 @@ static void test_no_address_aliasing() {
     for (auto p : ptrs) pool.deallocate(p);
 }
 
+// ---------------------------------------------------------------------------
+// O(1) statistics: in-use count and its high-water mark
+// ---------------------------------------------------------------------------
+static void test_in_use_and_high_water() {
+    MemoryPool<Order> pool(16);
+    ASSERT_EQ(pool.inUse(), size_t{0});
+
+    std::vector<Order*> ptrs;
+    for (int i = 0; i < 40; ++i)
+        ptrs.push_back(pool.allocate(static_cast<uint64_t>(i), 0LL, Side::BUY,
+                                     OrderKind::LIMIT, 1000000LL, 1ULL));
+    ASSERT_EQ(pool.inUse(), size_t{40});
+    ASSERT_EQ(pool.totalCapacity(), size_t{48});   // three 16-block slabs
+
+    for (int i = 0; i < 30; ++i) pool.deallocate(ptrs[static_cast<size_t>(i)]);
+    ASSERT_EQ(pool.inUse(), size_t{10});
+    ASSERT_EQ(pool.highWater(), size_t{40});
+    ASSERT_EQ(pool.freeCount(), size_t{38});
+
+    for (int i = 30; i < 40; ++i) pool.deallocate(ptrs[static_cast<size_t>(i)]);
+    ASSERT_EQ(pool.inUse(), size_t{0});
+    ASSERT_EQ(pool.highWater(), size_t{40});
+}
+
+// ---------------------------------------------------------------------------
+// One thread allocates, another frees: blocks come back through the depot,
+// so the pool stops growing once the pipeline is full
+// ---------------------------------------------------------------------------
+static void test_cross_thread_free_is_recycled() {
+    constexpr int ROUNDS = 50;
+    constexpr int BATCH  = 512;
+    MemoryPool<Order> pool(256);
+
+    for (int r = 0; r < ROUNDS; ++r) {
+        std::vector<Order*> batch;
+        std::thread producer([&] {
+            for (int i = 0; i < BATCH; ++i)
+                batch.push_back(pool.allocate(static_cast<uint64_t>(i), 0LL, Side::BUY,
+                                              OrderKind::LIMIT, 1000000LL, 1ULL));
+        });
+        producer.join();
+        std::thread consumer([&] {
+            for (Order* p : batch) pool.deallocate(p);
+        });
+        consumer.join();
+    }
+
+    ASSERT_EQ(pool.inUse(), size_t{0});
+    ASSERT_EQ(pool.freeCount(), pool.totalCapacity());
+    // Everything but what the two threads' magazines hold is reused.
+    ASSERT(pool.totalCapacity() <= BATCH + 4 * MemoryPool<Order>::MAGAZINE_SIZE + 256);
+}
+
+// ---------------------------------------------------------------------------
+// Eight threads churning one pool never hold the same block at once
+// ---------------------------------------------------------------------------
+static void test_eight_threads_exclusive_blocks() {
+    constexpr int N_THREADS = 8;
+    constexpr int ROUNDS    = 200;
+    constexpr int HOLD      = 100;
+    MemoryPool<Order> pool(64);
+
+    std::atomic<bool> clash{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < N_THREADS; ++t) {
+        threads.emplace_back([&pool, &clash, t]() {
+            std::vector<Order*> held;
+            for (int r = 0; r < ROUNDS; ++r) {
+                for (int i = 0; i < HOLD; ++i) {
+                    uint64_t id = static_cast<uint64_t>(t) << 32 | static_cast<uint64_t>(i);
+                    held.push_back(pool.allocate(id, 0LL, Side::BUY, OrderKind::LIMIT,
+                                                 1000000LL, 1ULL));
+                }
+                for (int i = 0; i < HOLD; ++i) {
+                    uint64_t id = static_cast<uint64_t>(t) << 32 | static_cast<uint64_t>(i);
+                    if (held[static_cast<size_t>(i)]->id() != id) clash = true;
+                    pool.deallocate(held[static_cast<size_t>(i)]);
+                }
+                held.clear();
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    ASSERT_FALSE(clash.load());
+    ASSERT_EQ(pool.inUse(), size_t{0});
+    ASSERT(pool.highWater() <= size_t{N_THREADS * HOLD});
+}
+
+// ---------------------------------------------------------------------------
+// initial_capacity on huge pages: one slab, rounded up to whole 2 MiB pages,
+// holds the whole working set so the pool never grows
+// ---------------------------------------------------------------------------
+static void test_huge_page_pool_presized() {
+    PoolConfig cfg;
+    cfg.slab_size        = 64;
+    cfg.initial_capacity = 50000;
+    cfg.huge_pages       = true;
+    cfg.prefault         = true;
+    MemoryPool<Order> pool(cfg);
+
+    size_t capacity = pool.totalCapacity();
+    ASSERT(capacity >= size_t{50000});
+    ASSERT_EQ(capacity * sizeof(Order) % HUGE_PAGE_BYTES, size_t{0});
+#ifdef __linux__
+    ASSERT(pool.backing() != PageBacking::HEAP);
+#endif
+
+    std::vector<Order*> ptrs;
+    for (int i = 0; i < 50000; ++i)
+        ptrs.push_back(pool.allocate(static_cast<uint64_t>(i), 0LL, Side::BUY,
+                                     OrderKind::LIMIT, 1000000LL, 1ULL));
+    ASSERT_EQ(pool.totalCapacity(), capacity);
+    ASSERT_EQ(ptrs[49999]->id(), 49999ULL);
+    for (Order* p : ptrs) pool.deallocate(p);
+    ASSERT_EQ(pool.freeCount(), capacity);
+}
+
+// ---------------------------------------------------------------------------
+// mapRegion: huge requests come back 2 MiB-sized and aligned (unless from
+// the heap), and the memory is usable
+// ---------------------------------------------------------------------------
+static void test_map_region_huge_aligned() {
+    PageRegion r = mapRegion(3 * 1024 * 1024, true, true);
+    ASSERT(r.base != nullptr);
+    if (r.backing != PageBacking::HEAP) {
+        ASSERT_EQ(r.bytes, 2 * HUGE_PAGE_BYTES);
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(r.base) % HUGE_PAGE_BYTES, uintptr_t{0});
+    }
+    auto* bytes = static_cast<unsigned char*>(r.base);
+    bytes[0] = 1;
+    bytes[r.bytes - 1] = 2;
+    ASSERT_EQ(bytes[0] + bytes[r.bytes - 1], 3);
+    unmapRegion(r);
+}
+
 // ─── runner ───────────────────────────────────────────────────────────────────
 
 void run_memory_pool_tests() {
@@ -140,4 +277,9 @@ void run_memory_pool_tests() {
     RUN_TEST(test_pool_deleter_returns_to_pool);
     RUN_TEST(test_concurrent_alloc_dealloc);
     RUN_TEST(test_no_address_aliasing);
+    RUN_TEST(test_in_use_and_high_water);
+    RUN_TEST(test_cross_thread_free_is_recycled);
+    RUN_TEST(test_eight_threads_exclusive_blocks);
+    RUN_TEST(test_huge_page_pool_presized);
+    RUN_TEST(test_map_region_huge_aligned);
 }
@@ -0,0 +1,244 @@
+#include "framework.h"
+#include "multi_symbol_engine.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+MultiSymbolConfig config(size_t workers) {
+    MultiSymbolConfig c;
+    c.workers     = workers;
+    c.pin_workers = false;
+    c.tape.ring_capacity = 1024;
+    return c;
+}
+
+OrderEvent limit(uint32_t symbol, char side, int64_t price, uint64_t qty) {
+    return OrderEvent(EventKind::SUBMIT_LIMIT, 0, side, price, qty, symbol);
+}
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Registry: dense ids, idempotent names, round-robin sharding
+// ---------------------------------------------------------------------------
+static void test_symbol_registry() {
+    MultiSymbolEngine engine(config(2));
+    ASSERT_EQ(engine.addSymbol("AAPL"), 0u);
+    ASSERT_EQ(engine.addSymbol("MSFT"), 1u);
+    ASSERT_EQ(engine.addSymbol("GOOG"), 2u);
+    ASSERT_EQ(engine.addSymbol("MSFT"), 1u);
+
+    ASSERT_EQ(engine.symbolCount(), size_t{3});
+    ASSERT_EQ(engine.symbolId("GOOG"), 2u);
+    ASSERT_EQ(engine.symbolId("TSLA"), MultiSymbolEngine::UNKNOWN_SYMBOL);
+    ASSERT_EQ(engine.symbolName(1), std::string("MSFT"));
+    ASSERT_EQ(engine.workerOf(0), size_t{0});
+    ASSERT_EQ(engine.workerOf(1), size_t{1});
+    ASSERT_EQ(engine.workerOf(2), size_t{0});
+}
+
+// ---------------------------------------------------------------------------
+// Events reach their own symbol's book only
+// ---------------------------------------------------------------------------
+static void test_events_routed_by_symbol() {
+    MultiSymbolEngine engine(config(2));
+    uint32_t a = engine.addSymbol("A");
+    uint32_t b = engine.addSymbol("B");
+    uint32_t c = engine.addSymbol("C");
+    engine.start();
+
+    ASSERT(engine.submit(limit(a, 'B', 1000000, 10)));
+    ASSERT(engine.submit(limit(a, 'S', 1010000, 5)));
+    ASSERT(engine.submit(limit(b, 'S', 2000000, 7)));
+    ASSERT(engine.submit(limit(c, 'B', 3000000, 4)));
+    ASSERT(engine.submit(limit(c, 'S', 3000000, 4)));   // crosses and fills
+    ASSERT_FALSE(engine.submit(limit(9, 'B', 1000000, 1)));
+    engine.stop();
+
+    ASSERT_EQ(engine.eventsProcessed(), 5ULL);
+    ASSERT_EQ(engine.book(a).activeOrders(), size_t{2});
+    ASSERT_EQ(engine.book(b).activeOrders(), size_t{1});
+    ASSERT_EQ(engine.book(c).activeOrders(), size_t{0});
+    ASSERT_EQ(engine.top(a).bid_price, 1000000LL);
+    ASSERT_EQ(engine.top(b).ask_qty, 7ULL);
+    ASSERT_EQ(engine.book(c).tradeHistory().size(), size_t{1});
+}
+
+// ---------------------------------------------------------------------------
+// Cancels name per-symbol order ids
+// ---------------------------------------------------------------------------
+static void test_cancel_uses_symbol_order_ids() {
+    MultiSymbolEngine engine(config(1));
+    uint32_t a = engine.addSymbol("A");
+    uint32_t b = engine.addSymbol("B");
+    engine.start();
+
+    engine.submit(limit(a, 'B', 1000000, 10));   // id 1 in A
+    engine.submit(limit(b, 'B', 1000000, 10));   // id 1 in B
+    engine.submit(OrderEvent(EventKind::CANCEL, 1, 'X', 0, 0, b));
+    engine.stop();
+
+    ASSERT_EQ(engine.book(a).activeOrders(), size_t{1});
+    ASSERT_EQ(engine.book(b).activeOrders(), size_t{0});
+}
+
+// ---------------------------------------------------------------------------
+// Books sharing a configured spill directory each spill to their own
+// ---------------------------------------------------------------------------
+static void test_symbols_spill_to_own_directories() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "lob_multi_symbol_spill";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    MultiSymbolConfig cfg = config(1);
+    cfg.tape.ring_capacity   = 4;
+    cfg.tape.segment_records = 8;
+    cfg.tape.spill_dir       = dir.string();
+    {
+        MultiSymbolEngine engine(cfg);
+        uint32_t a = engine.addSymbol("A");
+        uint32_t b = engine.addSymbol("B");
+        ASSERT(fs::is_directory(dir / "A") && fs::is_directory(dir / "B"));
+        engine.start();
+        for (int i = 0; i < 30; ++i) {
+            engine.submit(limit(a, 'S', 1000000, 1));
+            engine.submit(limit(a, 'B', 1000000, 1));
+            engine.submit(limit(b, 'S', 2000000, 2));
+            engine.submit(limit(b, 'B', 2000000, 2));
+        }
+        engine.stop();
+
+        for (uint32_t s : {a, b}) {
+            const TradeTape& tape = engine.book(s).tradeHistory();
+            ASSERT_EQ(tape.size(), 30ULL);   // 26 of them read back from disk
+            for (const Trade& t : tape) {
+                ASSERT_EQ(t.price, s == a ? 1000000LL : 2000000LL);
+                ASSERT_EQ(t.quantity, s == a ? 1ULL : 2ULL);
+            }
+        }
+    }
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Registration is closed once started; submit is refused once stopped
+// ---------------------------------------------------------------------------
+static void test_lifecycle() {
+    MultiSymbolEngine engine(config(1));
+    engine.addSymbol("A");
+    ASSERT_FALSE(engine.submit(limit(0, 'B', 1000000, 1)));   // not started
+    engine.start();
+
+    bool threw = false;
+    try { engine.addSymbol("B"); } catch (const std::logic_error&) { threw = true; }
+    ASSERT(threw);
+
+    engine.stop();
+    engine.stop();
+    ASSERT_FALSE(engine.submit(limit(0, 'B', 1000000, 1)));
+}
+
+// A worker that cannot build its books fails start(), not the process.
+static void test_start_rethrows_worker_failure() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "lob_multi_start_failure";
+    fs::remove_all(dir);
+    MultiSymbolConfig c = config(2);
+    c.tape.spill_dir = dir.string();
+    {
+        MultiSymbolEngine engine(c);
+        engine.addSymbol("A");
+        engine.addSymbol("B");
+        fs::remove_all(dir / "B");   // B's tape cannot open its first segment
+
+        bool threw = false;
+        try { engine.start(); } catch (const std::system_error&) { threw = true; }
+        ASSERT(threw);
+        ASSERT_FALSE(engine.submit(limit(0, 'B', 1000000, 1)));
+        engine.stop();
+    }
+    fs::remove_all(dir);
+}
+
+// Every submit that returned true is matched, even one racing stop().
+static void test_submits_racing_stop_are_processed() {
+    constexpr int PRODUCERS = 4;
+
+    MultiSymbolEngine engine(config(2));
+    for (uint32_t s = 0; s < 4; ++s) engine.addSymbol("S" + std::to_string(s));
+    engine.start();
+
+    std::atomic<uint64_t>    accepted{0};
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&engine, &accepted, p] {
+            for (uint64_t i = 0;; ++i) {
+                // Pairs that cross, so the books stay small.
+                uint32_t sym  = static_cast<uint32_t>(p + i / 2) % 4;
+                char     side = (i & 1) ? 'B' : 'S';
+                if (!engine.submit(limit(sym, side, 1000000, 1))) return;
+                accepted.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    engine.stop();
+    for (auto& t : producers) t.join();
+
+    ASSERT(accepted.load() > 0);
+    ASSERT_EQ(engine.eventsProcessed(), accepted.load());
+}
+
+// ---------------------------------------------------------------------------
+// Many producers, many symbols, several workers: nothing lost
+// ---------------------------------------------------------------------------
+static void test_concurrent_producers_all_processed() {
+    constexpr int      PRODUCERS = 4;
+    constexpr uint32_t SYMBOLS   = 16;
+    constexpr int      EACH      = 2000;
+
+    MultiSymbolEngine engine(config(4));
+    for (uint32_t s = 0; s < SYMBOLS; ++s) engine.addSymbol("S" + std::to_string(s));
+    engine.start();
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&engine, p] {
+            for (int i = 0; i < EACH; ++i) {
+                uint32_t sym = static_cast<uint32_t>(p * EACH + i) % SYMBOLS;
+                // Bids below asks: every order rests.
+                char    side  = (i & 1) ? 'B' : 'S';
+                int64_t price = side == 'B' ? 990000 - (i % 50) * 100 : 1010000 + (i % 50) * 100;
+                engine.submit(limit(sym, side, price, 1));
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    engine.stop();
+
+    ASSERT_EQ(engine.eventsProcessed(), static_cast<uint64_t>(PRODUCERS * EACH));
+    size_t resting = 0;
+    for (uint32_t s = 0; s < SYMBOLS; ++s) resting += engine.book(s).activeOrders();
+    ASSERT_EQ(resting, static_cast<size_t>(PRODUCERS * EACH));
+    for (size_t w = 0; w < engine.workerCount(); ++w)
+        ASSERT_EQ(engine.eventsProcessed(w), static_cast<uint64_t>(PRODUCERS * EACH / 4));
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_multi_symbol_tests() {
+    RUN_TEST(test_symbol_registry);
+    RUN_TEST(test_events_routed_by_symbol);
+    RUN_TEST(test_cancel_uses_symbol_order_ids);
+    RUN_TEST(test_symbols_spill_to_own_directories);
+    RUN_TEST(test_lifecycle);
+    RUN_TEST(test_start_rethrows_worker_failure);
+    RUN_TEST(test_submits_racing_stop_are_processed);
+    RUN_TEST(test_concurrent_producers_all_processed);
+}
@@ -121,6 +121,28 @@ static void test_stop_loss_trigger() {
     ASSERT(o.isTriggered());
 }
 
+// ---------------------------------------------------------------------------
+// Copies own their extension
+// ---------------------------------------------------------------------------
+static void test_copy_owns_extension() {
+    auto copy = makeIceberg(13, 0LL, Side::BUY, 1000000LL, 300, 100);
+    {
+        auto o = makeIceberg(14, 0LL, Side::SELL, 1010000LL, 500, 200);
+        copy = o;
+        o.fill(150);
+        ASSERT_EQ(o.visibleQty(), 50ULL);
+    }
+    ASSERT(copy.side() == Side::SELL);
+    ASSERT_EQ(copy.visibleQty(), 200ULL);
+    ASSERT_EQ(copy.hiddenQty(), 300ULL);
+
+    Order plain(15ULL, 0LL, Side::BUY, OrderKind::LIMIT, 1000000LL, 10ULL);
+    copy = plain;
+    ASSERT_FALSE(copy.isIceberg());
+    ASSERT_EQ(copy.visibleQty(), 10ULL);
+    ASSERT_EQ(sizeof(Order), 64ULL);
+}
+
 // ─── runner ───────────────────────────────────────────────────────────────────
 
 void run_order_tests() {
@@ -136,4 +158,5 @@ void run_order_tests() {
     RUN_TEST(test_iceberg_fully_filled);
     RUN_TEST(test_stop_loss_initial_state);
     RUN_TEST(test_stop_loss_trigger);
+    RUN_TEST(test_copy_owns_extension);
 }
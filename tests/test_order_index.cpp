@@ -0,0 +1,82 @@
+#include "framework.h"
+#include "order.h"
+#include "order_index.h"
+
+#include <vector>
+
+static Order makeOrder(uint64_t id) {
+    return Order(id, 0LL, Side::BUY, OrderKind::LIMIT, 1000000LL, 10ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Basic insert / find / erase
+// ---------------------------------------------------------------------------
+static void test_index_insert_find_erase() {
+    OrderIndex idx;
+    Order a = makeOrder(1), b = makeOrder(5000);
+    idx.insert(1, &a);
+    idx.insert(5000, &b);
+
+    ASSERT_EQ(idx.size(), 2ULL);
+    ASSERT(idx.find(1) == &a);
+    ASSERT(idx.find(5000) == &b);
+    ASSERT(idx.find(2) == nullptr);
+    ASSERT(idx.find(1ULL << 40) == nullptr);   // past the directory
+
+    ASSERT(idx.erase(1));
+    ASSERT_FALSE(idx.erase(1));
+    ASSERT(idx.find(1) == nullptr);
+    ASSERT_EQ(idx.size(), 1ULL);
+}
+
+static void test_index_insert_replaces() {
+    OrderIndex idx;
+    Order a = makeOrder(7), b = makeOrder(7);
+    idx.insert(7, &a);
+    idx.insert(7, &b);
+    ASSERT_EQ(idx.size(), 1ULL);
+    ASSERT(idx.find(7) == &b);
+}
+
+// ---------------------------------------------------------------------------
+// Ids past the direct range use the hash-map fallback
+// ---------------------------------------------------------------------------
+static void test_index_overflow_ids() {
+    OrderIndex idx;
+    Order a = makeOrder(0);
+    uint64_t far = ~0ULL - 3;
+    idx.insert(far, &a);
+    ASSERT(idx.find(far) == &a);
+    ASSERT_EQ(idx.size(), 1ULL);
+    ASSERT_EQ(idx.pageCount(), 0ULL);
+    ASSERT(idx.erase(far));
+    ASSERT(idx.empty());
+}
+
+// ---------------------------------------------------------------------------
+// Empty pages are recycled rather than reallocated
+// ---------------------------------------------------------------------------
+static void test_index_recycles_pages() {
+    OrderIndex idx;
+    std::vector<Order> orders;
+    orders.reserve(OrderIndex::PAGE_SIZE * 4);
+    for (uint64_t id = 0; id < OrderIndex::PAGE_SIZE * 4; ++id)
+        orders.push_back(makeOrder(id));
+
+    // Rolling window of one page of live ids sliding over four pages
+    for (uint64_t id = 0; id < orders.size(); ++id) {
+        idx.insert(id, &orders[id]);
+        if (id >= OrderIndex::PAGE_SIZE) idx.erase(id - OrderIndex::PAGE_SIZE);
+    }
+    ASSERT_EQ(idx.size(), OrderIndex::PAGE_SIZE);
+    ASSERT(idx.pageCount() <= 2ULL);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_order_index_tests() {
+    RUN_TEST(test_index_insert_find_erase);
+    RUN_TEST(test_index_insert_replaces);
+    RUN_TEST(test_index_overflow_ids);
+    RUN_TEST(test_index_recycles_pages);
+}
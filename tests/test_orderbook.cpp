@@ -1,27 +1,30 @@
 #include "framework.h"
 #include "orderbook.h"
 
-// Helper: create a limit OrderPtr directly (used for low-level book tests)
-static OrderPtr makeLimitOrder(uint64_t id, Side side, int64_t price, uint64_t qty) {
-    return std::make_shared<Order>(id, static_cast<int64_t>(id), side,
-                                   OrderKind::LIMIT, price, qty);
+#include <stdexcept>
+
+// Helpers: construct orders in the book's own pool (used for low-level book tests)
+static Order* makeLimitOrder(OrderBook& book, uint64_t id, Side side,
+                             int64_t price, uint64_t qty) {
+    return book.newOrder(id, static_cast<int64_t>(id), side,
+                         OrderKind::LIMIT, price, qty);
 }
 
-static OrderPtr makeMarketOrder(uint64_t id, Side side, uint64_t qty) {
-    return std::make_shared<Order>(id, static_cast<int64_t>(id), side,
-                                   OrderKind::MARKET, 0LL, qty);
+static Order* makeMarketOrder(OrderBook& book, uint64_t id, Side side, uint64_t qty) {
+    return book.newOrder(id, static_cast<int64_t>(id), side,
+                         OrderKind::MARKET, 0LL, qty);
 }
 
-static OrderPtr makeIceberg(uint64_t id, Side side, int64_t price,
-                             uint64_t total, uint64_t display) {
-    return std::make_shared<Order>(id, static_cast<int64_t>(id), side,
-                                   price, total, display);
+static Order* makeIceberg(OrderBook& book, uint64_t id, Side side, int64_t price,
+                          uint64_t total, uint64_t display) {
+    return book.newOrder(id, static_cast<int64_t>(id), side,
+                         price, total, display);
 }
 
-static OrderPtr makeStopLoss(uint64_t id, Side side,
-                              int64_t trigger, int64_t limit, uint64_t qty) {
-    return std::make_shared<Order>(id, static_cast<int64_t>(id), side,
-                                   trigger, limit, qty);
+static Order* makeStopLoss(OrderBook& book, uint64_t id, Side side,
+                           int64_t trigger, int64_t limit, uint64_t qty) {
+    return book.newOrder(id, static_cast<int64_t>(id), side,
+                         trigger, limit, qty);
 }
 
 // ---------------------------------------------------------------------------
@@ -29,7 +32,7 @@ static OrderPtr makeStopLoss(uint64_t id, Side side,
 // ---------------------------------------------------------------------------
 static void test_resting_bid_no_cross() {
     OrderBook book;
-    auto o = makeLimitOrder(1, Side::BUY, 1000000LL, 100);
+    auto o = makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100);
     auto trades = book.match(o);
     ASSERT(trades.empty());
     ASSERT_EQ(book.bestBid(), 1000000LL);
@@ -39,7 +42,7 @@ static void test_resting_bid_no_cross() {
 
 static void test_resting_ask_no_cross() {
     OrderBook book;
-    auto o = makeLimitOrder(1, Side::SELL, 1010000LL, 50);
+    auto o = makeLimitOrder(book, 1, Side::SELL, 1010000LL, 50);
     auto trades = book.match(o);
     ASSERT(trades.empty());
     ASSERT_EQ(book.bestAsk(), 1010000LL);
@@ -51,8 +54,8 @@ static void test_resting_ask_no_cross() {
 // ---------------------------------------------------------------------------
 static void test_simple_cross_full_fill() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 100));
-    auto trades = book.match(makeLimitOrder(2, Side::SELL, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    auto trades = book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 100));
 
     ASSERT_EQ(trades.size(), 1ULL);
     ASSERT_EQ(trades[0].quantity, 100ULL);
@@ -64,8 +67,8 @@ static void test_simple_cross_full_fill() {
 
 static void test_partial_fill_leaves_resting() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 100));
-    auto trades = book.match(makeLimitOrder(2, Side::SELL, 1000000LL, 60));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    auto trades = book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 60));
 
     ASSERT_EQ(trades.size(), 1ULL);
     ASSERT_EQ(trades[0].quantity, 60ULL);
@@ -74,11 +77,11 @@ static void test_partial_fill_leaves_resting() {
 
 static void test_fifo_priority_two_bids_same_price() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 50));   // earlier
-    book.match(makeLimitOrder(2, Side::BUY, 1000000LL, 50));   // later
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 50));   // earlier
+    book.match(makeLimitOrder(book, 2, Side::BUY, 1000000LL, 50));   // later
 
     // Sell 50 — should match with order 1 first (FIFO)
-    auto trades = book.match(makeLimitOrder(3, Side::SELL, 1000000LL, 50));
+    auto trades = book.match(makeLimitOrder(book, 3, Side::SELL, 1000000LL, 50));
     ASSERT_EQ(trades.size(), 1ULL);
     ASSERT_EQ(trades[0].buy_order_id, 1ULL);   // first bid was matched
     ASSERT_EQ(book.activeOrders(), 1ULL);       // order 2 remains
@@ -86,10 +89,10 @@ static void test_fifo_priority_two_bids_same_price() {
 
 static void test_market_buy_takes_best_ask() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::SELL, 1010000LL, 100));
-    book.match(makeLimitOrder(2, Side::SELL, 1020000LL, 100));
+    book.match(makeLimitOrder(book, 1, Side::SELL, 1010000LL, 100));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1020000LL, 100));
 
-    auto trades = book.match(makeMarketOrder(3, Side::BUY, 80));
+    auto trades = book.match(makeMarketOrder(book, 3, Side::BUY, 80));
     ASSERT_EQ(trades.size(), 1ULL);
     ASSERT_EQ(trades[0].price, 1010000LL);  // best ask first
     ASSERT_EQ(trades[0].quantity, 80ULL);
@@ -97,10 +100,10 @@ static void test_market_buy_takes_best_ask() {
 
 static void test_market_buy_sweeps_multiple_levels() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::SELL, 1010000LL, 40));
-    book.match(makeLimitOrder(2, Side::SELL, 1020000LL, 40));
+    book.match(makeLimitOrder(book, 1, Side::SELL, 1010000LL, 40));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1020000LL, 40));
 
-    auto trades = book.match(makeMarketOrder(3, Side::BUY, 80));
+    auto trades = book.match(makeMarketOrder(book, 3, Side::BUY, 80));
     ASSERT_EQ(trades.size(), 2ULL);
     ASSERT_EQ(book.activeOrders(), 0ULL);
 }
@@ -110,7 +113,7 @@ static void test_market_buy_sweeps_multiple_levels() {
 // ---------------------------------------------------------------------------
 static void test_cancel_existing_order() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
     bool ok = book.cancelOrder(1);
     ASSERT(ok);
     ASSERT_EQ(book.activeOrders(), 0ULL);
@@ -128,7 +131,7 @@ static void test_cancel_nonexistent_order() {
 // ---------------------------------------------------------------------------
 static void test_modify_changes_price() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
     bool ok = book.modifyOrder(1, 990000LL, 100, 2);
     ASSERT(ok);
     ASSERT_EQ(book.bestBid(), 990000LL);
@@ -140,17 +143,77 @@ static void test_modify_nonexistent_order() {
     ASSERT_FALSE(ok);
 }
 
+static void test_modify_qty_down_keeps_priority() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 2, Side::BUY, 1000000LL, 100));
+    size_t free_before = book.pool().freeCount();
+
+    ASSERT(book.modifyOrder(1, 1000000LL, 40, 5));
+    ASSERT_EQ(book.pool().freeCount(), free_before);
+
+    DepthLevel row{};
+    ASSERT_EQ(book.getDepth(Side::BUY, 1, &row), 1ULL);
+    ASSERT_EQ(row.visible_qty, 140ULL);
+
+    // #1 is still first in the queue
+    auto trades = book.match(makeLimitOrder(book, 3, Side::SELL, 1000000LL, 50));
+    ASSERT_EQ(trades.size(), 2ULL);
+    ASSERT_EQ(trades[0].buy_order_id, 1ULL);
+    ASSERT_EQ(trades[0].quantity, 40ULL);
+    ASSERT_EQ(trades[1].buy_order_id, 2ULL);
+}
+
+static void test_modify_reprice_moves_same_order() {
+    OrderBook book;
+    book.match(makeIceberg(book, 1, Side::SELL, 1010000LL, 500, 100));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 10));
+    size_t free_before = book.pool().freeCount();
+
+    // Size up at the same price loses priority behind #2
+    ASSERT(book.modifyOrder(1, 1000000LL, 300, 7));
+    ASSERT_EQ(book.pool().freeCount(), free_before);
+    ASSERT_EQ(book.askLevels(), 1ULL);
+
+    auto snap = book.findOrder(1);
+    ASSERT(snap.has_value());
+    ASSERT(snap->isIceberg());
+    ASSERT_EQ(snap->visibleQty(), 100ULL);
+    ASSERT_EQ(snap->leaves(), 300ULL);
+
+    auto trades = book.match(makeLimitOrder(book, 3, Side::BUY, 1000000LL, 20));
+    ASSERT_EQ(trades.size(), 2ULL);
+    ASSERT_EQ(trades[0].sell_order_id, 2ULL);
+    ASSERT_EQ(trades[1].sell_order_id, 1ULL);
+}
+
+static void test_modify_pending_stop() {
+    OrderBook book;
+    book.match(makeStopLoss(book, 1, Side::SELL, 995000LL, 994000LL, 100));
+    ASSERT(book.modifyOrder(1, 993000LL, 60, 2));
+
+    auto snap = book.findOrder(1);
+    ASSERT(snap.has_value());
+    ASSERT(snap->isStopLoss());
+    ASSERT_EQ(snap->triggerPrice(), 995000LL);
+    ASSERT_EQ(snap->price(), 993000LL);
+    ASSERT_EQ(snap->leaves(), 60ULL);
+
+    ASSERT(book.modifyOrder(1, 993000LL, 0, 3));   // zero quantity cancels
+    ASSERT_EQ(book.pendingStops(), 0ULL);
+}
+
 // ---------------------------------------------------------------------------
 // Iceberg matching
 // ---------------------------------------------------------------------------
 static void test_iceberg_shows_only_visible_qty() {
     OrderBook book;
     // Iceberg: total 500, display 100
-    auto ice = makeIceberg(1, Side::BUY, 1000000LL, 500, 100);
+    auto ice = makeIceberg(book, 1, Side::BUY, 1000000LL, 500, 100);
     book.match(ice);
 
     // Sell 100 — matches the visible lot, triggers replenishment
-    auto trades = book.match(makeLimitOrder(2, Side::SELL, 1000000LL, 100));
+    auto trades = book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 100));
     ASSERT_EQ(trades.size(), 1ULL);
     ASSERT_EQ(trades[0].quantity, 100ULL);
     // Iceberg should still be alive (400 remain)
@@ -159,15 +222,27 @@ static void test_iceberg_shows_only_visible_qty() {
 
 static void test_iceberg_fully_consumed() {
     OrderBook book;
-    auto ice = makeIceberg(1, Side::BUY, 1000000LL, 200, 100);
+    auto ice = makeIceberg(book, 1, Side::BUY, 1000000LL, 200, 100);
     book.match(ice);
 
-    auto trades = book.match(makeLimitOrder(2, Side::SELL, 1000000LL, 200));
+    auto trades = book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 200));
     // 200 total: two lots of 100 each
     ASSERT_EQ(book.activeOrders(), 0ULL);
     ASSERT_EQ(book.tradeHistory().size(), 2ULL);
 }
 
+static void test_iceberg_aggressor_rests_with_fresh_lot() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::SELL, 1000000LL, 150));
+    book.match(makeIceberg(book, 2, Side::BUY, 1000000LL, 500, 100));
+
+    auto ice = book.findOrder(2);
+    ASSERT(ice.has_value());
+    ASSERT_EQ(ice->leaves(), 350ULL);
+    ASSERT_EQ(ice->visibleQty(), 100ULL);
+    ASSERT_EQ(ice->hiddenQty(), 250ULL);
+}
+
 // ---------------------------------------------------------------------------
 // Stop-loss triggering
 // ---------------------------------------------------------------------------
@@ -175,16 +250,16 @@ static void test_stop_loss_triggers_on_price() {
     OrderBook book;
 
     // Resting bid at $99.50
-    book.match(makeLimitOrder(1, Side::BUY, 995000LL, 200));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 995000LL, 200));
 
     // Stop-loss sell: trigger ≤ $99.50, limit = $99.40
-    auto stop = makeStopLoss(2, Side::SELL, 995000LL, 994000LL, 100);
+    auto stop = makeStopLoss(book, 2, Side::SELL, 995000LL, 994000LL, 100);
     auto t0 = book.match(stop);
     ASSERT(t0.empty());                        // not yet triggered
     ASSERT_EQ(book.activeOrders(), 1ULL);      // only the bid is active
 
     // Limit sell @ $99.50 — executes at $99.50, triggers the stop
-    auto t1 = book.match(makeLimitOrder(3, Side::SELL, 995000LL, 50));
+    auto t1 = book.match(makeLimitOrder(book, 3, Side::SELL, 995000LL, 50));
     // t1 includes the direct trade + trades from the triggered stop
     ASSERT_FALSE(t1.empty());
 }
@@ -193,30 +268,253 @@ static void test_stop_loss_not_triggered_above_price() {
     OrderBook book;
 
     // Resting bid at $100.00
-    book.match(makeLimitOrder(1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
 
     // Stop-loss sell triggers at ≤ $99.00 (far below market)
-    auto stop = makeStopLoss(2, Side::SELL, 990000LL, 989000LL, 50);
+    auto stop = makeStopLoss(book, 2, Side::SELL, 990000LL, 989000LL, 50);
     book.match(stop);
 
     // Trade happens at $100.00 — above trigger price, stop stays pending
-    auto trades = book.match(makeLimitOrder(3, Side::SELL, 1000000LL, 100));
+    auto trades = book.match(makeLimitOrder(book, 3, Side::SELL, 1000000LL, 100));
     ASSERT_EQ(trades.size(), 1ULL);             // only the direct trade
     ASSERT_EQ(trades[0].price, 1000000LL);
 }
 
+// ---------------------------------------------------------------------------
+// Cached level aggregates and depth snapshots
+// ---------------------------------------------------------------------------
+static void test_depth_tracks_level_totals() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    book.match(makeIceberg(book, 2, Side::BUY, 1000000LL, 500, 100));
+    book.match(makeLimitOrder(book, 3, Side::BUY, 990000LL, 40));
+
+    DepthLevel rows[4];
+    ASSERT_EQ(book.getDepth(Side::BUY, 4, rows), 2ULL);
+    ASSERT_EQ(rows[0].price,       1000000LL);
+    ASSERT_EQ(rows[0].visible_qty, 200ULL);
+    ASSERT_EQ(rows[0].hidden_qty,  400ULL);
+    ASSERT_EQ(rows[0].order_count, 2ULL);
+    ASSERT_EQ(rows[1].visible_qty, 40ULL);
+
+    // Fills the limit and half of the iceberg's display lot
+    book.match(makeLimitOrder(book, 4, Side::SELL, 1000000LL, 150));
+    ASSERT_EQ(book.getDepth(Side::BUY, 4, rows), 2ULL);
+    ASSERT_EQ(rows[0].visible_qty, 50ULL);
+    ASSERT_EQ(rows[0].hidden_qty,  400ULL);
+    ASSERT_EQ(rows[0].order_count, 1ULL);
+
+    // Exhausts the display lot: replenishment moves reserve into view
+    book.match(makeLimitOrder(book, 5, Side::SELL, 1000000LL, 50));
+    ASSERT_EQ(book.getDepth(Side::BUY, 4, rows), 2ULL);
+    ASSERT_EQ(rows[0].visible_qty, 100ULL);
+    ASSERT_EQ(rows[0].hidden_qty,  300ULL);
+
+    ASSERT(book.cancelOrder(2));
+    ASSERT_EQ(book.getDepth(Side::BUY, 4, rows), 1ULL);
+    ASSERT_EQ(rows[0].price, 990000LL);
+}
+
+static void test_depth_respects_buffer_size() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::SELL, 1030000LL, 10));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1010000LL, 20));
+    book.match(makeLimitOrder(book, 3, Side::SELL, 1020000LL, 30));
+
+    DepthLevel rows[2];
+    ASSERT_EQ(book.getDepth(Side::SELL, 2, rows), 2ULL);
+    ASSERT_EQ(rows[0].price, 1010000LL);   // best ask first
+    ASSERT_EQ(rows[1].price, 1020000LL);
+    ASSERT_EQ(book.getDepth(Side::BUY, 2, rows), 0ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Ownership: the book returns orders to its pool and exposes safe snapshots
+// ---------------------------------------------------------------------------
+static void test_find_order_returns_snapshot() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1000000LL, 30));
+
+    auto snap = book.findOrder(1);
+    ASSERT(snap.has_value());
+    ASSERT_EQ(snap->leaves(), 70ULL);
+    ASSERT(snap->status() == OrderStatus::PARTIAL);
+    ASSERT_FALSE(book.findOrder(2).has_value());   // filled aggressor never rests
+}
+
+static void test_orders_returned_to_pool() {
+    OrderBook book(LadderConfig{}, PoolConfig{16});
+    book.match(makeLimitOrder(book, 1, Side::BUY, 1000000LL, 100));
+    book.match(makeLimitOrder(book, 2, Side::BUY, 990000LL, 100));
+    book.match(makeMarketOrder(book, 3, Side::SELL, 100));   // fills order 1
+    ASSERT(book.cancelOrder(2));
+
+    ASSERT_EQ(book.pool().freeCount(), book.pool().totalCapacity());
+}
+
+// Orders still in the book when it dies give their extensions back.
+static void test_destroyed_book_releases_extensions() {
+    size_t baseline = Order::extensionsInUse();
+    {
+        OrderBook book;
+        for (uint64_t id = 1; id <= 50; ++id)
+            book.match(makeIceberg(book, id, id % 2 ? Side::BUY : Side::SELL,
+                                   id % 2 ? 990000LL : 1010000LL, 100, 10));
+        for (uint64_t id = 51; id <= 80; ++id)
+            book.match(makeStopLoss(book, id, id % 2 ? Side::BUY : Side::SELL,
+                                    id % 2 ? 1050000LL : 950000LL, 1000000LL, 10));
+        book.match(makeLimitOrder(book, 81, Side::BUY, 980000LL, 10));
+        ASSERT_EQ(book.pendingStops(), 30ULL);
+        ASSERT_EQ(Order::extensionsInUse(), baseline + 80);
+    }
+    ASSERT_EQ(Order::extensionsInUse(), baseline);
+}
+
+static void test_stops_release_in_trigger_then_time_order() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::BUY, 990000LL, 1000));
+
+    // Sell stops: two at $99.50 (10 before 12), one at $99.70 in between
+    book.match(makeStopLoss(book, 10, Side::SELL, 995000LL, 990000LL, 10));
+    book.match(makeStopLoss(book, 11, Side::SELL, 997000LL, 990000LL, 10));
+    book.match(makeStopLoss(book, 12, Side::SELL, 995000LL, 990000LL, 10));
+    // Sell stop far below the trade — must stay pending
+    book.match(makeStopLoss(book, 13, Side::SELL, 980000LL, 979000LL, 10));
+    ASSERT_EQ(book.pendingStops(), 4ULL);
+
+    auto trades = book.match(makeLimitOrder(book, 20, Side::SELL, 990000LL, 10));
+    ASSERT_EQ(trades.size(), 4ULL);
+    ASSERT_EQ(trades[0].sell_order_id, 20ULL);
+    ASSERT_EQ(trades[1].sell_order_id, 11ULL);   // highest trigger first
+    ASSERT_EQ(trades[2].sell_order_id, 10ULL);   // then FIFO at $99.50
+    ASSERT_EQ(trades[3].sell_order_id, 12ULL);
+    ASSERT_EQ(book.pendingStops(), 1ULL);
+}
+
+static void test_cancel_pending_stop() {
+    OrderBook book;
+    book.match(makeLimitOrder(book, 1, Side::BUY, 995000LL, 200));
+    book.match(makeStopLoss(book, 2, Side::SELL, 995000LL, 994000LL, 100));
+    ASSERT(book.findOrder(2).has_value());
+
+    ASSERT(book.cancelOrder(2));
+    ASSERT_EQ(book.pendingStops(), 0ULL);
+    ASSERT_FALSE(book.cancelOrder(2));
+
+    // A trade through the old trigger no longer fires anything
+    auto trades = book.match(makeLimitOrder(book, 3, Side::SELL, 995000LL, 50));
+    ASSERT_EQ(trades.size(), 1ULL);
+}
+
+// ---------------------------------------------------------------------------
+// Trade sinks
+// ---------------------------------------------------------------------------
+namespace {
+struct RecordingSink {
+    std::vector<Trade>       trades;
+    std::vector<OrderUpdate> updates;
+
+    void onTrade(const Trade& t)             { trades.push_back(t); }
+    void onOrderUpdate(const OrderUpdate& u) { updates.push_back(u); }
+};
+}
+
+static void test_sink_receives_trades_and_updates() {
+    OrderBook     book;
+    RecordingSink sink;
+    book.match(makeLimitOrder(book, 1, Side::SELL, 1000000LL, 30), sink);
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1010000LL, 30), sink);
+    ASSERT_EQ(sink.updates.size(), 2ULL);
+    ASSERT(sink.updates[0].status == OrderStatus::ACTIVE);
+    sink.updates.clear();
+
+    // Market buy of 80: fills #1, fills #2, the unfilled 20 is cancelled
+    book.match(makeMarketOrder(book, 3, Side::BUY, 80), sink);
+    ASSERT_EQ(sink.trades.size(), 2ULL);
+    ASSERT_EQ(sink.trades[1].sell_order_id, 2ULL);
+    ASSERT_EQ(sink.updates.size(), 3ULL);
+    ASSERT_EQ(sink.updates[0].order_id, 1ULL);
+    ASSERT(sink.updates[0].status == OrderStatus::FILLED);
+    ASSERT_EQ(sink.updates[1].order_id, 2ULL);
+    ASSERT_EQ(sink.updates[2].order_id, 3ULL);
+    ASSERT(sink.updates[2].status == OrderStatus::CANCELLED);
+    ASSERT_EQ(sink.updates[2].leaves, 0ULL);
+
+    // The book's own history sees the same trades
+    ASSERT_EQ(book.tradeHistory().size(), 2ULL);
+}
+
 // ---------------------------------------------------------------------------
 // Spread and levels
 // ---------------------------------------------------------------------------
 static void test_spread_calculation() {
     OrderBook book;
-    book.match(makeLimitOrder(1, Side::BUY, 990000LL, 10));
-    book.match(makeLimitOrder(2, Side::SELL, 1010000LL, 10));
+    book.match(makeLimitOrder(book, 1, Side::BUY, 990000LL, 10));
+    book.match(makeLimitOrder(book, 2, Side::SELL, 1010000LL, 10));
     ASSERT_EQ(book.spread(), 20000LL);
     ASSERT_EQ(book.bidLevels(), 1ULL);
     ASSERT_EQ(book.askLevels(), 1ULL);
 }
 
+// ---------------------------------------------------------------------------
+// Published top of book
+// ---------------------------------------------------------------------------
+static void test_top_published_after_mutations() {
+    OrderBook book;
+    BookTop t = book.top();
+    ASSERT_EQ(t.bid_price, 0LL);
+    ASSERT_EQ(t.ask_price, 0LL);
+    ASSERT_EQ(t.sequence, 0ULL);
+
+    book.match(makeLimitOrder(book, 1, Side::BUY,  990000LL, 100));
+    book.match(makeLimitOrder(book, 2, Side::BUY,  990000LL,  50));
+    book.match(makeLimitOrder(book, 3, Side::BUY,  980000LL,  10));
+    book.match(makeLimitOrder(book, 4, Side::SELL, 1010000LL, 70));
+    t = book.top();
+    ASSERT_EQ(t.bid_price, 990000LL);
+    ASSERT_EQ(t.bid_qty, 150ULL);
+    ASSERT_EQ(t.bid_orders, 2U);
+    ASSERT_EQ(t.bid_levels, 2U);
+    ASSERT_EQ(t.ask_price, 1010000LL);
+    ASSERT_EQ(t.ask_qty, 70ULL);
+    ASSERT_EQ(t.ask_orders, 1U);
+    ASSERT_EQ(t.sequence, 4ULL);
+
+    // A new level behind the touch only changes the level count; another
+    // order on that level changes nothing and is not republished.
+    book.match(makeLimitOrder(book, 5, Side::SELL, 1020000LL, 5));
+    ASSERT_EQ(book.top().sequence, 5ULL);
+    book.match(makeLimitOrder(book, 6, Side::SELL, 1020000LL, 5));
+    ASSERT_EQ(book.top().sequence, 5ULL);
+    ASSERT_FALSE(book.cancelOrder(99));
+    ASSERT_EQ(book.top().sequence, 5ULL);
+
+    ASSERT(book.modifyOrder(1, 990000LL, 40, 6));
+    ASSERT_EQ(book.top().bid_qty, 90ULL);
+    ASSERT(book.cancelOrder(4));
+    t = book.top();
+    ASSERT_EQ(t.ask_price, 1020000LL);
+    ASSERT_EQ(t.ask_qty, 10ULL);
+    ASSERT_EQ(t.ask_orders, 2U);
+    ASSERT_EQ(t.ask_levels, 1U);
+    ASSERT_EQ(book.spread(), 30000LL);
+    ASSERT_EQ(t.sequence, 7ULL);
+
+    // A batch that throws part-way still publishes what it did.
+    bool threw = false;
+    try {
+        book.batch([&](OrderBook::Batch& b) {
+            NullSink sink;
+            b.match(makeLimitOrder(book, 7, Side::BUY, 1000000LL, 25), sink);
+            throw std::runtime_error("journal failure");
+        });
+    } catch (const std::runtime_error&) { threw = true; }
+    ASSERT(threw);
+    ASSERT_EQ(book.top().bid_price, 1000000LL);
+    ASSERT_EQ(book.top().sequence, 8ULL);
+}
+
 // ─── runner ───────────────────────────────────────────────────────────────────
 
 void run_orderbook_tests() {
@@ -231,9 +529,22 @@ void run_orderbook_tests() {
     RUN_TEST(test_cancel_nonexistent_order);
     RUN_TEST(test_modify_changes_price);
     RUN_TEST(test_modify_nonexistent_order);
+    RUN_TEST(test_modify_qty_down_keeps_priority);
+    RUN_TEST(test_modify_reprice_moves_same_order);
+    RUN_TEST(test_modify_pending_stop);
     RUN_TEST(test_iceberg_shows_only_visible_qty);
     RUN_TEST(test_iceberg_fully_consumed);
+    RUN_TEST(test_iceberg_aggressor_rests_with_fresh_lot);
     RUN_TEST(test_stop_loss_triggers_on_price);
     RUN_TEST(test_stop_loss_not_triggered_above_price);
+    RUN_TEST(test_stops_release_in_trigger_then_time_order);
+    RUN_TEST(test_cancel_pending_stop);
+    RUN_TEST(test_depth_tracks_level_totals);
+    RUN_TEST(test_depth_respects_buffer_size);
+    RUN_TEST(test_find_order_returns_snapshot);
+    RUN_TEST(test_orders_returned_to_pool);
+    RUN_TEST(test_destroyed_book_releases_extensions);
+    RUN_TEST(test_sink_receives_trades_and_updates);
     RUN_TEST(test_spread_calculation);
+    RUN_TEST(test_top_published_after_mutations);
 }
@@ -0,0 +1,144 @@
+#include "framework.h"
+#include "orderbook.h"
+#include "price_ladder.h"
+
+struct TestLevel {
+    int64_t price{0};
+};
+
+// $99.00 .. $101.00 in $0.01 ticks
+static const LadderConfig kBand{990000LL, 100LL, 200};
+
+// ---------------------------------------------------------------------------
+// OccupancyBitmap
+// ---------------------------------------------------------------------------
+static void test_bitmap_empty_finds_nothing() {
+    OccupancyBitmap bm(5000);
+    ASSERT_EQ(bm.findNext(0), OccupancyBitmap::npos);
+    ASSERT_EQ(bm.findPrev(4999), OccupancyBitmap::npos);
+}
+
+static void test_bitmap_next_prev_across_words() {
+    // 300 000 bits spans four bitmap levels
+    OccupancyBitmap bm(300000);
+    bm.set(3);
+    bm.set(70000);
+    bm.set(299999);
+
+    ASSERT_EQ(bm.findNext(0),      3ULL);
+    ASSERT_EQ(bm.findNext(4),      70000ULL);
+    ASSERT_EQ(bm.findNext(70001),  299999ULL);
+    ASSERT_EQ(bm.findPrev(299998), 70000ULL);
+    ASSERT_EQ(bm.findPrev(69999),  3ULL);
+    ASSERT_EQ(bm.findPrev(2),      OccupancyBitmap::npos);
+
+    bm.clear(70000);
+    ASSERT_EQ(bm.findNext(4),      299999ULL);
+    ASSERT_EQ(bm.findPrev(299998), 3ULL);
+}
+
+// ---------------------------------------------------------------------------
+// PriceLadder
+// ---------------------------------------------------------------------------
+static void test_ladder_dense_navigation() {
+    PriceLadder<TestLevel> ladder(kBand);
+    ladder.acquire(1000000LL);
+    ladder.acquire(995000LL);
+    ladder.acquire(1005000LL);
+
+    ASSERT_EQ(ladder.size(), 3ULL);
+    ASSERT_EQ(ladder.lowest()->price,  995000LL);
+    ASSERT_EQ(ladder.highest()->price, 1005000LL);
+    ASSERT_EQ(ladder.above(995000LL)->price,  1000000LL);
+    ASSERT_EQ(ladder.below(1005000LL)->price, 1000000LL);
+    ASSERT(ladder.above(1005000LL) == nullptr);
+
+    ladder.release(1000000LL);
+    ASSERT(ladder.find(1000000LL) == nullptr);
+    ASSERT_EQ(ladder.above(995000LL)->price, 1005000LL);
+}
+
+static void test_ladder_sparse_fallback_merges_in_order() {
+    PriceLadder<TestLevel> ladder(kBand);
+    ladder.acquire(980000LL);    // below band
+    ladder.acquire(1000050LL);   // in band, off tick
+    ladder.acquire(1000000LL);   // dense
+    ladder.acquire(1020000LL);   // above band
+
+    const int64_t expected[] = {980000LL, 1000000LL, 1000050LL, 1020000LL};
+    size_t i = 0;
+    for (auto* l = ladder.lowest(); l; l = ladder.above(l->price))
+        ASSERT_EQ(l->price, expected[i++]);
+    ASSERT_EQ(i, 4ULL);
+
+    for (auto* l = ladder.highest(); l; l = ladder.below(l->price))
+        ASSERT_EQ(l->price, expected[--i]);
+    ASSERT_EQ(i, 0ULL);
+}
+
+// ---------------------------------------------------------------------------
+// OrderBook on a dense ladder
+// ---------------------------------------------------------------------------
+static Order* limit(OrderBook& book, uint64_t id, Side side, int64_t price, uint64_t qty) {
+    return book.newOrder(id, static_cast<int64_t>(id), side,
+                         OrderKind::LIMIT, price, qty);
+}
+
+static void test_ladder_recycles_emptied_sparse_levels() {
+    PriceLadder<TestLevel> ladder;
+    TestLevel* first = &ladder.acquire(1000000LL);
+    ladder.release(1000000LL);
+    ASSERT(ladder.empty());
+
+    // The emptied node comes back under a new price, correctly ordered.
+    TestLevel* reused = &ladder.acquire(990000LL);
+    ladder.acquire(1010000LL);
+    ASSERT(reused == first);
+    ASSERT_EQ(reused->price, 990000LL);
+    ASSERT_EQ(ladder.lowest()->price,  990000LL);
+    ASSERT_EQ(ladder.highest()->price, 1010000LL);
+
+    // More releases than spare slots: the overflow is erased, not leaked.
+    for (int64_t i = 0; i < 20; ++i) ladder.acquire(2000000LL + i);
+    for (int64_t i = 0; i < 20; ++i) ladder.release(2000000LL + i);
+    ASSERT_EQ(ladder.size(), 2ULL);
+    for (int64_t i = 0; i < 20; ++i) ASSERT_EQ(ladder.acquire(3000000LL + i).price, 3000000LL + i);
+    ASSERT_EQ(ladder.size(), 22ULL);
+    ASSERT_EQ(ladder.below(3000000LL)->price, 1010000LL);
+}
+
+static void test_book_sweeps_from_band_into_sparse() {
+    OrderBook book(kBand);
+    book.match(limit(book, 1, Side::SELL, 1000000LL, 10));   // dense
+    book.match(limit(book, 2, Side::SELL, 1015000LL, 10));   // above band
+    ASSERT_EQ(book.bestAsk(), 1000000LL);
+    ASSERT_EQ(book.askLevels(), 2ULL);
+
+    auto trades = book.match(limit(book, 3, Side::BUY, 1015000LL, 20));
+    ASSERT_EQ(trades.size(), 2ULL);
+    ASSERT_EQ(trades[0].price, 1000000LL);
+    ASSERT_EQ(trades[1].price, 1015000LL);
+    ASSERT_EQ(book.askLevels(), 0ULL);
+    ASSERT_EQ(book.bestAsk(), 0LL);
+}
+
+static void test_book_cancel_releases_dense_level() {
+    OrderBook book(kBand);
+    book.match(limit(book, 1, Side::BUY, 999000LL, 10));
+    book.match(limit(book, 2, Side::BUY, 998000LL, 10));
+    ASSERT(book.cancelOrder(1));
+    ASSERT_EQ(book.bestBid(), 998000LL);
+    ASSERT_EQ(book.bidLevels(), 1ULL);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_price_ladder_tests() {
+    RUN_TEST(test_bitmap_empty_finds_nothing);
+    RUN_TEST(test_bitmap_next_prev_across_words);
+    RUN_TEST(test_ladder_dense_navigation);
+    RUN_TEST(test_ladder_sparse_fallback_merges_in_order);
+    RUN_TEST(test_ladder_recycles_emptied_sparse_levels);
+    RUN_TEST(test_book_sweeps_from_band_into_sparse);
+    RUN_TEST(test_book_cancel_releases_dense_level);
+}
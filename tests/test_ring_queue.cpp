@@ -0,0 +1,190 @@
+#include "framework.h"
+#include "ring_queue.h"
+#include "wait_strategy.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Capacity rounding, FIFO order across wrap-around
+// ---------------------------------------------------------------------------
+static void test_spsc_fifo_wraps() {
+    SpscRing<int> q(5);
+    ASSERT_EQ(q.capacity(), size_t{8});
+
+    int next_in = 0, next_out = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 5; ++i) ASSERT(q.tryEnqueue(next_in++));
+        for (int i = 0; i < 5; ++i) {
+            int v = -1;
+            ASSERT(q.dequeue(v));
+            ASSERT_EQ(v, next_out++);
+        }
+    }
+    int v;
+    ASSERT_FALSE(q.dequeue(v));
+}
+
+// ---------------------------------------------------------------------------
+// tryEnqueue refuses when full and succeeds again once the consumer frees a
+// slot; bulk operations take what fits
+// ---------------------------------------------------------------------------
+template <typename Ring>
+static void checkBackpressureAndBulk() {
+    Ring q(4);
+    ASSERT(q.tryEnqueue(1));
+    ASSERT(q.tryEnqueue(2));
+
+    int items[] = {3, 4, 5, 6};
+    ASSERT_EQ(q.tryEnqueueBulk(items, 4), size_t{2});   // only 3 and 4 fit
+    ASSERT_FALSE(q.tryEnqueue(5));
+
+    int out[8] = {};
+    ASSERT_EQ(q.dequeueBulk(out, 3), size_t{3});
+    ASSERT_EQ(out[0], 1);
+    ASSERT_EQ(out[2], 3);
+
+    ASSERT_EQ(q.tryEnqueueBulk(items + 2, 2), size_t{2});
+    ASSERT_EQ(q.dequeueBulk(out, 8), size_t{3});
+    ASSERT_EQ(out[0], 4);
+    ASSERT_EQ(out[1], 5);
+    ASSERT_EQ(out[2], 6);
+    ASSERT_EQ(q.dequeueBulk(out, 8), size_t{0});
+}
+
+static void test_spsc_backpressure_and_bulk() { checkBackpressureAndBulk<SpscRing<int>>(); }
+static void test_mpsc_backpressure_and_bulk() { checkBackpressureAndBulk<MpscRing<int>>(); }
+
+// ---------------------------------------------------------------------------
+// SPSC across threads through a small ring: every item, in order
+// ---------------------------------------------------------------------------
+static void test_spsc_threads_in_order() {
+    constexpr int N = 100000;
+    SpscRing<int> q(64);
+
+    std::thread producer([&q] {
+        int batch[16];
+        for (int i = 0; i < N;) {
+            int n = std::min(16, N - i);
+            for (int k = 0; k < n; ++k) batch[k] = i + k;
+            size_t sent = 0;
+            while (sent < static_cast<size_t>(n)) {
+                size_t k = q.tryEnqueueBulk(batch + sent, static_cast<size_t>(n) - sent);
+                if (k == 0) std::this_thread::yield();
+                sent += k;
+            }
+            i += n;
+        }
+    });
+
+    int  expected = 0;
+    bool ordered  = true;
+    int  out[32];
+    while (expected < N) {
+        size_t n = q.dequeueBulk(out, 32);
+        for (size_t k = 0; k < n; ++k) ordered &= (out[k] == expected++);
+        if (n == 0) std::this_thread::yield();
+    }
+    producer.join();
+    ASSERT(ordered);
+}
+
+// ---------------------------------------------------------------------------
+// MPSC: every item delivered exactly once and each producer's items in the
+// order it enqueued them, through a ring much smaller than the traffic
+// ---------------------------------------------------------------------------
+static void test_mpsc_no_loss_per_producer_order() {
+    constexpr int PRODUCERS = 8;
+    constexpr int EACH      = 5000;
+    MpscRing<int> q(128);
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < EACH; ++i) {
+                if (i % 4 == 0) {
+                    int two[2] = {p * EACH + i, p * EACH + i + 1};
+                    size_t sent = 0;
+                    while (sent < 2) {
+                        size_t k = q.tryEnqueueBulk(two + sent, 2 - sent);
+                        if (k == 0) std::this_thread::yield();
+                        sent += k;
+                    }
+                    ++i;
+                } else {
+                    q.enqueue(p * EACH + i);
+                }
+            }
+        });
+    }
+
+    std::vector<int> last(PRODUCERS, -1);
+    bool ordered  = true;
+    int  received = 0;
+    int  out[64];
+    while (received < PRODUCERS * EACH) {
+        size_t n = q.dequeueBulk(out, 64);
+        for (size_t k = 0; k < n; ++k) {
+            int p = out[k] / EACH, i = out[k] % EACH;
+            ordered &= (i == last[static_cast<size_t>(p)] + 1);
+            last[static_cast<size_t>(p)] = i;
+        }
+        received += static_cast<int>(n);
+        if (n == 0) std::this_thread::yield();
+    }
+    for (auto& t : producers) t.join();
+
+    int extra;
+    ASSERT_FALSE(q.dequeue(extra));
+    ASSERT(ordered);
+    for (int p = 0; p < PRODUCERS; ++p) ASSERT_EQ(last[static_cast<size_t>(p)], EACH - 1);
+}
+
+// ---------------------------------------------------------------------------
+// SpinParkWait: a consumer parked on an empty ring is woken by the producer's
+// notify() and sees every item, however the two interleave
+// ---------------------------------------------------------------------------
+static void test_spin_park_wakes_consumer() {
+    constexpr int N = 2000;
+    MpscRing<int> q(64);
+    SpinParkWait  wait;
+
+    std::thread producer([&] {
+        for (int i = 0; i < N; ++i) {
+            q.enqueue(i);
+            wait.notify();
+            if (i % 100 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+    });
+
+    int expected = 0;
+    bool ordered = true;
+    while (expected < N) {
+        int v;
+        if (q.dequeue(v)) {
+            wait.busy();
+            ordered &= (v == expected++);
+        } else {
+            wait.idle([&q] { return !q.empty(); });
+        }
+    }
+    producer.join();
+    ASSERT(ordered);
+
+    WaitStats s = wait.stats();
+    ASSERT(s.parks > 0);
+    ASSERT(s.wakeups <= s.parks);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_ring_queue_tests() {
+    RUN_TEST(test_spsc_fifo_wraps);
+    RUN_TEST(test_spsc_backpressure_and_bulk);
+    RUN_TEST(test_mpsc_backpressure_and_bulk);
+    RUN_TEST(test_spsc_threads_in_order);
+    RUN_TEST(test_mpsc_no_loss_per_producer_order);
+    RUN_TEST(test_spin_park_wakes_consumer);
+}
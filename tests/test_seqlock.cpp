@@ -0,0 +1,70 @@
+#include "framework.h"
+#include "seqlock.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+// Every field equals a multiple of the first, so a torn read shows up.
+struct Record {
+    uint64_t a, b, c, d, e, f, g;
+};
+
+Record makeRecord(uint64_t n) { return Record{n, 2 * n, 3 * n, 4 * n, 5 * n, 6 * n, 7 * n}; }
+
+bool consistent(const Record& r) {
+    return r.b == 2 * r.a && r.c == 3 * r.a && r.d == 4 * r.a &&
+           r.e == 5 * r.a && r.f == 6 * r.a && r.g == 7 * r.a;
+}
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Single-threaded store / load
+// ---------------------------------------------------------------------------
+static void test_seqlock_store_load() {
+    SeqLock<Record> lock(makeRecord(1));
+    ASSERT_EQ(lock.load().g, 7ULL);
+    lock.store(makeRecord(5));
+    Record r{};
+    ASSERT(lock.tryLoad(r));
+    ASSERT_EQ(r.a, 5ULL);
+    ASSERT(consistent(r));
+}
+
+// ---------------------------------------------------------------------------
+// Readers racing a writer never see a torn record
+// ---------------------------------------------------------------------------
+static void test_seqlock_readers_never_torn() {
+    SeqLock<Record>   lock(makeRecord(0));
+    std::atomic<bool> done{false};
+    std::atomic<int>  torn{0};
+    std::atomic<int>  backwards{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; ++i) {
+        readers.emplace_back([&] {
+            uint64_t last = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                Record r = lock.load();
+                if (!consistent(r)) torn.fetch_add(1);
+                if (r.a < last)     backwards.fetch_add(1);
+                last = r.a;
+            }
+        });
+    }
+    for (uint64_t n = 1; n <= 200000; ++n) lock.store(makeRecord(n));
+    done.store(true);
+    for (auto& t : readers) t.join();
+
+    ASSERT_EQ(torn.load(), 0);
+    ASSERT_EQ(backwards.load(), 0);
+    ASSERT_EQ(lock.load().a, 200000ULL);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_seqlock_tests() {
+    RUN_TEST(test_seqlock_store_load);
+    RUN_TEST(test_seqlock_readers_never_torn);
+}
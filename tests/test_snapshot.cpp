@@ -0,0 +1,252 @@
+#include "framework.h"
+#include "matching_engine.h"
+#include "snapshot.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// Fresh, empty scratch directory for one test's snapshot and journal files.
+static fs::path scratchDir(const char* name) {
+    fs::path dir = fs::temp_directory_path() / (std::string("lob_snapshot_") + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+// Same depth, same orders in the same state, ids 1..max_id.
+static void assertSameBook(const MatchingEngine& a, const MatchingEngine& b, uint64_t max_id) {
+    ASSERT_EQ(b.book().activeOrders(), a.book().activeOrders());
+    ASSERT_EQ(b.book().pendingStops(), a.book().pendingStops());
+    for (Side side : {Side::BUY, Side::SELL}) {
+        DepthLevel da[64], db[64];
+        size_t     n = a.book().getDepth(side, 64, da);
+        ASSERT_EQ(b.book().getDepth(side, 64, db), n);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(db[i].price, da[i].price);
+            ASSERT_EQ(db[i].visible_qty, da[i].visible_qty);
+            ASSERT_EQ(db[i].hidden_qty, da[i].hidden_qty);
+            ASSERT_EQ(db[i].order_count, da[i].order_count);
+        }
+    }
+    for (uint64_t id = 1; id <= max_id; ++id) {
+        auto oa = a.book().findOrder(id), ob = b.book().findOrder(id);
+        ASSERT_EQ(ob.has_value(), oa.has_value());
+        if (!oa) continue;
+        ASSERT_EQ(ob->timestamp(), oa->timestamp());
+        ASSERT_EQ(ob->price(), oa->price());
+        ASSERT_EQ(ob->leaves(), oa->leaves());
+        ASSERT_EQ(ob->visibleQty(), oa->visibleQty());
+        ASSERT_EQ(ob->triggerPrice(), oa->triggerPrice());
+        ASSERT(ob->status() == oa->status() && ob->kind() == oa->kind());
+    }
+}
+
+// Sweeps both engines with the same market orders: fills must hit the same
+// resting orders in the same priority, under the same trade ids.
+static void assertSameSweep(MatchingEngine& a, MatchingEngine& b) {
+    std::vector<Trade> ta, tb;
+    TradeCollector     sa{ta}, sb{tb};
+    for (Side side : {Side::BUY, Side::SELL}) {
+        a.submitMarket(side, 1000000, sa);
+        b.submitMarket(side, 1000000, sb);
+    }
+    ASSERT_EQ(tb.size(), ta.size());
+    for (size_t i = 0; i < ta.size(); ++i) {
+        ASSERT_EQ(tb[i].trade_id, ta[i].trade_id);
+        ASSERT_EQ(tb[i].buy_order_id, ta[i].buy_order_id);
+        ASSERT_EQ(tb[i].sell_order_id, ta[i].sell_order_id);
+        ASSERT_EQ(tb[i].price, ta[i].price);
+        ASSERT_EQ(tb[i].quantity, ta[i].quantity);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot round trip
+// ---------------------------------------------------------------------------
+static void test_snapshot_restores_book_exactly() {
+    fs::path dir = scratchDir("round_trip");
+    std::string path = (dir / "book.snap").string();
+
+    MatchingEngine live(false);
+    NullSink       sink;
+    live.submitLimit(Side::BUY, 990000LL, 100, sink);
+    live.submitIceberg(Side::BUY, 990000LL, 300, 40, sink);
+    live.submitLimit(Side::BUY, 990000LL, 70, sink);
+    live.submitLimit(Side::BUY, 980000LL, 50, sink);
+    live.submitLimit(Side::SELL, 1010000LL, 80, sink);
+    live.submitLimit(Side::SELL, 1020000LL, 90, sink);
+    live.submitStopLoss(Side::SELL, 970000LL, 960000LL, 25, sink);
+    live.submitStopLoss(Side::SELL, 970000LL, 950000LL, 15, sink);
+    live.submitStopLoss(Side::BUY, 1050000LL, 1060000LL, 10, sink);
+    live.submitMarket(Side::SELL, 130, sink);   // fills #1, 30 of the iceberg's lot
+    live.submitMarket(Side::BUY, 30, sink);     // partial on #5
+    ASSERT_EQ(live.book().findOrder(2)->visibleQty(), 10ULL);
+    ASSERT_EQ(live.book().findOrder(2)->hiddenQty(), 260ULL);
+
+    live.saveSnapshot(path);
+    ASSERT_FALSE(fs::exists(path + ".tmp"));
+
+    MatchingEngine restored(false);
+    ASSERT_EQ(restored.restore(path), 0ULL);
+    assertSameBook(live, restored, 11);
+    ASSERT_EQ(restored.book().bestBid(), 990000LL);
+    ASSERT_EQ(restored.book().bestAsk(), 1010000LL);
+
+    // Ids continue where the live engine left off.
+    ASSERT_EQ(restored.submitLimit(Side::SELL, 1030000LL, 5, sink),
+              live.submitLimit(Side::SELL, 1030000LL, 5, sink));
+    assertSameSweep(live, restored);
+    fs::remove_all(dir);
+}
+
+// A stop that has fired and rests as a limit keeps its kind; it must come
+// back resting and fired, not be refused or waiting again.
+static void test_snapshot_restores_triggered_stop_resting() {
+    fs::path dir = scratchDir("triggered");
+    std::string path = (dir / "book.snap").string();
+
+    MatchingEngine live(false);
+    NullSink       sink;
+    live.submitLimit(Side::BUY, 990000LL, 10, sink);
+    uint64_t stop = live.submitStopLoss(Side::SELL, 990000LL, 1000000LL, 20, sink);
+    live.submitMarket(Side::SELL, 10, sink);   // trades at the trigger; the stop rests as an ask
+    ASSERT_EQ(live.book().pendingStops(), 0ULL);
+    ASSERT_TRUE(live.book().findOrder(stop)->isTriggered());
+    ASSERT_EQ(live.book().bestAsk(), 1000000LL);
+
+    live.saveSnapshot(path);
+    MatchingEngine restored(false);
+    ASSERT_EQ(restored.restore(path), 0ULL);
+    assertSameBook(live, restored, stop + 1);
+    auto o = restored.book().findOrder(stop);
+    ASSERT_TRUE(o.has_value());
+    ASSERT_TRUE(o->isStopLoss() && o->isTriggered());
+    ASSERT_EQ(restored.book().bestAsk(), 1000000LL);
+    assertSameSweep(live, restored);
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Restart: snapshot + journal tail == the live engine == full replay
+// ---------------------------------------------------------------------------
+static void test_snapshot_plus_journal_tail_matches_live_engine() {
+    fs::path dir  = scratchDir("restart");
+    std::string path = (dir / "book.snap").string();
+    JournalConfig cfg;
+    cfg.dir             = (dir / "journal").string();
+    cfg.segment_records = 256;
+    fs::create_directories(cfg.dir);
+
+    MatchingEngine live(false, {}, {}, {}, cfg);
+    NullSink       sink;
+    uint64_t       last_id = 0, covered = 0;
+    uint32_t       x = 12345;
+    auto rnd = [&](uint32_t n) { x = x * 1103515245u + 12345u; return (x >> 8) % n; };
+    for (int i = 0; i < 2000; ++i) {
+        if (i == 1200) covered = live.saveSnapshot(path);
+        Side    side  = rnd(2) ? Side::BUY : Side::SELL;
+        int64_t price = 1000000LL + (side == Side::BUY ? -1 : 1) * 100LL * rnd(20)
+                      - (side == Side::BUY ? -1 : 1) * 300LL;
+        switch (rnd(10)) {
+        case 0:  live.submitIceberg(side, price, 50 + rnd(200), 10 + rnd(20), sink); break;
+        case 1:  live.submitStopLoss(side, side == Side::BUY ? 1003000LL : 997000LL,
+                                     price, 1 + rnd(30), sink); break;
+        case 2:  live.submitMarket(side, 1 + rnd(60), sink); break;
+        case 3:  if (last_id) live.cancelOrder(1 + rnd(static_cast<uint32_t>(last_id))); break;
+        case 4:  if (last_id) live.modifyOrder(1 + rnd(static_cast<uint32_t>(last_id)),
+                                                price, rnd(80)); break;
+        default: last_id = live.submitLimit(side, price, 1 + rnd(100), sink); break;
+        }
+    }
+    uint64_t journaled = live.journal()->lastSequence();
+    ASSERT(covered > 0 && covered < journaled);
+
+    MatchingEngine fast(false);
+    ASSERT_EQ(fast.restore(path, cfg.dir), journaled - covered);
+    assertSameBook(live, fast, last_id + 10);
+
+    MatchingEngine full(false);
+    ASSERT_EQ(full.restore("", cfg.dir), journaled);
+    assertSameBook(live, full, last_id + 10);
+
+    ASSERT_EQ(fast.submitLimit(Side::BUY, 900000LL, 1, sink),
+              live.submitLimit(Side::BUY, 900000LL, 1, sink));
+    assertSameSweep(live, fast);
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Damaged snapshots and misuse are refused
+// ---------------------------------------------------------------------------
+static void test_snapshot_rejects_damage_and_reuse() {
+    fs::path dir = scratchDir("damage");
+    std::string path = (dir / "book.snap").string();
+    {
+        MatchingEngine live(false);
+        for (int i = 0; i < 10; ++i) live.submitLimit(Side::BUY, 990000LL - i * 100, 10 + i);
+        live.saveSnapshot(path);
+    }
+    auto refused = [](const std::string& p, int err) {
+        MatchingEngine engine(false);
+        try { engine.restore(p); } catch (const std::system_error& e) { return e.code().value() == err; }
+        return false;
+    };
+
+    std::string flipped = (dir / "flipped.snap").string();
+    fs::copy_file(path, flipped);
+    {
+        std::fstream f(flipped, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(sizeof(SnapshotHeader) + 3 * sizeof(SnapshotRecord) + 32);   // #4's leaves
+        f.put('\x01');
+    }
+    ASSERT_TRUE(refused(flipped, EINVAL));
+
+    // The header's counters are covered too, and counts that would wrap
+    // when added are refused before any record is read.
+    auto patchHeader = [&](const char* name, size_t offset, uint64_t value) {
+        std::string p = (dir / name).string();
+        fs::copy_file(path, p);
+        std::fstream f(p, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(offset));
+        f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        return p;
+    };
+    ASSERT_TRUE(refused(patchHeader("next_id.snap", offsetof(SnapshotHeader, next_order_id), 1000),
+                        EINVAL));
+    std::string wrapped = patchHeader("wrapped.snap", offsetof(SnapshotHeader, resting_orders),
+                                      UINT64_MAX - 5);
+    {
+        std::fstream f(wrapped, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t stops = 16;   // UINT64_MAX - 5 + 16 wraps to the true count, 10
+        f.seekp(offsetof(SnapshotHeader, pending_stops));
+        f.write(reinterpret_cast<const char*>(&stops), sizeof(stops));
+    }
+    ASSERT_TRUE(refused(wrapped, EINVAL));
+
+    std::string cut = (dir / "cut.snap").string();
+    fs::copy_file(path, cut);
+    fs::resize_file(cut, fs::file_size(cut) - 40);
+    ASSERT_TRUE(refused(cut, EINVAL));
+    ASSERT_TRUE(refused((dir / "missing.snap").string(), ENOENT));
+
+    MatchingEngine used(false);
+    used.submitLimit(Side::SELL, 1010000LL, 5);
+    bool busy = false;
+    try { used.restore(path); } catch (const std::system_error& e) { busy = e.code().value() == EBUSY; }
+    ASSERT_TRUE(busy);
+    fs::remove_all(dir);
+}
+
+void run_snapshot_tests() {
+    RUN_TEST(test_snapshot_restores_book_exactly);
+    RUN_TEST(test_snapshot_restores_triggered_stop_resting);
+    RUN_TEST(test_snapshot_plus_journal_tail_matches_live_engine);
+    RUN_TEST(test_snapshot_rejects_damage_and_reuse);
+}
@@ -0,0 +1,49 @@
+#include "framework.h"
+#include "thread_placement.h"
+
+#include <thread>
+
+// ---------------------------------------------------------------------------
+// pinned(): matching, publisher, then producers on consecutive cores,
+// wrapping at the online core count
+// ---------------------------------------------------------------------------
+static void test_pinned_layout() {
+    int             cores = static_cast<int>(onlineCores());
+    ThreadPlacement p     = ThreadPlacement::pinned(3, 1);
+    ASSERT_EQ(p.matching_core, 1 % cores);
+    ASSERT_EQ(p.publisher_core, 2 % cores);
+    ASSERT_EQ(p.producer_cores.size(), size_t{3});
+    ASSERT_EQ(p.producerCore(0), 3 % cores);
+    ASSERT_EQ(p.producerCore(2), 5 % cores);
+    ASSERT_EQ(p.producerCore(3), p.producerCore(0));   // round-robin
+
+    ThreadPlacement none;
+    ASSERT_EQ(none.producerCore(7), -1);
+}
+
+// ---------------------------------------------------------------------------
+// A thread pinned to a core runs there; invalid cores are refused
+// ---------------------------------------------------------------------------
+static void test_pin_current_thread() {
+    int  last = static_cast<int>(onlineCores()) - 1;
+    bool pinned = false;
+    int  core   = -2;
+    std::thread t([&] {
+        pinned = pinCurrentThread(last);
+        core   = currentCore();
+    });
+    t.join();
+#ifdef __linux__
+    ASSERT(pinned);
+    ASSERT_EQ(core, last);
+    ASSERT(currentNumaNode() >= 0);
+#endif
+    ASSERT_FALSE(pinCurrentThread(-1));
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_thread_placement_tests() {
+    RUN_TEST(test_pinned_layout);
+    RUN_TEST(test_pin_current_thread);
+}
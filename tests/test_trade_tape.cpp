@@ -0,0 +1,134 @@
+#include "framework.h"
+#include "orderbook.h"
+#include "trade_tape.h"
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static Trade makeTrade(uint64_t id) {
+    return Trade{id, id * 10, id * 10 + 1, 1000000LL + static_cast<int64_t>(id),
+                 id, static_cast<int64_t>(id) * 100};
+}
+
+// Fresh, empty scratch directory for one test's segment files.
+static fs::path scratchDir(const char* name) {
+    fs::path dir = fs::temp_directory_path() / (std::string("lob_tape_") + name);
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+static size_t fileCount(const fs::path& dir) {
+    size_t n = 0;
+    for (auto it = fs::directory_iterator(dir); it != fs::directory_iterator(); ++it) ++n;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Ring only: oldest trades age out
+// ---------------------------------------------------------------------------
+static void test_tape_ring_keeps_most_recent() {
+    TapeConfig cfg;
+    cfg.ring_capacity = 4;
+    TradeTape tape(cfg);
+    for (uint64_t id = 1; id <= 10; ++id) tape.append(makeTrade(id));
+
+    ASSERT_EQ(tape.totalAppended(), 10ULL);
+    ASSERT_EQ(tape.size(), 4ULL);
+    ASSERT_EQ(tape.dropped(), 6ULL);
+    ASSERT_FALSE(tape.spilling());
+
+    std::vector<uint64_t> ids;
+    for (const Trade& t : tape) ids.push_back(t.trade_id);
+    ASSERT(ids == (std::vector<uint64_t>{7, 8, 9, 10}));
+
+    Trade last = tape.back();
+    ASSERT_EQ(last.buy_order_id, 100ULL);
+    ASSERT_EQ(last.sell_order_id, 101ULL);
+    ASSERT_EQ(last.price, 1000010LL);
+    ASSERT_EQ(last.timestamp_ns, 1000LL);
+}
+
+// ---------------------------------------------------------------------------
+// Spill: evicted trades land in segment files and read back in order
+// ---------------------------------------------------------------------------
+static void test_tape_spills_and_reads_back() {
+    fs::path dir = scratchDir("spill");
+    {
+        TapeConfig cfg;
+        cfg.ring_capacity   = 4;
+        cfg.spill_dir       = dir.string();
+        cfg.segment_records = 8;
+        cfg.max_segments    = 16;
+        TradeTape tape(cfg);
+        for (uint64_t id = 1; id <= 30; ++id) tape.append(makeTrade(id));
+
+        // 26 spilled across segments 0..3, 4 in the ring
+        ASSERT_EQ(tape.size(), 30ULL);
+        ASSERT_EQ(tape.segmentCount(), 4ULL);
+
+        uint64_t expect = 1;
+        for (const Trade& t : tape) {
+            ASSERT_EQ(t.trade_id, expect);
+            ASSERT_EQ(t.quantity, expect);
+            ++expect;
+        }
+        ASSERT_EQ(expect, 31ULL);
+        ASSERT_EQ(tape.at(3).sell_order_id, 41ULL);   // sequence 3 = trade #4
+    }
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// Rotation: only max_segments files are kept
+// ---------------------------------------------------------------------------
+static void test_tape_rotation_drops_oldest_segment() {
+    fs::path dir = scratchDir("rotate");
+    {
+        TapeConfig cfg;
+        cfg.ring_capacity   = 2;
+        cfg.spill_dir       = dir.string();
+        cfg.segment_records = 4;
+        cfg.max_segments    = 2;
+        TradeTape tape(cfg);
+        for (uint64_t id = 1; id <= 20; ++id) tape.append(makeTrade(id));
+
+        // 18 spilled → segments 0..4; only 3 and 4 survive
+        ASSERT_EQ(tape.segmentCount(), 2ULL);
+        ASSERT_EQ(fileCount(dir), 2ULL);
+        ASSERT_EQ(tape.firstSeq(), 12ULL);
+        ASSERT_EQ(tape.size(), 8ULL);
+        ASSERT_EQ((*tape.begin()).trade_id, 13ULL);
+    }
+    fs::remove_all(dir);
+}
+
+// ---------------------------------------------------------------------------
+// OrderBook history is a view over its tape
+// ---------------------------------------------------------------------------
+static void test_book_history_is_bounded() {
+    TapeConfig cfg;
+    cfg.ring_capacity = 2;
+    OrderBook book(LadderConfig{}, PoolConfig{}, cfg);
+    for (uint64_t i = 0; i < 5; ++i) {
+        book.match(book.newOrder(2 * i + 1, 0LL, Side::BUY, OrderKind::LIMIT, 1000000LL, 10ULL));
+        book.match(book.newOrder(2 * i + 2, 0LL, Side::SELL, OrderKind::LIMIT, 1000000LL, 10ULL));
+    }
+    const TradeTape& history = book.tradeHistory();
+    ASSERT_EQ(history.totalAppended(), 5ULL);
+    ASSERT_EQ(history.size(), 2ULL);
+    ASSERT_EQ(history.back().trade_id, 5ULL);
+    ASSERT_EQ(history.back().sell_order_id, 10ULL);
+}
+
+// ─── runner ───────────────────────────────────────────────────────────────────
+
+void run_trade_tape_tests() {
+    RUN_TEST(test_tape_ring_keeps_most_recent);
+    RUN_TEST(test_tape_spills_and_reads_back);
+    RUN_TEST(test_tape_rotation_drops_oldest_segment);
+    RUN_TEST(test_book_history_is_bounded);
+}